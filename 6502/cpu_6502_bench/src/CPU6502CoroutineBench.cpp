@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include "main_6502.h"
+#include "coroutine_6502.h"
+#include "workloads_6502.h"
+
+// Interleaving the CPU with another component that needs to run every
+// Period cycles:
+//   Interleave/Execute   a host without a scheduler calls Execute with a
+//                        small fixed budget (QUANTUM, the finest timing any
+//                        of its components needs) and checks what is due
+//   Interleave/RunSlice  the host's own RunSlice / RunDue loop over
+//                        Scheduler events
+//   Interleave/Coroutine a RunCoroutine generator stopping at the same events
+// Coroutine against RunSlice is what a resume costs over a plain call,
+// against Execute what stopping only when something is due saves.
+// Counters as in Workloads/:
+//   MHz     emulated cycles per host second / 1e6
+//   resumes host regains control this many times per run
+
+using namespace cpu6502;
+
+namespace
+{
+    const Workload &Program()
+    {
+        for (const Workload &Candidate : Workloads())
+        {
+            if (std::string(Candidate.Name) == "RecursiveFib")
+                return Candidate;
+        }
+        return Workloads().front();
+    }
+
+    void Report(benchmark::State &State, u64 Cycles, u64 Resumes)
+    {
+        State.counters["MHz"] = benchmark::Counter(double(Cycles) / 1e6, benchmark::Counter::kIsRate);
+        State.counters["resumes"] = double(Resumes) / double(State.iterations());
+    }
+
+    constexpr s32 QUANTUM = 64;
+
+    void BM_InterleaveExecute(benchmark::State &State)
+    {
+        const u64 Period = static_cast<u64>(State.range(0));
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        u64 Cycles = 0, Resumes = 0, Ticks = 0;
+        for (auto _ : State)
+        {
+            State.PauseTiming();
+            Program().Load(cpu, *memory);
+            const u64 Until = Program().ExpectedCycles;
+            u64 NextTick = Period;
+            State.ResumeTiming();
+            while (cpu.CycleCount < Until)
+            {
+                cpu.Execute(QUANTUM, *memory);
+                Resumes++;
+                for (; NextTick <= cpu.CycleCount; NextTick += Period)
+                    Ticks++;
+            }
+            Cycles += cpu.CycleCount;
+        }
+        benchmark::DoNotOptimize(Ticks);
+        Report(State, Cycles, Resumes);
+    }
+
+    void BM_InterleaveRunSlice(benchmark::State &State)
+    {
+        const u64 Period = static_cast<u64>(State.range(0));
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        Scheduler events;
+        u64 Cycles = 0, Resumes = 0, Ticks = 0;
+        std::function<void(u64)> Tick = [&](u64 Due) {
+            Ticks++;
+            events.Schedule(Due + Period, Tick);
+        };
+        for (auto _ : State)
+        {
+            State.PauseTiming();
+            Program().Load(cpu, *memory);
+            events.Clear();
+            events.Schedule(Period, Tick);
+            const u64 Until = Program().ExpectedCycles;
+            State.ResumeTiming();
+            while (cpu.CycleCount < Until)
+            {
+                events.RunSlice(cpu, *memory, Until);
+                events.RunDue(cpu.CycleCount);
+                Resumes++;
+            }
+            Cycles += cpu.CycleCount;
+        }
+        benchmark::DoNotOptimize(Ticks);
+        Report(State, Cycles, Resumes);
+    }
+
+    void BM_InterleaveCoroutine(benchmark::State &State)
+    {
+        const u64 Period = static_cast<u64>(State.range(0));
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        Scheduler events;
+        u64 Cycles = 0, Resumes = 0, Ticks = 0;
+        std::function<void(u64)> Tick = [&](u64 Due) {
+            Ticks++;
+            events.Schedule(Due + Period, Tick);
+        };
+        for (auto _ : State)
+        {
+            State.PauseTiming();
+            Program().Load(cpu, *memory);
+            events.Clear();
+            events.Schedule(Period, Tick);
+            CPURun Run = RunCoroutine(cpu, *memory, events, Program().ExpectedCycles);
+            State.ResumeTiming();
+            while (Run.Next())
+            {
+                Resumes++;
+            }
+            Cycles += cpu.CycleCount;
+        }
+        benchmark::DoNotOptimize(Ticks);
+        Report(State, Cycles, Resumes);
+    }
+}
+
+BENCHMARK(BM_InterleaveExecute)->Name("Interleave/Execute")->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_InterleaveRunSlice)->Name("Interleave/RunSlice")->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_InterleaveCoroutine)->Name("Interleave/Coroutine")->Arg(64)->Arg(1024)->Arg(16384);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "main_6502.h"
+
+// Decimal mode ADC / SBC: the 64K-per-carry lookup tables the CPU uses
+// against the digit-by-digit code they are generated from. Every step
+// feeds its result into the next one so neither side can be hoisted.
+// The end to end cost through Execute is Arithmetic/ADC_IM/Decimal.
+
+using namespace cpu6502;
+
+namespace
+{
+    constexpr u32 STEPS = 1024;
+
+    template <typename Operation>
+    void RunDecimal(benchmark::State &State, Operation Apply)
+    {
+        Word Result = 0x0000;
+        Byte Operand = 0x27;
+        for (auto _ : State)
+        {
+            for (u32 i = 0; i < STEPS; i++)
+            {
+                Result = Apply(Byte(Result), Operand, Byte((Result >> 8) & 1));
+                Operand = static_cast<Byte>(Operand * 5 + 1);
+            }
+            benchmark::DoNotOptimize(Result);
+        }
+        State.counters["ops"] = benchmark::Counter(double(State.iterations()) * STEPS, benchmark::Counter::kIsRate);
+    }
+
+    void BM_DecimalAddTable(benchmark::State &State)
+    {
+        const DecimalTables &Tables = DecimalTables::Get();
+        RunDecimal(State, [&Tables](Byte A, Byte Operand, Byte Carry) {
+            return Tables.Add[DecimalTables::Index(A, Operand, Carry)];
+        });
+    }
+
+    void BM_DecimalAddBranchy(benchmark::State &State)
+    {
+        RunDecimal(State, DecimalTables::AddBranchy);
+    }
+
+    void BM_DecimalSubtractTable(benchmark::State &State)
+    {
+        const DecimalTables &Tables = DecimalTables::Get();
+        RunDecimal(State, [&Tables](Byte A, Byte Operand, Byte Carry) {
+            return Tables.Subtract[DecimalTables::Index(A, Operand, Carry)];
+        });
+    }
+
+    void BM_DecimalSubtractBranchy(benchmark::State &State)
+    {
+        RunDecimal(State, DecimalTables::SubtractBranchy);
+    }
+}
+
+BENCHMARK(BM_DecimalAddTable)->Name("Decimal/ADC/Table");
+BENCHMARK(BM_DecimalAddBranchy)->Name("Decimal/ADC/Branchy");
+BENCHMARK(BM_DecimalSubtractTable)->Name("Decimal/SBC/Table");
+BENCHMARK(BM_DecimalSubtractBranchy)->Name("Decimal/SBC/Branchy");
@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include "main_6502.h"
+#include "diff_6502.h"
+
+// Comparing two 64K memories that differ in a handful of bytes, either
+// every page or only the four pages written since a checkpoint.
+// Reported counters:
+//   compares  DiffMemory calls per host second
+
+using namespace cpu6502;
+
+namespace
+{
+    void BM_Diff(benchmark::State &State, bool DirtyOnly)
+    {
+        auto A = std::make_unique<Mem>();
+        auto B = std::make_unique<Mem>();
+        A->Init();
+        B->Init();
+        const u32 SinceA = A->Checkpoint();
+        const u32 SinceB = B->Checkpoint();
+        const Byte Data[] = {1, 2, 3};
+        for (Word Address : {0x0010, 0x01F0, 0x2000, 0xC123})
+        {
+            B->WriteBlock(Address, Data, sizeof(Data));
+        }
+        for (auto _ : State)
+        {
+            std::vector<MemRange> Ranges = DirtyOnly ? DiffMemory(*A, *B, SinceA, SinceB) : DiffMemory(*A, *B);
+            if (Ranges.size() != 4)
+            {
+                State.SkipWithError("wrong number of ranges");
+                return;
+            }
+            benchmark::DoNotOptimize(Ranges.data());
+        }
+        State.counters["compares"] = benchmark::Counter(double(State.iterations()), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_Diff, Full, false)->Name("Diff/Full");
+BENCHMARK_CAPTURE(BM_Diff, Dirty, true)->Name("Diff/Dirty");
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include "main_6502.h"
+#include "fork_6502.h"
+
+// Fork: copying a Machine whose 64K are all in use.
+// ForkAndRun: fork, load into a runner that last held a sibling, poke an
+// input, run 100 cycles and store back - one step of a tree search.
+// Reported counters:
+//   forks  per host second
+
+using namespace cpu6502;
+
+namespace
+{
+    std::unique_ptr<Mem> FullMemory(CPU &cpu)
+    {
+        auto memory = std::make_unique<Mem>();
+        cpu.Reset(*memory, 0x0200);
+        memory->Fill(0x0000, 0xEA, Mem::MAX_MEM); // NOPs everywhere
+        return memory;
+    }
+
+    void BM_Fork(benchmark::State &State)
+    {
+        CPU cpu;
+        auto memory = FullMemory(cpu);
+        Machine Parent = Machine::Capture(cpu, *memory);
+        for (auto _ : State)
+        {
+            Machine Child = Parent.Fork();
+            benchmark::DoNotOptimize(Child.Pages);
+        }
+        State.counters["forks"] = benchmark::Counter(double(State.iterations()), benchmark::Counter::kIsRate);
+    }
+
+    void BM_ForkAndRun(benchmark::State &State)
+    {
+        CPU cpu;
+        auto memory = FullMemory(cpu);
+        Machine Parent = Machine::Capture(cpu, *memory);
+        auto Runner = std::make_unique<ForkRunner>();
+        Byte Input = 0;
+        for (auto _ : State)
+        {
+            Machine Child = Parent.Fork();
+            Runner->Load(Child);
+            Runner->memory.Fill(0x0300, Input++, 1);
+            Child.cpu.Execute(100, Runner->memory);
+            Runner->Store(Child);
+            benchmark::DoNotOptimize(Child.Pages);
+        }
+        State.counters["forks"] = benchmark::Counter(double(State.iterations()), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(BM_Fork)->Name("Fork/Copy");
+BENCHMARK(BM_ForkAndRun)->Name("Fork/ForkAndRun");
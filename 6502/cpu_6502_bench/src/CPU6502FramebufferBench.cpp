@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+#include "main_6502.h"
+#include "framebuffer_6502.h"
+
+// Cost of one vertical blank on a 256x240 framebuffer (960 tiles) with a
+// given number of tiles changed since the last frame, host draining every
+// frame. Reported counters:
+//   frames  vertical blanks per host second
+
+using namespace cpu6502;
+
+namespace
+{
+    constexpr u32 FRAME_CYCLES = 29781;
+
+    void BM_FramebufferVBlank(benchmark::State &State)
+    {
+        const u32 DirtyTiles = static_cast<u32>(State.range(0));
+        Scheduler Events;
+        Framebuffer Screen{Events, 0x0000, 256, 240, FRAME_CYCLES};
+        Framebuffer::Frame Image;
+        u64 Cycle = 0;
+        Byte Colour = 0;
+        for (auto _ : State)
+        {
+            Colour++;
+            for (u32 Tile = 0; Tile < DirtyTiles; Tile++)
+            {
+                Screen.Write(static_cast<Word>((Tile / 32) * 8 * 256 + (Tile % 32) * 8), Colour, Cycle);
+            }
+            Cycle += FRAME_CYCLES;
+            Events.RunDue(Cycle);
+            Screen.NextFrame(Image);
+            benchmark::DoNotOptimize(Image.Hash);
+        }
+        State.counters["frames"] = benchmark::Counter(double(State.iterations()), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(BM_FramebufferVBlank)->Name("Framebuffer/VBlank")->Arg(0)->Arg(16)->Arg(960);
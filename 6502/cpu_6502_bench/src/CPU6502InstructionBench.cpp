@@ -0,0 +1,208 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "main_6502.h"
+
+// Per instruction group / addressing mode microbenchmarks. Every case
+// builds a straight-line block of UNITS copies of one instruction (or a
+// push/pull style pair) followed by a JMP back to the start, then runs
+// whole loops through Execute. Reported counters:
+//   MIPS          emulated instructions per host second / 1e6
+//   time/instr    host seconds per emulated instruction (shown as ns)
+//   cycles/instr  emulated cycles per instruction (sanity check of the case)
+
+using namespace cpu6502;
+
+namespace
+{
+    constexpr Word CODE_START = 0x0200;
+    constexpr u32 UNITS = 64;
+    constexpr u32 LOOPS_PER_EXECUTE = 64;
+
+    struct Program
+    {
+        std::vector<Byte> Code;
+
+        Word Here() const { return static_cast<Word>(CODE_START + Code.size()); }
+
+        void Emit(std::initializer_list<Byte> Bytes) { Code.insert(Code.end(), Bytes); }
+
+        void EmitAbs(Byte Opcode, Word Address) { Emit({Opcode, Byte(Address & 0xFF), Byte(Address >> 8)}); }
+    };
+
+    struct BenchCase
+    {
+        const char *Name;
+        // Emits one unit at p.Here()
+        void (*Unit)(Program &p);
+        // Registers and data the unit relies on
+        void (*Setup)(CPU &cpu, Mem &memory);
+        u32 InstructionsPerUnit;
+    };
+
+    void NoSetup(CPU &, Mem &) {}
+
+    void IndexSetup(CPU &cpu, Mem &memory)
+    {
+        cpu.X = 0x10;
+        cpu.Y = 0x10;
+        // ($20) -> $3000, ($30),Y with Y = $10 stays on the page
+        memory[0x0020] = 0x00;
+        memory[0x0021] = 0x30;
+        memory[0x0030] = 0x00;
+        memory[0x0031] = 0x30;
+    }
+
+    void PageCrossSetup(CPU &cpu, Mem &memory)
+    {
+        cpu.X = 0x20;
+        cpu.Y = 0x20;
+        // ($30),Y = $30F0 + $20 crosses into $3100
+        memory[0x0030] = 0xF0;
+        memory[0x0031] = 0x30;
+    }
+
+    const BenchCase Cases[] = {
+        // Loads
+        {"Loads/LDA_IM", [](Program &p) { p.Emit({CPU::INS_LDA_IM, 0x42}); }, NoSetup, 1},
+        {"Loads/LDA_ZEROP", [](Program &p) { p.Emit({CPU::INS_LDA_ZEROP, 0x40}); }, NoSetup, 1},
+        {"Loads/LDA_ZEROP_X", [](Program &p) { p.Emit({CPU::INS_LDA_ZEROP_X, 0x40}); }, IndexSetup, 1},
+        {"Loads/LDX_ZEROP_Y", [](Program &p) { p.Emit({CPU::INS_LDX_ZEROP_Y, 0x40}); }, IndexSetup, 1},
+        {"Loads/LDA_ABS", [](Program &p) { p.EmitAbs(CPU::INS_LDA_ABS, 0x3000); }, NoSetup, 1},
+        {"Loads/LDA_ABS_X", [](Program &p) { p.EmitAbs(CPU::INS_LDA_ABS_X, 0x3000); }, IndexSetup, 1},
+        {"Loads/LDA_ABS_X/PageCross", [](Program &p) { p.EmitAbs(CPU::INS_LDA_ABS_X, 0x30F0); }, PageCrossSetup, 1},
+        {"Loads/LDA_ABS_Y", [](Program &p) { p.EmitAbs(CPU::INS_LDA_ABS_Y, 0x3000); }, IndexSetup, 1},
+        {"Loads/LDA_ABS_Y/PageCross", [](Program &p) { p.EmitAbs(CPU::INS_LDA_ABS_Y, 0x30F0); }, PageCrossSetup, 1},
+        {"Loads/LDA_IND_X", [](Program &p) { p.Emit({CPU::INS_LDA_IND_X, 0x10}); }, IndexSetup, 1},
+        {"Loads/LDA_IND_Y", [](Program &p) { p.Emit({CPU::INS_LDA_IND_Y, 0x30}); }, IndexSetup, 1},
+        {"Loads/LDA_IND_Y/PageCross", [](Program &p) { p.Emit({CPU::INS_LDA_IND_Y, 0x30}); }, PageCrossSetup, 1},
+
+        // Stores
+        {"Stores/STA_ZEROP", [](Program &p) { p.Emit({CPU::INS_STA_ZEROP, 0x40}); }, NoSetup, 1},
+        {"Stores/STA_ZEROP_X", [](Program &p) { p.Emit({CPU::INS_STA_ZEROP_X, 0x40}); }, IndexSetup, 1},
+        {"Stores/STX_ZEROP_Y", [](Program &p) { p.Emit({CPU::INS_STX_ZEROP_Y, 0x40}); }, IndexSetup, 1},
+        {"Stores/STA_ABS", [](Program &p) { p.EmitAbs(CPU::INS_STA_ABS, 0x3000); }, NoSetup, 1},
+        {"Stores/STA_ABS_X", [](Program &p) { p.EmitAbs(CPU::INS_STA_ABS_X, 0x3000); }, IndexSetup, 1},
+        {"Stores/STA_ABS_Y/PageCross", [](Program &p) { p.EmitAbs(CPU::INS_STA_ABS_Y, 0x30F0); }, PageCrossSetup, 1},
+        {"Stores/STA_IND_X", [](Program &p) { p.Emit({CPU::INS_STA_IND_X, 0x10}); }, IndexSetup, 1},
+        {"Stores/STA_IND_Y", [](Program &p) { p.Emit({CPU::INS_STA_IND_Y, 0x30}); }, IndexSetup, 1},
+
+        // Logical operations
+        {"Logic/AND_IM", [](Program &p) { p.Emit({CPU::INS_AND_IM, 0x7F}); }, NoSetup, 1},
+        {"Logic/EOR_ZERO_P", [](Program &p) { p.Emit({CPU::INS_EOR_ZERO_P, 0x40}); }, NoSetup, 1},
+        {"Logic/ORA_ABS", [](Program &p) { p.EmitAbs(CPU::INS_ORA_ABS, 0x3000); }, NoSetup, 1},
+        {"Logic/AND_ABS_X/PageCross", [](Program &p) { p.EmitAbs(CPU::INS_AND_ABS_X, 0x30F0); }, PageCrossSetup, 1},
+        {"Logic/EOR_IND_Y", [](Program &p) { p.Emit({CPU::INS_EOR_IND_Y, 0x30}); }, IndexSetup, 1},
+        {"Logic/BIT_ABS", [](Program &p) { p.EmitAbs(CPU::INS_BIT_ABS, 0x3000); }, NoSetup, 1},
+
+        // Arithmetic
+        {"Arithmetic/ADC_IM", [](Program &p) { p.Emit({CPU::INS_ADC_IM, 0x01}); }, NoSetup, 1},
+        {"Arithmetic/SBC_ZERO_P", [](Program &p) { p.Emit({CPU::INS_SBC_ZERO_P, 0x40}); }, NoSetup, 1},
+        {"Arithmetic/ADC_IM/Decimal",
+         [](Program &p) { p.Emit({CPU::INS_ADC_IM, 0x01}); },
+         [](CPU &cpu, Mem &) { cpu.flags.D = 1; }, 1},
+        {"Arithmetic/CMP_ABS_X", [](Program &p) { p.EmitAbs(CPU::INS_CMP_ABS_X, 0x3000); }, IndexSetup, 1},
+
+        // Shifts
+        {"Shifts/ASL", [](Program &p) { p.Emit({CPU::INS_ASL}); }, NoSetup, 1},
+        {"Shifts/ROL_ZERO_P", [](Program &p) { p.Emit({CPU::INS_ROL_ZERO_P, 0x40}); }, NoSetup, 1},
+        {"Shifts/LSR_ABS_X", [](Program &p) { p.EmitAbs(CPU::INS_LSR_ABS_X, 0x3000); }, IndexSetup, 1},
+
+        // Branches - Z is clear after Reset, taken ones land on the next instruction
+        {"Branches/BEQ/NotTaken", [](Program &p) { p.Emit({CPU::INS_BEQ, 0x00}); }, NoSetup, 1},
+        {"Branches/BNE/Taken", [](Program &p) { p.Emit({CPU::INS_BNE, 0x00}); }, NoSetup, 1},
+
+        // Register transfers
+        {"Transfers/TAX", [](Program &p) { p.Emit({CPU::INS_TAX}); }, NoSetup, 1},
+        {"Transfers/TYA", [](Program &p) { p.Emit({CPU::INS_TYA}); }, NoSetup, 1},
+
+        // Stack operations
+        {"Stack/PHA_PLA", [](Program &p) { p.Emit({CPU::INS_PHA, CPU::INS_PLA}); }, NoSetup, 2},
+        {"Stack/PHP_PLP", [](Program &p) { p.Emit({CPU::INS_PHP, CPU::INS_PLP}); }, NoSetup, 2},
+        {"Stack/TSX_TXS", [](Program &p) { p.Emit({CPU::INS_TSX, CPU::INS_TXS}); }, NoSetup, 2},
+
+        // Increments & decrements
+        {"IncDec/INX", [](Program &p) { p.Emit({CPU::INS_INX}); }, NoSetup, 1},
+        {"IncDec/DEY", [](Program &p) { p.Emit({CPU::INS_DEY}); }, NoSetup, 1},
+        {"IncDec/INC_ZERO_P", [](Program &p) { p.Emit({CPU::INS_INC_ZERO_P, 0x40}); }, NoSetup, 1},
+        {"IncDec/DEC_ZERO_PX", [](Program &p) { p.Emit({CPU::INS_DEC_ZERO_PX, 0x40}); }, IndexSetup, 1},
+        {"IncDec/INC_ABS", [](Program &p) { p.EmitAbs(CPU::INS_INC_ABS, 0x3000); }, NoSetup, 1},
+        {"IncDec/DEC_ABS_X", [](Program &p) { p.EmitAbs(CPU::INS_DEC_ABS_X, 0x3000); }, IndexSetup, 1},
+
+        // Jumps & calls
+        {"Jumps/JMP_ABS", [](Program &p) { p.EmitAbs(CPU::INS_JMP_ABS, p.Here() + 3); }, NoSetup, 1},
+        {"Jumps/JMP_IND",
+         [](Program &p) {
+             // every unit jumps through its own vector stored right after it
+             Word Vector = p.Here() + 3;
+             p.EmitAbs(CPU::INS_JMP_IND, Vector);
+             Word Next = p.Here() + 2;
+             p.Emit({Byte(Next & 0xFF), Byte(Next >> 8)});
+         },
+         NoSetup, 1},
+        {"Jumps/JSR_RTS",
+         [](Program &p) {
+             // JSR to an RTS placed right behind it, then jump over it
+             Word Subroutine = p.Here() + 6;
+             p.EmitAbs(CPU::INS_JSR, Subroutine);
+             p.EmitAbs(CPU::INS_JMP_ABS, Subroutine + 1);
+             p.Emit({CPU::INS_RTS});
+         },
+         NoSetup, 3},
+    };
+
+    void RunCase(benchmark::State &State, const BenchCase &Case)
+    {
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        cpu.Reset(*memory, CODE_START);
+        Case.Setup(cpu, *memory);
+
+        Program p;
+        for (u32 i = 0; i < UNITS; i++)
+        {
+            Case.Unit(p);
+        }
+        p.EmitAbs(CPU::INS_JMP_ABS, CODE_START);
+        for (size_t i = 0; i < p.Code.size(); i++)
+        {
+            (*memory)[CODE_START + i] = p.Code[i];
+        }
+
+        // Measure one loop an instruction at a time so the budget used below
+        // ends exactly on a loop boundary
+        const u32 InstructionsPerLoop = UNITS * Case.InstructionsPerUnit + 1;
+        s32 CyclesPerLoop = 0;
+        for (u32 i = 0; i < InstructionsPerLoop; i++)
+        {
+            CyclesPerLoop += cpu.Execute(1, *memory).Cycles;
+        }
+        if (cpu.PC != CODE_START)
+        {
+            State.SkipWithError("benchmark case did not loop back to its start");
+            return;
+        }
+
+        const s32 Budget = CyclesPerLoop * LOOPS_PER_EXECUTE;
+        u64 Cycles = 0;
+        for (auto _ : State)
+        {
+            Cycles += cpu.Execute(Budget, *memory).Cycles;
+        }
+
+        const double Instructions = double(State.iterations()) * LOOPS_PER_EXECUTE * InstructionsPerLoop;
+        State.counters["MIPS"] = benchmark::Counter(Instructions / 1e6, benchmark::Counter::kIsRate);
+        State.counters["time/instr"] = benchmark::Counter(Instructions, benchmark::Counter::kIsRate |
+                                                                            benchmark::Counter::kInvert);
+        State.counters["cycles/instr"] = double(Cycles) / Instructions;
+    }
+
+    const bool Registered = [] {
+        for (const BenchCase &Case : Cases)
+        {
+            benchmark::RegisterBenchmark(Case.Name, RunCase, Case);
+        }
+        return true;
+    }();
+}
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include "main_6502.h"
+#include "loader_6502.h"
+
+// Parsing and copying a 32KB program image already in memory, so the file
+// system is out of the picture. Reported counters:
+//   bytes   image payload bytes per host second
+
+using namespace cpu6502;
+
+namespace
+{
+    constexpr u32 IMAGE_SIZE = 32 * 1024;
+
+    std::string IntelHexImage()
+    {
+        std::string Text;
+        char Line[64];
+        for (u32 Address = 0x8000; Address < 0x8000 + IMAGE_SIZE; Address += 32)
+        {
+            Byte Sum = static_cast<Byte>(32 + (Address >> 8) + (Address & 0xFF));
+            int Length = snprintf(Line, sizeof(Line), ":20%04X00", Address);
+            Text.append(Line, Length);
+            for (u32 i = 0; i < 32; i++)
+            {
+                Byte Value = static_cast<Byte>(Address + i * 7);
+                Sum += Value;
+                Length = snprintf(Line, sizeof(Line), "%02X", Value);
+                Text.append(Line, Length);
+            }
+            Length = snprintf(Line, sizeof(Line), "%02X\n", Byte(-Sum));
+            Text.append(Line, Length);
+        }
+        return Text + ":00000001FF\n";
+    }
+
+    void BM_LoadImage(benchmark::State &State, ImageFormat Format)
+    {
+        std::string Text;
+        if (Format == ImageFormat::IntelHex)
+            Text = IntelHexImage();
+        else
+            Text.assign(IMAGE_SIZE + 2, '\x00');
+        auto memory = std::make_unique<Mem>();
+        for (auto _ : State)
+        {
+            ProgramImage Image;
+            if (!Image.Parse(reinterpret_cast<const Byte *>(Text.data()), Text.size(), Format))
+            {
+                State.SkipWithError("image did not parse");
+                return;
+            }
+            Image.CopyTo(*memory);
+            benchmark::DoNotOptimize(memory->Data);
+        }
+        State.counters["bytes"] = benchmark::Counter(double(State.iterations()) * IMAGE_SIZE, benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_LoadImage, Prg, ImageFormat::Prg)->Name("Loader/Prg");
+BENCHMARK_CAPTURE(BM_LoadImage, IntelHex, ImageFormat::IntelHex)->Name("Loader/IntelHex");
@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include "main_6502.h"
+#include "statehash_6502.h"
+
+// Cost of a machine state hash after the guest wrote Arg pages (256 is
+// the whole address space, the same as hashing from scratch).
+// Reported counters:
+//   hashes  state hashes per host second
+
+using namespace cpu6502;
+
+namespace
+{
+    void BM_StateHash(benchmark::State &State)
+    {
+        const u32 DirtyPages = static_cast<u32>(State.range(0));
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        cpu.Reset(*memory, 0x0200);
+        StateHasher Hasher(*memory);
+        Byte Value = 0;
+        for (auto _ : State)
+        {
+            Value++;
+            for (u32 Page = 0; Page < DirtyPages; Page++)
+            {
+                memory->Fill(static_cast<Word>(Page * 256), Value, 1);
+            }
+            benchmark::DoNotOptimize(Hasher.Hash(cpu));
+        }
+        State.counters["hashes"] = benchmark::Counter(double(State.iterations()), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(BM_StateHash)->Name("StateHash")->Arg(1)->Arg(8)->Arg(256);
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "main_6502.h"
+#include "uart_6502.h"
+
+// Guest echo through the UART: a host thread feeds input, another drains
+// the echoed output in large chunks while the benchmark thread runs the
+// CPU. Reported counters:
+//   bytes   echoed bytes per host second
+//   MHz     emulated cycles per host second / 1e6
+
+using namespace cpu6502;
+
+namespace
+{
+    constexpr u32 BYTES_PER_RUN = 64 * 1024;
+
+    const Byte Echo[] = {
+        0xAD, 0x01, 0xD0, // loop: LDA $D001
+        0x29, 0x01,       //       AND #RX_READY
+        0xF0, 0xF9,       //       BEQ loop
+        0xAD, 0x00, 0xD0, //       LDA $D000
+        0xA8,             //       TAY
+        0xAD, 0x01, 0xD0, // tx:   LDA $D001
+        0x29, 0x02,       //       AND #TX_READY
+        0xF0, 0xF9,       //       BEQ tx
+        0x8C, 0x00, 0xD0, //       STY $D000
+        0x4C, 0x00, 0x02, //       JMP loop
+    };
+
+    void BM_UartEcho(benchmark::State &State)
+    {
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        cpu.Reset(*memory, 0x0200);
+        for (u32 i = 0; i < sizeof(Echo); i++)
+        {
+            (*memory)[0x0200 + i] = Echo[i];
+        }
+        auto uart = std::make_unique<Uart>(0xD000);
+        memory->Map(uart.get(), 0xD000, 0xD001);
+
+        u64 Cycles = 0;
+        for (auto _ : State)
+        {
+            std::atomic<bool> Done{false};
+            std::thread Writer([&] {
+                Byte Chunk[1024] = {};
+                for (u32 Sent = 0; Sent < BYTES_PER_RUN;)
+                {
+                    u32 Pushed = uart->Send(Chunk, std::min<u32>(sizeof(Chunk), BYTES_PER_RUN - Sent));
+                    Sent += Pushed;
+                    if (!Pushed)
+                        std::this_thread::yield();
+                }
+            });
+            std::thread Reader([&] {
+                Byte Chunk[Uart::BUFFER_SIZE];
+                for (u32 Received = 0; Received < BYTES_PER_RUN;)
+                {
+                    u32 Count = uart->Receive(Chunk, sizeof(Chunk));
+                    Received += Count;
+                    if (!Count)
+                        std::this_thread::yield();
+                }
+                Done = true;
+            });
+            u64 Start = cpu.CycleCount;
+            while (!Done.load(std::memory_order_relaxed))
+            {
+                cpu.Execute(20000, *memory);
+            }
+            Cycles += cpu.CycleCount - Start;
+            Writer.join();
+            Reader.join();
+        }
+        State.counters["bytes"] = benchmark::Counter(double(State.iterations()) * BYTES_PER_RUN, benchmark::Counter::kIsRate);
+        State.counters["MHz"] = benchmark::Counter(double(Cycles) / 1e6, benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(BM_UartEcho)->Name("Uart/Echo")->UseRealTime();
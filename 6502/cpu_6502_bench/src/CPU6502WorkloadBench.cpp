@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include "main_6502.h"
+#include "heatmap_6502.h"
+#include "workloads_6502.h"
+
+// Whole program benchmarks: every iteration loads one of the built-in
+// workloads and runs it to completion. Heatmap/ runs the same programs
+// with a per-byte MemoryHeatmap attached, which has to stay within 2x of
+// the plain run. Reported counters:
+//   MHz       emulated cycles per host second / 1e6
+//   cycles    emulated cycles per run (constant, a run that differs is an error)
+//   slowdown  Heatmap/ only: run time over the plain run time, measured
+//             back to back in the same process
+
+using namespace cpu6502;
+
+namespace
+{
+    void RunWorkload(benchmark::State &State, const Workload &Program)
+    {
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        u64 Cycles = 0;
+        for (auto _ : State)
+        {
+            State.PauseTiming();
+            Program.Load(cpu, *memory);
+            State.ResumeTiming();
+            ExecuteResult Result = cpu.Execute(Program.ExpectedCycles, *memory);
+            Cycles += Result.Cycles;
+            if (Result.Reason != StopReason::BudgetExhausted)
+            {
+                State.SkipWithError("workload stopped on an illegal opcode or trap");
+                return;
+            }
+        }
+
+        if (cpu.PC != Program.DoneAddress || !Program.Verify(*memory))
+        {
+            State.SkipWithError("workload did not finish with the expected result");
+            return;
+        }
+        State.counters["MHz"] = benchmark::Counter(double(Cycles) / 1e6, benchmark::Counter::kIsRate);
+        State.counters["cycles"] = double(Program.ExpectedCycles);
+    }
+
+    // Seconds spent in Execute for one run of Program
+    double TimeRun(CPU &cpu, Mem &memory, const Workload &Program)
+    {
+        Program.Load(cpu, memory);
+        auto Start = std::chrono::steady_clock::now();
+        cpu.Execute(Program.ExpectedCycles, memory);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    }
+
+    void RunWithHeatmap(benchmark::State &State, const Workload &Program)
+    {
+        auto memory = std::make_unique<Mem>();
+        CPU cpu;
+        MemoryHeatmap Heatmap(true);
+        double Plain = 0, Instrumented = 0;
+        u64 Cycles = 0;
+        for (auto _ : State)
+        {
+            State.PauseTiming();
+            cpu.Hooks = nullptr;
+            Plain += TimeRun(cpu, *memory, Program);
+            Heatmap.Clear();
+            Program.Load(cpu, *memory);
+            cpu.Hooks = &Heatmap;
+            State.ResumeTiming();
+            auto Start = std::chrono::steady_clock::now();
+            ExecuteResult Result = cpu.Execute(Program.ExpectedCycles, *memory);
+            Instrumented += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+            Cycles += Result.Cycles;
+        }
+        cpu.Hooks = nullptr;
+
+        if (cpu.PC != Program.DoneAddress || !Program.Verify(*memory))
+        {
+            State.SkipWithError("workload did not finish with the expected result");
+            return;
+        }
+        State.counters["MHz"] = benchmark::Counter(double(Cycles) / 1e6, benchmark::Counter::kIsRate);
+        State.counters["cycles"] = double(Program.ExpectedCycles);
+        State.counters["slowdown"] = Instrumented / Plain;
+    }
+
+    const bool Registered = [] {
+        for (const Workload &Program : Workloads())
+        {
+            benchmark::RegisterBenchmark((std::string("Workloads/") + Program.Name).c_str(), RunWorkload, Program);
+        }
+        for (const Workload &Program : Workloads())
+        {
+            benchmark::RegisterBenchmark((std::string("Heatmap/") + Program.Name).c_str(), RunWithHeatmap, Program);
+        }
+        return true;
+    }();
+}
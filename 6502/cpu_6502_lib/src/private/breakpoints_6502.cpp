@@ -0,0 +1,435 @@
+#include "breakpoints_6502.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+using namespace cpu6502;
+
+namespace
+{
+    using Op = Condition::Op;
+
+    // Recursive descent compiler, lowest precedence first:
+    //   Or      := And ('||' And)*
+    //   And     := Compare ('&&' Compare)*
+    //   Compare := BitAnd (('=='|'!='|'<='|'>='|'<'|'>') BitAnd)?
+    //   BitAnd  := Sum ('&' Sum)*
+    //   Sum     := Unary (('+'|'-') Unary)*
+    //   Unary   := '!' Unary | Primary
+    //   Primary := number | register | '[' Or ']' | '(' Or ')'
+    struct Compiler
+    {
+        const char *Text;
+        std::vector<Condition::Step> &Code;
+        std::string Error;
+        u32 Depth = 0;
+        u32 MaxDepth = 0;
+
+        void Emit(Op Code_, Word Operand = 0)
+        {
+            Code.push_back({Code_, Operand});
+            if (Code_ <= Op::PS)
+                MaxDepth = std::max(MaxDepth, ++Depth);
+            else if (Code_ >= Op::Add)
+                Depth--;
+        }
+
+        void SkipSpaces()
+        {
+            while (isspace(static_cast<unsigned char>(*Text)))
+                Text++;
+        }
+
+        bool Accept(const char *Token)
+        {
+            SkipSpaces();
+            size_t Length = strlen(Token);
+            if (strncmp(Text, Token, Length) != 0)
+                return false;
+            // '&' must not eat half of '&&', '<' half of '<='...
+            if (Length == 1 && ((Token[0] == '&' && Text[1] == '&') || (strchr("<>!", Token[0]) && Text[1] == '=')))
+                return false;
+            Text += Length;
+            return true;
+        }
+
+        bool Fail(const char *Message)
+        {
+            if (Error.empty())
+                Error = Message;
+            return false;
+        }
+
+        bool Or()
+        {
+            if (!And())
+                return false;
+            while (Accept("||"))
+            {
+                if (!And())
+                    return false;
+                Emit(Op::Or);
+            }
+            return true;
+        }
+
+        bool And()
+        {
+            if (!Compare())
+                return false;
+            while (Accept("&&"))
+            {
+                if (!Compare())
+                    return false;
+                Emit(Op::And);
+            }
+            return true;
+        }
+
+        bool Compare()
+        {
+            if (!BitAnd())
+                return false;
+            static const struct
+            {
+                const char *Token;
+                Op Code;
+            } Operators[] = {{"==", Op::Equal}, {"!=", Op::NotEqual}, {"<=", Op::LessEqual},
+                             {">=", Op::GreaterEqual}, {"<", Op::Less}, {">", Op::Greater}};
+            for (const auto &Operator : Operators)
+            {
+                if (Accept(Operator.Token))
+                {
+                    if (!BitAnd())
+                        return false;
+                    Emit(Operator.Code);
+                    break;
+                }
+            }
+            return true;
+        }
+
+        bool BitAnd()
+        {
+            if (!Sum())
+                return false;
+            while (Accept("&"))
+            {
+                if (!Sum())
+                    return false;
+                Emit(Op::BitAnd);
+            }
+            return true;
+        }
+
+        bool Sum()
+        {
+            if (!Unary())
+                return false;
+            for (;;)
+            {
+                Op Code_;
+                if (Accept("+"))
+                    Code_ = Op::Add;
+                else if (Accept("-"))
+                    Code_ = Op::Sub;
+                else
+                    return true;
+                if (!Unary())
+                    return false;
+                Emit(Code_);
+            }
+        }
+
+        bool Unary()
+        {
+            if (Accept("!"))
+            {
+                if (!Unary())
+                    return false;
+                Emit(Op::Not);
+                return true;
+            }
+            return Primary();
+        }
+
+        bool Primary()
+        {
+            SkipSpaces();
+            if (Accept("("))
+            {
+                if (!Or())
+                    return false;
+                return Accept(")") || Fail("missing ')'");
+            }
+            if (Accept("["))
+            {
+                if (!Or())
+                    return false;
+                Emit(Op::Load);
+                return Accept("]") || Fail("missing ']'");
+            }
+
+            int Base = 10;
+            if (*Text == '$')
+            {
+                Base = 16;
+                Text++;
+            }
+            else if (Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
+            {
+                Base = 16;
+                Text += 2;
+            }
+            else if (*Text == '%')
+            {
+                Base = 2;
+                Text++;
+            }
+            if (Base != 10 || isdigit(static_cast<unsigned char>(*Text)))
+            {
+                char *End = nullptr;
+                unsigned long Value = strtoul(Text, &End, Base);
+                if (End == Text || Value > 0xFFFF)
+                    return Fail("bad number");
+                Text = End;
+                Emit(Op::Const, static_cast<Word>(Value));
+                return true;
+            }
+
+            const char *Start = Text;
+            while (isalpha(static_cast<unsigned char>(*Text)))
+                Text++;
+            std::string Name(Start, Text);
+            for (char &c : Name)
+                c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+            static const struct
+            {
+                const char *Name;
+                Op Code;
+            } Registers[] = {{"A", Op::A}, {"X", Op::X},   {"Y", Op::Y},
+                             {"SP", Op::SP}, {"PC", Op::PC}, {"P", Op::PS}};
+            for (const auto &Register : Registers)
+            {
+                if (Name == Register.Name)
+                {
+                    Emit(Register.Code);
+                    return true;
+                }
+            }
+            return Fail(Name.empty() ? "expected a value" : "unknown register");
+        }
+    };
+}
+
+bool cpu6502::Condition::Compile(const std::string &Source, std::string *Error)
+{
+    Code.clear();
+    Compiler Parser{Source.c_str(), Code, {}};
+    bool Ok = Parser.Or();
+    Parser.SkipSpaces();
+    if (Ok && *Parser.Text != '\0')
+        Ok = Parser.Fail("unexpected text after expression");
+    if (Ok && Parser.MaxDepth > MAX_DEPTH)
+        Ok = Parser.Fail("expression too deep");
+    if (!Ok)
+    {
+        Code.clear();
+        if (Error)
+            *Error = Parser.Error;
+    }
+    return Ok;
+}
+
+bool cpu6502::Condition::Evaluate(const CPU &cpu, const Mem &memory) const
+{
+    if (Code.empty())
+        return true;
+
+    s32 Stack[MAX_DEPTH];
+    u32 Top = 0;
+    for (const Step &Instruction : Code)
+    {
+        switch (Instruction.Code)
+        {
+        case Op::Const:
+            Stack[Top++] = Instruction.Operand;
+            break;
+        case Op::A:
+            Stack[Top++] = cpu.A;
+            break;
+        case Op::X:
+            Stack[Top++] = cpu.X;
+            break;
+        case Op::Y:
+            Stack[Top++] = cpu.Y;
+            break;
+        case Op::SP:
+            Stack[Top++] = cpu.SP;
+            break;
+        case Op::PC:
+            Stack[Top++] = cpu.PC;
+            break;
+        case Op::PS:
+            Stack[Top++] = cpu.PS;
+            break;
+        case Op::Load:
+            Stack[Top - 1] = memory[Stack[Top - 1] & 0xFFFF];
+            break;
+        case Op::Not:
+            Stack[Top - 1] = !Stack[Top - 1];
+            break;
+        default:
+        {
+            s32 Right = Stack[--Top];
+            s32 &Left = Stack[Top - 1];
+            switch (Instruction.Code)
+            {
+            case Op::Add:
+                Left = Left + Right;
+                break;
+            case Op::Sub:
+                Left = Left - Right;
+                break;
+            case Op::BitAnd:
+                Left = Left & Right;
+                break;
+            case Op::Equal:
+                Left = Left == Right;
+                break;
+            case Op::NotEqual:
+                Left = Left != Right;
+                break;
+            case Op::Less:
+                Left = Left < Right;
+                break;
+            case Op::LessEqual:
+                Left = Left <= Right;
+                break;
+            case Op::Greater:
+                Left = Left > Right;
+                break;
+            case Op::GreaterEqual:
+                Left = Left >= Right;
+                break;
+            case Op::And:
+                Left = Left && Right;
+                break;
+            default:
+                Left = Left || Right;
+                break;
+            }
+        }
+        break;
+        }
+    }
+    return Stack[0] != 0;
+}
+
+cpu6502::Breakpoints::Breakpoints() : AddressFlags(Mem::MAX_MEM, 0)
+{
+}
+
+void cpu6502::Breakpoints::AddBreakpoint(Word Address, const Condition &When)
+{
+    Set(Address, EXECUTE, When);
+}
+
+void cpu6502::Breakpoints::RemoveBreakpoint(Word Address)
+{
+    Unset(Address, EXECUTE);
+}
+
+void cpu6502::Breakpoints::AddWatchpoint(Word First, Word Last, Byte Kinds, const Condition &When)
+{
+    for (u32 Address = First; Address <= Last; Address++)
+    {
+        Set(static_cast<Word>(Address), Kinds & (READ | WRITE), When);
+    }
+}
+
+void cpu6502::Breakpoints::RemoveWatchpoint(Word First, Word Last, Byte Kinds)
+{
+    for (u32 Address = First; Address <= Last; Address++)
+    {
+        Unset(static_cast<Word>(Address), Kinds & (READ | WRITE));
+    }
+}
+
+void cpu6502::Breakpoints::Clear()
+{
+    std::fill(AddressFlags.begin(), AddressFlags.end(), 0);
+    std::fill(std::begin(PageFlags), std::end(PageFlags), 0);
+    Conditions.clear();
+}
+
+void cpu6502::Breakpoints::Set(Word Address, Byte Kinds, const Condition &When)
+{
+    AddressFlags[Address] |= Kinds;
+    for (Byte Kind : {EXECUTE, READ, WRITE})
+    {
+        if (!(Kinds & Kind))
+            continue;
+        if (When.Code.empty())
+            Conditions.erase((u32(Kind) << 16) | Address);
+        else
+            Conditions[(u32(Kind) << 16) | Address] = When;
+    }
+    UpdatePage(Address >> 8);
+}
+
+void cpu6502::Breakpoints::Unset(Word Address, Byte Kinds)
+{
+    AddressFlags[Address] &= ~Kinds;
+    for (Byte Kind : {EXECUTE, READ, WRITE})
+    {
+        if (Kinds & Kind)
+            Conditions.erase((u32(Kind) << 16) | Address);
+    }
+    UpdatePage(Address >> 8);
+}
+
+void cpu6502::Breakpoints::UpdatePage(Byte Page)
+{
+    Byte Flags = 0;
+    for (u32 i = 0; i < 256; i++)
+    {
+        Flags |= AddressFlags[(Page << 8) | i];
+    }
+    PageFlags[Page] = Flags;
+}
+
+bool cpu6502::Breakpoints::Check(Byte Kind, const CPU &cpu, const Mem &memory, Word Address) const
+{
+    if (!(AddressFlags[Address] & Kind))
+        return false;
+    auto It = Conditions.find((u32(Kind) << 16) | Address);
+    return It == Conditions.end() || It->second.Evaluate(cpu, memory);
+}
+
+bool cpu6502::Breakpoints::BreakAt(const CPU &cpu, const Mem &memory)
+{
+    if (!Check(EXECUTE, cpu, memory, cpu.PC))
+        return false;
+    LastHit = {EXECUTE, cpu.PC, cpu.PC, memory[cpu.PC]};
+    return true;
+}
+
+void cpu6502::Breakpoints::OnRead(const CPU &cpu, const Mem &memory, Word Address, Byte Value)
+{
+    if (!Triggered && Check(READ, cpu, memory, Address))
+    {
+        LastHit = {READ, InstructionPC, Address, Value};
+        Triggered = true;
+    }
+}
+
+void cpu6502::Breakpoints::OnWrite(const CPU &cpu, const Mem &memory, Word Address, Byte Value)
+{
+    if (!Triggered && Check(WRITE, cpu, memory, Address))
+    {
+        LastHit = {WRITE, InstructionPC, Address, Value};
+        Triggered = true;
+    }
+}
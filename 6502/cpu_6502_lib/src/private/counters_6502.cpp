@@ -0,0 +1,72 @@
+#include "counters_6502.h"
+#include <string.h>
+#include <type_traits>
+
+cpu6502::u64 cpu6502::CounterSnapshot::InstructionsWithMode(AddressingMode Mode) const
+{
+    u64 Total = 0;
+    for (u32 Opcode = 0; Opcode < 256; Opcode++)
+    {
+        if (CPU::AddressingModeOf(static_cast<Byte>(Opcode)) == Mode)
+            Total += PerOpcode[Opcode];
+    }
+    return Total;
+}
+
+cpu6502::u64 cpu6502::CounterSnapshot::ReadsInRegion(Word First, Word Last) const
+{
+    u64 Total = 0;
+    for (u32 Page = First >> 8; Page <= static_cast<u32>(Last >> 8); Page++)
+    {
+        Total += ReadsPerPage[Page];
+    }
+    return Total;
+}
+
+cpu6502::u64 cpu6502::CounterSnapshot::WritesInRegion(Word First, Word Last) const
+{
+    u64 Total = 0;
+    for (u32 Page = First >> 8; Page <= static_cast<u32>(Last >> 8); Page++)
+    {
+        Total += WritesPerPage[Page];
+    }
+    return Total;
+}
+
+void cpu6502::InstructionCounters::Publish()
+{
+    static_assert(std::is_trivially_copyable<CounterSnapshot>::value && sizeof(CounterSnapshot) % sizeof(u64) == 0,
+                  "CounterSnapshot is published as a run of u64");
+    u64 Words[WORDS];
+    memcpy(Words, &Counts, sizeof(Words));
+
+    u32 Start = Sequence.load(std::memory_order_relaxed);
+    Sequence.store(Start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (u32 i = 0; i < WORDS; i++)
+    {
+        Published[i].store(Words[i], std::memory_order_relaxed);
+    }
+    Sequence.store(Start + 2, std::memory_order_release);
+}
+
+cpu6502::CounterSnapshot cpu6502::InstructionCounters::ReadPublished() const
+{
+    u64 Words[WORDS];
+    for (;;)
+    {
+        u32 Before = Sequence.load(std::memory_order_acquire);
+        if (Before & 1)
+            continue;
+        for (u32 i = 0; i < WORDS; i++)
+        {
+            Words[i] = Published[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (Sequence.load(std::memory_order_relaxed) == Before)
+            break;
+    }
+    CounterSnapshot Result;
+    memcpy(&Result, Words, sizeof(Words));
+    return Result;
+}
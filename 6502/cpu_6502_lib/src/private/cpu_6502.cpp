@@ -1,6 +1,8 @@
 #include "main_6502.h"
+#include <algorithm>
+#include <climits>
 
-cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
+cpu6502::ExecuteResult cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
 {
     // Lambda function to load A, X, Y Register with a given Address
     auto LoadRegister = [&Cycles, &memory, this](Byte &Register, Word Address) {
@@ -23,23 +25,201 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
         Set_Zero_and_Negative_Flags(A);
     };
 
-    auto MemOp = [&Cycles, &memory, this](Word Address, char Operation) {
-        Byte Value = ReadByte(Cycles, memory, Address);
-        if (Operation == 'I')
-            Value++;
-        else if (Operation == 'D')
-            Value--;
-        else
-            throw -1;
+    auto Adc = [&Cycles, &memory, this](Word Address) {
+        AddWithCarry(ReadByte(Cycles, memory, Address));
+    };
+
+    auto Sbc = [&Cycles, &memory, this](Word Address) {
+        SubtractWithCarry(ReadByte(Cycles, memory, Address));
+    };
+
+    auto Compare = [&Cycles, &memory, this](Byte Register, Word Address) {
+        CompareRegister(Register, ReadByte(Cycles, memory, Address));
+    };
+
+    // Shifts, rotates, INC & DEC - take the operand, update the flags and return the result
+    auto ShiftLeft = [this](Byte Value) -> Byte {
+        flags.C = (Value & 0b10000000) > 0;
+        Value <<= 1;
+        Set_Zero_and_Negative_Flags(Value);
+        return Value;
+    };
+
+    auto ShiftRight = [this](Byte Value) -> Byte {
+        flags.C = Value & 0b00000001;
+        Value >>= 1;
+        Set_Zero_and_Negative_Flags(Value);
+        return Value;
+    };
+
+    auto RotateLeft = [this](Byte Value) -> Byte {
+        Byte OldCarry = flags.C;
+        flags.C = (Value & 0b10000000) > 0;
+        Value = static_cast<Byte>((Value << 1) | OldCarry);
+        Set_Zero_and_Negative_Flags(Value);
+        return Value;
+    };
 
+    auto RotateRight = [this](Byte Value) -> Byte {
+        Byte OldCarry = flags.C;
+        flags.C = Value & 0b00000001;
+        Value = static_cast<Byte>((Value >> 1) | (OldCarry << 7));
+        Set_Zero_and_Negative_Flags(Value);
+        return Value;
+    };
+
+    auto Increment = [this](Byte Value) -> Byte {
+        Value++;
+        Set_Zero_and_Negative_Flags(Value);
+        return Value;
+    };
+
+    auto Decrement = [this](Byte Value) -> Byte {
+        Value--;
+        Set_Zero_and_Negative_Flags(Value);
+        return Value;
+    };
+
+    // Read-modify-write of a memory operand, the extra cycle is the 6502
+    // writing the unmodified value back first
+    auto Modify = [&Cycles, &memory, this](Word Address, auto Operation) {
+        Byte Value = Operation(ReadByte(Cycles, memory, Address));
         Cycles--;
         WriteByte(Value, Address, Cycles, memory);
-        Set_Zero_and_Negative_Flags(Value);
+    };
+
+    // Last backward branch / jump and the registers it arrived with
+    struct
+    {
+        u32 Head = Debugger::NO_PC;
+        Word Tail = 0;
+        bool Idle = false;
+        Byte A, X, Y, SP, PS;
+        s32 Cycles;
+        u64 VolatileReads;
+    } Loop;
+
+    // Called after the branch / jump at Tail went back to PC. Seeing the
+    // same registers at the head of an idle loop twice in a row means all
+    // further trips are the same, so skip as many whole ones as fit in the
+    // budget and run the last one normally to keep the cycle count exact.
+    auto LoopedBack = [&Cycles, &memory, &Loop, this](Word Tail) {
+        if (!SkipIdleLoops || Hooks || Debug || Coverage)
+            return;
+        // An idle loop cannot rewrite itself, so the check holds while we stay in it
+        bool Again = Loop.Head == PC && Loop.Tail == Tail;
+        bool Idle = Again ? Loop.Idle : IsIdleLoop(memory, PC, Tail);
+        if (Again && Idle && Loop.A == A && Loop.X == X && Loop.Y == Y && Loop.SP == SP && Loop.PS == PS &&
+            Loop.VolatileReads == VolatileReads)
+        {
+            s32 Trip = Loop.Cycles - Cycles;
+            if (Cycles > Trip)
+            {
+                s32 Trips = (Cycles - 1) / Trip;
+                Cycles -= Trips * Trip;
+                IdleCyclesSkipped += static_cast<u64>(Trips) * Trip;
+            }
+        }
+        Loop = {PC, Tail, Idle, A, X, Y, SP, PS, Cycles, VolatileReads};
+    };
+
+    // 2 cycles, +1 when taken, +1 more when the target is on another page
+    auto Branch = [&Cycles, &memory, &Loop, &LoopedBack, this](bool Condition) {
+        Word Tail = PC - 1;
+        SByte Offset = static_cast<SByte>(Fetch_Byte(Cycles, memory));
+        if (Condition)
+        {
+            Word Target = PC + Offset;
+            Cycles--;
+            if ((Target >> 8) != (PC >> 8))
+                Cycles--;
+            PC = Target;
+            if (Target <= Tail)
+                LoopedBack(Tail);
+        }
+        else if (Tail == Loop.Tail)
+        {
+            // Left the loop, whatever runs next may change what it reads
+            Loop.Head = Debugger::NO_PC;
+        }
+        if (Coverage)
+            RecordEdge();
     };
 
     const s32 CyclesRequested = Cycles;
-    while (Cycles > 0)
+    SliceEndCycle = CycleCount + CyclesRequested;
+
+    // Every way out of Execute goes through here
+    auto Stop = [&Cycles, CyclesRequested, this](StopReason Reason, Word StopPC, Byte Opcode) {
+        Cycles += DeferredCycles + ForfeitedCycles;
+        SliceEndCycle += DeferredCycles;
+        DeferredCycles = ForfeitedCycles = 0;
+        RunningCycles = nullptr;
+        StallLimit = ~0ull;
+        CycleCount += CyclesRequested - Cycles;
+        return ExecuteResult{CyclesRequested - Cycles, Reason, StopPC, Opcode};
+    };
+
+    // RequestInterruptCheck parks the rest of the budget in DeferredCycles so
+    // the loop below ends after the current instruction. Take the interrupt,
+    // if it is still there, and carry on with the budget.
+    auto CheckInterrupts = [&Cycles, &memory, &Loop, this]() {
+        Cycles += DeferredCycles;
+        SliceEndCycle += DeferredCycles;
+        DeferredCycles = 0;
+        if (TakeInterrupt(Cycles, memory))
+            Loop.Head = Debugger::NO_PC;
+        return Cycles > 0;
+    };
+
+    // Lines raised between two Execute calls are seen here, any other time
+    // through RequestInterruptCheck, so the loop itself never polls them
+    RunningCycles = &Cycles;
+    u64 Posted = Host.Lines.load(std::memory_order_acquire);
+    if (Posted & HOST_NMI)
     {
+        Posted = Host.Lines.fetch_and(~HOST_NMI, std::memory_order_acq_rel);
+        NMIPending = true;
+    }
+    HostIRQLines = static_cast<u32>(Posted);
+    if (StallOwed)
+    {
+        // Still halted by a stall that ran into the end of the last slice
+        s32 Charged = static_cast<s32>(std::min<u64>(StallOwed, Cycles > 0 ? Cycles : 0));
+        Cycles -= Charged;
+        StallOwed -= Charged;
+    }
+    if (!StallOwed)
+        TakeInterrupt(Cycles, memory);
+
+    // A breakpoint Execute stopped on last time does not stop it again
+    u32 SkipBreakAt = (Debug && Debug->ResumePC == PC) ? PC : Debugger::NO_PC;
+    while (Cycles > 0 || (DeferredCycles > 0 && CheckInterrupts()))
+    {
+        if (Debug)
+        {
+            if (Debug->Triggered)
+            {
+                // Watchpoint hit by the previous instruction
+                Debug->Triggered = false;
+                Debug->ResumePC = Debugger::NO_PC;
+                return Stop(StopReason::Breakpoint, PC, memory[PC]);
+            }
+            if (Debug->PageFlags[PC >> 8] & Debugger::EXECUTE)
+            {
+                if (PC != SkipBreakAt && Debug->BreakAt(*this, memory))
+                {
+                    Debug->ResumePC = PC;
+                    return Stop(StopReason::Breakpoint, PC, memory[PC]);
+                }
+                SkipBreakAt = Debugger::NO_PC;
+            }
+            Debug->InstructionPC = PC;
+        }
+
+        if (Hooks)
+            Hooks->OnInstruction(*this, PC, memory[PC], CurrentCycle(Cycles));
+
         Byte Instruction = Fetch_Byte(Cycles, memory);
 
         switch (Instruction)
@@ -214,7 +394,7 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
         case INS_STX_ZEROP_Y:
         {
             Byte ZeroPageYAddress = ZeroPageWithOffset(Cycles, memory, Y);
-            WriteByte(Y, ZeroPageYAddress, Cycles, memory);
+            WriteByte(X, ZeroPageYAddress, Cycles, memory);
         }
         break;
 
@@ -241,14 +421,16 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
 
         case INS_STA_ABS_X:
         {
-            Word AbsoluteAddress_X = AbsoluteWithOffset(Cycles, memory, X);
+            // Stores always take 5 Cycles - No CrossingPageCheck
+            Word AbsoluteAddress_X = AbsoluteWithOffset_5(Cycles, memory, X);
             WriteByte(A, AbsoluteAddress_X, Cycles, memory);
         }
         break;
 
         case INS_STA_ABS_Y:
         {
-            Word AbsoluteAddress_Y = AbsoluteWithOffset(Cycles, memory, Y);
+            // Stores always take 5 Cycles - No CrossingPageCheck
+            Word AbsoluteAddress_Y = AbsoluteWithOffset_5(Cycles, memory, Y);
             WriteByte(A, AbsoluteAddress_Y, Cycles, memory);
         }
         break;
@@ -276,6 +458,8 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
             // Change PC to Jump Address
             PC = SubroutineAddr;
             Cycles--;
+            if (Coverage)
+                RecordEdge();
         }
         break;
 
@@ -285,19 +469,30 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
             Word ReturnAddress = PopWordFromStack(Cycles, memory);
             PC = ReturnAddress + 1;
             Cycles -= 2;
+            if (Coverage)
+                RecordEdge();
         }
         break;
         case INS_JMP_ABS:
         {
             Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Word Tail = PC - 3;
             PC = AbsoluteAddress;
+            if (Coverage)
+                RecordEdge();
+            if (AbsoluteAddress <= Tail)
+                LoopedBack(Tail);
         }
         break;
         case INS_JMP_IND:
         {
             Word AbsoluteAddress = Fetch_Word(Cycles, memory);
-            Word JumpAddress = ReadWord(Cycles, memory, AbsoluteAddress);
-            PC = JumpAddress;
+            // NMOS bug: the high byte of a vector at $xxFF comes from $xx00
+            Byte LowByte = ReadByte(Cycles, memory, AbsoluteAddress);
+            Byte HighByte = ReadByte(Cycles, memory, (AbsoluteAddress & 0xFF00) | ((AbsoluteAddress + 1) & 0x00FF));
+            PC = (HighByte << 8) | LowByte;
+            if (Coverage)
+                RecordEdge();
         }
         break;
 
@@ -305,7 +500,7 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
         {
             X = SP;
             Cycles--;
-            Set_Zero_and_Negative_Flags(A);
+            Set_Zero_and_Negative_Flags(X);
         }
         break;
 
@@ -340,8 +535,10 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
 
         case INS_PLP:
         {
+            bool WasSet = flags.I;
             PS = PopByteFromStack(Cycles, memory);
             Cycles--;
+            ClearedInterruptMask(WasSet);
         }
         break;
 
@@ -564,56 +761,56 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
         case INS_INC_ZERO_P:
         {
             Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
-            MemOp(ZeroPageAddress, 'I');
+            Modify(ZeroPageAddress, Increment);
         }
         break;
 
         case INS_INC_ZERO_PX:
         {
             Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
-            MemOp(ZeroPageXOffsetAddress, 'I');
+            Modify(ZeroPageXOffsetAddress, Increment);
         }
         break;
 
         case INS_INC_ABS:
         {
             Word AbsoluteAddress = Fetch_Word(Cycles, memory);
-            MemOp(AbsoluteAddress, 'I');
+            Modify(AbsoluteAddress, Increment);
         }
         break;
 
         case INS_INC_ABS_X:
         {
             Word AbsoluteXAddress = AbsoluteWithOffset_5(Cycles, memory, X);
-            MemOp(AbsoluteXAddress, 'I');
+            Modify(AbsoluteXAddress, Increment);
         }
         break;
 
         case INS_DEC_ZERO_P:
         {
             Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
-            MemOp(ZeroPageAddress, 'D');
+            Modify(ZeroPageAddress, Decrement);
         }
         break;
 
         case INS_DEC_ZERO_PX:
         {
             Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
-            MemOp(ZeroPageXOffsetAddress, 'D');
+            Modify(ZeroPageXOffsetAddress, Decrement);
         }
         break;
 
         case INS_DEC_ABS:
         {
             Word AbsoluteAddress = Fetch_Word(Cycles, memory);
-            MemOp(AbsoluteAddress, 'D');
+            Modify(AbsoluteAddress, Decrement);
         }
         break;
 
         case INS_DEC_ABS_X:
         {
             Word AbsoluteXAddress = AbsoluteWithOffset_5(Cycles, memory, X);
-            MemOp(AbsoluteXAddress, 'D');
+            Modify(AbsoluteXAddress, Decrement);
         }
         break;
 
@@ -649,14 +846,634 @@ cpu6502::s32 cpu6502::CPU::Execute(s32 Cycles, Mem &memory)
         }
         break;
 
+        case INS_ADC_IM:
+        {
+            AddWithCarry(Fetch_Byte(Cycles, memory));
+        }
+        break;
+
+        case INS_ADC_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Adc(ZeroPageAddress);
+        }
+        break;
+
+        case INS_ADC_ZERO_PX:
+        {
+            Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
+            Adc(ZeroPageXOffsetAddress);
+        }
+        break;
+
+        case INS_ADC_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Adc(AbsoluteAddress);
+        }
+        break;
+
+        case INS_ADC_ABS_X:
+        {
+            Word AbsoluteXAddress = AbsoluteWithOffset(Cycles, memory, X);
+            Adc(AbsoluteXAddress);
+        }
+        break;
+
+        case INS_ADC_ABS_Y:
+        {
+            Word AbsoluteYAddress = AbsoluteWithOffset(Cycles, memory, Y);
+            Adc(AbsoluteYAddress);
+        }
+        break;
+
+        case INS_ADC_IND_X:
+        {
+            Word EffectiveAddress = IndirectX(Cycles, memory);
+            Adc(EffectiveAddress);
+        }
+        break;
+
+        case INS_ADC_IND_Y:
+        {
+            Word EffectiveAddress = IndirectY(Cycles, memory);
+            Adc(EffectiveAddress);
+        }
+        break;
+
+        case INS_SBC_IM:
+        {
+            SubtractWithCarry(Fetch_Byte(Cycles, memory));
+        }
+        break;
+
+        case INS_SBC_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Sbc(ZeroPageAddress);
+        }
+        break;
+
+        case INS_SBC_ZERO_PX:
+        {
+            Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
+            Sbc(ZeroPageXOffsetAddress);
+        }
+        break;
+
+        case INS_SBC_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Sbc(AbsoluteAddress);
+        }
+        break;
+
+        case INS_SBC_ABS_X:
+        {
+            Word AbsoluteXAddress = AbsoluteWithOffset(Cycles, memory, X);
+            Sbc(AbsoluteXAddress);
+        }
+        break;
+
+        case INS_SBC_ABS_Y:
+        {
+            Word AbsoluteYAddress = AbsoluteWithOffset(Cycles, memory, Y);
+            Sbc(AbsoluteYAddress);
+        }
+        break;
+
+        case INS_SBC_IND_X:
+        {
+            Word EffectiveAddress = IndirectX(Cycles, memory);
+            Sbc(EffectiveAddress);
+        }
+        break;
+
+        case INS_SBC_IND_Y:
+        {
+            Word EffectiveAddress = IndirectY(Cycles, memory);
+            Sbc(EffectiveAddress);
+        }
+        break;
+
+        case INS_CMP_IM:
+        {
+            CompareRegister(A, Fetch_Byte(Cycles, memory));
+        }
+        break;
+
+        case INS_CMP_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Compare(A, ZeroPageAddress);
+        }
+        break;
+
+        case INS_CMP_ZERO_PX:
+        {
+            Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
+            Compare(A, ZeroPageXOffsetAddress);
+        }
+        break;
+
+        case INS_CMP_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Compare(A, AbsoluteAddress);
+        }
+        break;
+
+        case INS_CMP_ABS_X:
+        {
+            Word AbsoluteXAddress = AbsoluteWithOffset(Cycles, memory, X);
+            Compare(A, AbsoluteXAddress);
+        }
+        break;
+
+        case INS_CMP_ABS_Y:
+        {
+            Word AbsoluteYAddress = AbsoluteWithOffset(Cycles, memory, Y);
+            Compare(A, AbsoluteYAddress);
+        }
+        break;
+
+        case INS_CMP_IND_X:
+        {
+            Word EffectiveAddress = IndirectX(Cycles, memory);
+            Compare(A, EffectiveAddress);
+        }
+        break;
+
+        case INS_CMP_IND_Y:
+        {
+            Word EffectiveAddress = IndirectY(Cycles, memory);
+            Compare(A, EffectiveAddress);
+        }
+        break;
+
+        case INS_CPX_IM:
+        {
+            CompareRegister(X, Fetch_Byte(Cycles, memory));
+        }
+        break;
+
+        case INS_CPX_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Compare(X, ZeroPageAddress);
+        }
+        break;
+
+        case INS_CPX_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Compare(X, AbsoluteAddress);
+        }
+        break;
+
+        case INS_CPY_IM:
+        {
+            CompareRegister(Y, Fetch_Byte(Cycles, memory));
+        }
+        break;
+
+        case INS_CPY_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Compare(Y, ZeroPageAddress);
+        }
+        break;
+
+        case INS_CPY_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Compare(Y, AbsoluteAddress);
+        }
+        break;
+
+        case INS_ASL:
+        {
+            A = ShiftLeft(A);
+            Cycles--;
+        }
+        break;
+
+        case INS_ASL_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Modify(ZeroPageAddress, ShiftLeft);
+        }
+        break;
+
+        case INS_ASL_ZERO_PX:
+        {
+            Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
+            Modify(ZeroPageXOffsetAddress, ShiftLeft);
+        }
+        break;
+
+        case INS_ASL_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Modify(AbsoluteAddress, ShiftLeft);
+        }
+        break;
+
+        case INS_ASL_ABS_X:
+        {
+            Word AbsoluteXAddress = AbsoluteWithOffset_5(Cycles, memory, X);
+            Modify(AbsoluteXAddress, ShiftLeft);
+        }
+        break;
+
+        case INS_LSR:
+        {
+            A = ShiftRight(A);
+            Cycles--;
+        }
+        break;
+
+        case INS_LSR_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Modify(ZeroPageAddress, ShiftRight);
+        }
+        break;
+
+        case INS_LSR_ZERO_PX:
+        {
+            Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
+            Modify(ZeroPageXOffsetAddress, ShiftRight);
+        }
+        break;
+
+        case INS_LSR_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Modify(AbsoluteAddress, ShiftRight);
+        }
+        break;
+
+        case INS_LSR_ABS_X:
+        {
+            Word AbsoluteXAddress = AbsoluteWithOffset_5(Cycles, memory, X);
+            Modify(AbsoluteXAddress, ShiftRight);
+        }
+        break;
+
+        case INS_ROL:
+        {
+            A = RotateLeft(A);
+            Cycles--;
+        }
+        break;
+
+        case INS_ROL_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Modify(ZeroPageAddress, RotateLeft);
+        }
+        break;
+
+        case INS_ROL_ZERO_PX:
+        {
+            Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
+            Modify(ZeroPageXOffsetAddress, RotateLeft);
+        }
+        break;
+
+        case INS_ROL_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Modify(AbsoluteAddress, RotateLeft);
+        }
+        break;
+
+        case INS_ROL_ABS_X:
+        {
+            Word AbsoluteXAddress = AbsoluteWithOffset_5(Cycles, memory, X);
+            Modify(AbsoluteXAddress, RotateLeft);
+        }
+        break;
+
+        case INS_ROR:
+        {
+            A = RotateRight(A);
+            Cycles--;
+        }
+        break;
+
+        case INS_ROR_ZERO_P:
+        {
+            Byte ZeroPageAddress = Fetch_Byte(Cycles, memory);
+            Modify(ZeroPageAddress, RotateRight);
+        }
+        break;
+
+        case INS_ROR_ZERO_PX:
+        {
+            Byte ZeroPageXOffsetAddress = ZeroPageWithOffset(Cycles, memory, X);
+            Modify(ZeroPageXOffsetAddress, RotateRight);
+        }
+        break;
+
+        case INS_ROR_ABS:
+        {
+            Word AbsoluteAddress = Fetch_Word(Cycles, memory);
+            Modify(AbsoluteAddress, RotateRight);
+        }
+        break;
+
+        case INS_ROR_ABS_X:
+        {
+            Word AbsoluteXAddress = AbsoluteWithOffset_5(Cycles, memory, X);
+            Modify(AbsoluteXAddress, RotateRight);
+        }
+        break;
+
+        case INS_BCC:
+        {
+            Branch(!flags.C);
+        }
+        break;
+
+        case INS_BCS:
+        {
+            Branch(flags.C);
+        }
+        break;
+
+        case INS_BEQ:
+        {
+            Branch(flags.Z);
+        }
+        break;
+
+        case INS_BMI:
+        {
+            Branch(flags.N);
+        }
+        break;
+
+        case INS_BNE:
+        {
+            Branch(!flags.Z);
+        }
+        break;
+
+        case INS_BPL:
+        {
+            Branch(!flags.N);
+        }
+        break;
+
+        case INS_BVC:
+        {
+            Branch(!flags.V);
+        }
+        break;
+
+        case INS_BVS:
+        {
+            Branch(flags.V);
+        }
+        break;
+
+        case INS_CLC:
+        {
+            flags.C = 0;
+            Cycles--;
+        }
+        break;
+
+        case INS_CLD:
+        {
+            flags.D = 0;
+            Cycles--;
+        }
+        break;
+
+        case INS_CLI:
+        {
+            bool WasSet = flags.I;
+            flags.I = 0;
+            Cycles--;
+            ClearedInterruptMask(WasSet);
+        }
+        break;
+
+        case INS_CLV:
+        {
+            flags.V = 0;
+            Cycles--;
+        }
+        break;
+
+        case INS_SEC:
+        {
+            flags.C = 1;
+            Cycles--;
+        }
+        break;
+
+        case INS_SED:
+        {
+            flags.D = 1;
+            Cycles--;
+        }
+        break;
+
+        case INS_SEI:
+        {
+            flags.I = 1;
+            Cycles--;
+        }
+        break;
+
+        case INS_BRK:
+        {
+            // The byte after BRK is skipped, the pushed status has B set
+            Fetch_Byte(Cycles, memory);
+            PushWordToStack(Cycles, memory, PC);
+            PushByteToStack(Cycles, memory, PS | 0b00110000);
+            flags.I = 1;
+            PC = ReadWord(Cycles, memory, 0xFFFE);
+            if (Coverage)
+                RecordEdge();
+        }
+        break;
+
+        case INS_NOP:
+        {
+            Cycles--;
+        }
+        break;
+
+        case INS_RTI:
+        {
+            PS = PopByteFromStack(Cycles, memory);
+            PC = PopWordFromStack(Cycles, memory);
+            if (Coverage)
+                RecordEdge();
+            // Unlike CLI / PLP the restored mask counts right away
+            if (IRQAsserted() && !flags.I)
+                RequestInterruptCheck();
+        }
+        break;
+
+        case INS_HOST_CALL:
+        {
+            // Skip the call number so the host can simply call Execute again
+            Fetch_Byte(Cycles, memory);
+            return Stop(StopReason::HostCall, PC - 2, Instruction);
+        }
+
+        case 0x02: case 0x12: case 0x22: case 0x32: case 0x52: case 0x62:
+        case 0x72: case 0x92: case 0xB2: case 0xD2: case 0xF2:
+        {
+            // JAM - the NMOS part locks up on the opcode
+            PC--;
+            return Stop(StopReason::Halted, PC, Instruction);
+        }
+
         default:
-            printf("\nInstruction %d not handled\n", Instruction);
-            throw -1;
-            break;
+        {
+            // Leave the machine as it was before the opcode was fetched
+            PC--;
+            Cycles++;
+            return Stop(StopReason::IllegalOpcode, PC, Instruction);
         }
+        }
+    }
+    if (Debug && Debug->Triggered)
+    {
+        Debug->Triggered = false;
+        Debug->ResumePC = Debugger::NO_PC;
+        return Stop(StopReason::Breakpoint, PC, memory[PC]);
     }
-    // Cycles should be 0 at this point
-    return CyclesRequested - Cycles;
+    return Stop(StopReason::BudgetExhausted, PC, memory[PC]);
+}
+
+void cpu6502::CPU::SetIRQ(u32 Sources, bool Asserted)
+{
+    bool Before = IRQAsserted();
+    IRQLines = Asserted ? (IRQLines | Sources) : (IRQLines & ~Sources);
+    if (!Before && IRQAsserted() && !flags.I)
+        RequestInterruptCheck();
+}
+
+void cpu6502::CPU::ClearedInterruptMask(bool WasSet)
+{
+    if (flags.I || !IRQAsserted())
+        return;
+    if (WasSet)
+        PendingIRQDelay = IRQDelay::AfterNext;
+    RequestInterruptCheck();
+}
+
+void cpu6502::CPU::TriggerNMI()
+{
+    NMIPending = true;
+    RequestInterruptCheck();
+}
+
+void cpu6502::CPU::RequestInterruptCheck()
+{
+    if (RunningCycles && *RunningCycles > 0)
+    {
+        // CurrentCycle stays right because the slice end moves along
+        DeferredCycles += *RunningCycles;
+        SliceEndCycle -= *RunningCycles;
+        *RunningCycles = 0;
+    }
+}
+
+void cpu6502::CPU::Stall(u32 StallCycles)
+{
+    if (!RunningCycles)
+    {
+        CycleCount += StallCycles;
+        return;
+    }
+    u64 Now = CurrentCycle(*RunningCycles);
+    u64 Room = StallLimit > Now ? StallLimit - Now : 0;
+    u32 Charged = static_cast<u32>(std::min<u64>(StallCycles, Room));
+    *RunningCycles -= static_cast<s32>(Charged);
+    StallOwed += StallCycles - Charged;
+}
+
+void cpu6502::CPU::EndSliceAt(u64 Cycle)
+{
+    if (!RunningCycles)
+        return;
+    StallLimit = std::min(StallLimit, Cycle);
+    // Parked cycles go first, they are not part of SliceEndCycle
+    u64 End = std::max(Cycle, CurrentCycle(*RunningCycles));
+    u64 Cut = SliceEndCycle + DeferredCycles > End ? SliceEndCycle + DeferredCycles - End : 0;
+    s32 FromDeferred = static_cast<s32>(std::min<u64>(Cut, DeferredCycles));
+    s32 FromBudget = static_cast<s32>(Cut) - FromDeferred;
+    DeferredCycles -= FromDeferred;
+    *RunningCycles -= FromBudget;
+    SliceEndCycle -= FromBudget;
+    ForfeitedCycles += FromDeferred + FromBudget;
+}
+
+bool cpu6502::CPU::TakeInterrupt(s32 &Cycles, Mem &memory)
+{
+    Word Vector;
+    if (NMIPending)
+    {
+        NMIPending = false;
+        Vector = 0xFFFA;
+    }
+    else if (IRQAsserted() && PendingIRQDelay != IRQDelay::AfterNext &&
+             (!flags.I || PendingIRQDelay == IRQDelay::Now))
+    {
+        Vector = 0xFFFE;
+    }
+    else
+    {
+        if (PendingIRQDelay == IRQDelay::AfterNext && IRQAsserted() && Cycles > 0)
+        {
+            // Check again once one more instruction has run
+            PendingIRQDelay = IRQDelay::Now;
+            DeferredCycles += Cycles - 1;
+            SliceEndCycle -= Cycles - 1;
+            Cycles = 1;
+        }
+        else if (PendingIRQDelay == IRQDelay::Now || !IRQAsserted())
+        {
+            PendingIRQDelay = IRQDelay::None;
+        }
+        return false;
+    }
+    PendingIRQDelay = IRQDelay::None;
+
+    // Like BRK without the padding byte and with B clear: 7 cycles
+    Cycles -= 2;
+    PushWordToStack(Cycles, memory, PC);
+    PushByteToStack(Cycles, memory, (PS & ~0b00010000) | 0b00100000);
+    flags.I = 1;
+    PC = ReadWord(Cycles, memory, Vector);
+    if (Coverage)
+        RecordEdge();
+    return true;
+}
+
+cpu6502::ExecuteResult cpu6502::CPU::RunUntil(u64 Cycle, Mem &memory)
+{
+    // Execute takes an s32 budget, long runs go in slices
+    constexpr u64 MAX_SLICE = 1u << 30;
+    const u64 Start = CycleCount;
+    ExecuteResult Result{0, StopReason::BudgetExhausted, PC, memory[PC]};
+    while (CycleCount < Cycle)
+    {
+        Result = Execute(static_cast<s32>(std::min(Cycle - CycleCount, MAX_SLICE)), memory);
+        if (Result.Reason != StopReason::BudgetExhausted)
+            break;
+    }
+    Result.Cycles = static_cast<s32>(std::min<u64>(CycleCount - Start, INT_MAX));
+    return Result;
 }
 
 cpu6502::Byte cpu6502::CPU::ZeroPageWithOffset(s32 &Cycles, Mem &memory, Byte &OffSet)
@@ -673,10 +1490,12 @@ cpu6502::Word cpu6502::CPU::AbsoluteWithOffset(s32 &Cycles, Mem &memory, Byte &O
 
     Word AbsoluteAddress = Fetch_Word(Cycles, memory);
     Word AbsoluteAddress_Offset = AbsoluteAddress + OffSet;
-    bool CrossingPage = (AbsoluteAddress % 256) + OffSet > 0xFE;
+    bool CrossingPage = (AbsoluteAddress % 256) + OffSet > 0xFF;
     if (CrossingPage)
     {
         Cycles--;
+        if (Hooks)
+            Hooks->OnPageCross(&OffSet == &X ? AddressingMode::AbsoluteX : AddressingMode::AbsoluteY);
     }
     return AbsoluteAddress_Offset;
 }
@@ -703,10 +1522,12 @@ cpu6502::Word cpu6502::CPU::IndirectY(s32 &Cycles, Mem &memory)
     Byte ZAddress = Fetch_Byte(Cycles, memory);
     Word EffectiveAddress = ReadWord(Cycles, memory, ZAddress);
     Word EffectiveAddress_Y = EffectiveAddress + Y;
-    bool CrossingPage = (EffectiveAddress % 256) + Y > 0xFE;
+    bool CrossingPage = (EffectiveAddress % 256) + Y > 0xFF;
     if (CrossingPage)
     {
         Cycles--;
+        if (Hooks)
+            Hooks->OnPageCross(AddressingMode::IndirectY);
     }
     return EffectiveAddress_Y;
 }
@@ -717,4 +1538,32 @@ cpu6502::Word cpu6502::CPU::IndirectY_6(s32 &Cycles, Mem &memory)
     Word EffectiveAddress = ReadWord(Cycles, memory, ZAddress);
     Cycles--;
     return EffectiveAddress + Y;
-}
\ No newline at end of file
+}
+
+cpu6502::AddressingMode cpu6502::CPU::AddressingModeOf(Byte Opcode)
+{
+    using M = AddressingMode;
+    constexpr M Imp = M::Implied, Acc = M::Accumulator, Imm = M::Immediate, Zp = M::ZeroPage,
+                ZpX = M::ZeroPageX, ZpY = M::ZeroPageY, Abs = M::Absolute, AbsX = M::AbsoluteX,
+                AbsY = M::AbsoluteY, Ind = M::Indirect, IndX = M::IndirectX, IndY = M::IndirectY,
+                Rel = M::Relative;
+    static constexpr M Modes[256] = {
+        Imp, IndX, Imp, Imp, Imp, Zp, Zp, Imp, Imp, Imm, Acc, Imp, Imp, Abs, Abs, Imp, // $00
+        Rel, IndY, Imp, Imp, Imp, ZpX, ZpX, Imp, Imp, AbsY, Imp, Imp, Imp, AbsX, AbsX, Imp, // $10
+        Abs, IndX, Imp, Imp, Zp, Zp, Zp, Imp, Imp, Imm, Acc, Imp, Abs, Abs, Abs, Imp, // $20
+        Rel, IndY, Imp, Imp, Imp, ZpX, ZpX, Imp, Imp, AbsY, Imp, Imp, Imp, AbsX, AbsX, Imp, // $30
+        Imp, IndX, Imp, Imp, Imp, Zp, Zp, Imp, Imp, Imm, Acc, Imp, Abs, Abs, Abs, Imp, // $40
+        Rel, IndY, Imp, Imp, Imp, ZpX, ZpX, Imp, Imp, AbsY, Imp, Imp, Imp, AbsX, AbsX, Imp, // $50
+        Imp, IndX, Imp, Imp, Imp, Zp, Zp, Imp, Imp, Imm, Acc, Imp, Ind, Abs, Abs, Imp, // $60
+        Rel, IndY, Imp, Imp, Imp, ZpX, ZpX, Imp, Imp, AbsY, Imp, Imp, Imp, AbsX, AbsX, Imp, // $70
+        Imp, IndX, Imp, Imp, Zp, Zp, Zp, Imp, Imp, Imp, Imp, Imp, Abs, Abs, Abs, Imp, // $80
+        Rel, IndY, Imp, Imp, ZpX, ZpX, ZpY, Imp, Imp, AbsY, Imp, Imp, Imp, AbsX, Imp, Imp, // $90
+        Imm, IndX, Imm, Imp, Zp, Zp, Zp, Imp, Imp, Imm, Imp, Imp, Abs, Abs, Abs, Imp, // $A0
+        Rel, IndY, Imp, Imp, ZpX, ZpX, ZpY, Imp, Imp, AbsY, Imp, Imp, AbsX, AbsX, AbsY, Imp, // $B0
+        Imm, IndX, Imp, Imp, Zp, Zp, Zp, Imp, Imp, Imm, Imp, Imp, Abs, Abs, Abs, Imp, // $C0
+        Rel, IndY, Imp, Imp, Imp, ZpX, ZpX, Imp, Imp, AbsY, Imp, Imp, Imp, AbsX, AbsX, Imp, // $D0
+        Imm, IndX, Imp, Imp, Zp, Zp, Zp, Imp, Imp, Imm, Imp, Imp, Abs, Abs, Abs, Imp, // $E0
+        Rel, IndY, Imp, Imp, Imp, ZpX, ZpX, Imp, Imp, AbsY, Imp, Imp, Imp, AbsX, AbsX, Imp, // $F0
+    };
+    return Modes[Opcode];
+}
@@ -0,0 +1,67 @@
+#include "main_6502.h"
+#include <memory>
+
+namespace
+{
+    cpu6502::Word Pack(cpu6502::u32 Result, bool C, bool Z, bool V, bool N)
+    {
+        return static_cast<cpu6502::Word>((Result & 0xFF) | (C << 8) | (Z << 9) | (V << 14) | (N << 15));
+    }
+}
+
+cpu6502::Word cpu6502::DecimalTables::AddBranchy(Byte A, Byte Operand, Byte Carry)
+{
+    // NMOS: Z comes from the binary sum, N and V from the high digit before
+    // it is adjusted
+    u32 Low = (A & 0x0F) + (Operand & 0x0F) + Carry;
+    if (Low > 0x09)
+        Low += 0x06;
+    u32 High = (A >> 4) + (Operand >> 4) + (Low > 0x0F);
+    bool Z = ((A + Operand + Carry) & 0xFF) == 0;
+    bool N = (High & 0x08) > 0;
+    bool V = (~(A ^ Operand) & (A ^ (High << 4)) & 0x80) > 0;
+    if (High > 0x09)
+        High += 0x06;
+    bool C = High > 0x0F;
+    return Pack((High << 4) | (Low & 0x0F), C, Z, V, N);
+}
+
+cpu6502::Word cpu6502::DecimalTables::SubtractBranchy(Byte A, Byte Operand, Byte Carry)
+{
+    // NMOS: flags as in binary mode, only A is adjusted
+    const u32 Borrow = 1 - Carry;
+    u32 Difference = A - Operand - Borrow;
+    u32 Low = (A & 0x0F) - (Operand & 0x0F) - Borrow;
+    u32 High = (A >> 4) - (Operand >> 4);
+    if (Low & 0x10)
+    {
+        Low -= 0x06;
+        High--;
+    }
+    if (High & 0x10)
+        High -= 0x06;
+    return Pack((High << 4) | (Low & 0x0F), Difference < 0x100, (Difference & 0xFF) == 0,
+                ((A ^ Operand) & (A ^ Difference) & 0x80) > 0, (Difference & 0x80) > 0);
+}
+
+const cpu6502::DecimalTables &cpu6502::DecimalTables::Get()
+{
+    // 512K, kept off the stack and built once
+    static const std::unique_ptr<DecimalTables> Tables = [] {
+        auto Built = std::make_unique<DecimalTables>();
+        for (u32 Carry = 0; Carry < 2; Carry++)
+        {
+            for (u32 A = 0; A < 256; A++)
+            {
+                for (u32 Operand = 0; Operand < 256; Operand++)
+                {
+                    u32 i = Index(Byte(A), Byte(Operand), Byte(Carry));
+                    Built->Add[i] = AddBranchy(Byte(A), Byte(Operand), Byte(Carry));
+                    Built->Subtract[i] = SubtractBranchy(Byte(A), Byte(Operand), Byte(Carry));
+                }
+            }
+        }
+        return Built;
+    }();
+    return *Tables;
+}
@@ -0,0 +1,223 @@
+#include "diff_6502.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#define CPU6502_SSE2 1
+#endif
+#if defined(CPU6502_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define CPU6502_AVX2 1
+#endif
+
+namespace
+{
+    using namespace cpu6502;
+
+    // Bit i of Mask[i / 64] set where A[i] != B[i], for one 256 byte page
+    using MaskFunction = void (*)(const Byte *A, const Byte *B, u64 Mask[4]);
+
+#if !defined(CPU6502_SSE2)
+    void MaskScalar(const Byte *A, const Byte *B, u64 Mask[4])
+    {
+        for (u32 Part = 0; Part < 4; Part++)
+        {
+            u64 Bits = 0;
+            for (u32 i = 0; i < 64; i++)
+            {
+                Bits |= u64(A[Part * 64 + i] != B[Part * 64 + i]) << i;
+            }
+            Mask[Part] = Bits;
+        }
+    }
+#endif
+
+#if defined(CPU6502_SSE2)
+    void MaskSSE2(const Byte *A, const Byte *B, u64 Mask[4])
+    {
+        for (u32 Part = 0; Part < 4; Part++)
+        {
+            u64 Bits = 0;
+            for (u32 i = 0; i < 4; i++)
+            {
+                const u32 At = Part * 64 + i * 16;
+                __m128i Left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(A + At));
+                __m128i Right = _mm_loadu_si128(reinterpret_cast<const __m128i *>(B + At));
+                u32 Same = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(Left, Right)));
+                Bits |= u64(~Same & 0xFFFF) << (i * 16);
+            }
+            Mask[Part] = Bits;
+        }
+    }
+#endif
+
+#if defined(CPU6502_AVX2)
+    __attribute__((target("avx2"))) void MaskAVX2(const Byte *A, const Byte *B, u64 Mask[4])
+    {
+        for (u32 Part = 0; Part < 4; Part++)
+        {
+            u64 Bits = 0;
+            for (u32 i = 0; i < 2; i++)
+            {
+                const u32 At = Part * 64 + i * 32;
+                __m256i Left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(A + At));
+                __m256i Right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(B + At));
+                u32 Same = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Left, Right)));
+                Bits |= u64(~Same) << (i * 32);
+            }
+            Mask[Part] = Bits;
+        }
+    }
+#endif
+
+    MaskFunction PickMask()
+    {
+#if defined(CPU6502_AVX2)
+        if (__builtin_cpu_supports("avx2"))
+            return MaskAVX2;
+#endif
+#if defined(CPU6502_SSE2)
+        return MaskSSE2;
+#else
+        return MaskScalar;
+#endif
+    }
+
+    const MaskFunction DifferenceMask = PickMask();
+
+    u32 TrailingZeros(u64 Bits)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<u32>(__builtin_ctzll(Bits));
+#else
+        u32 Count = 0;
+        while (!(Bits & 1))
+        {
+            Bits >>= 1;
+            Count++;
+        }
+        return Count;
+#endif
+    }
+
+    // Appends the runs of set bits in Mask, extending Ranges.back() when
+    // Open says the previous page ended inside a run
+    void AddRuns(u32 Page, const u64 Mask[4], std::vector<MemRange> &Ranges, bool &Open)
+    {
+        for (u32 Part = 0; Part < 4; Part++)
+        {
+            const u64 Bits = Mask[Part];
+            u32 Position = 0;
+            while (Position < 64)
+            {
+                const u64 Rest = Bits >> Position;
+                if (Open)
+                {
+                    u32 Ones = ~Rest ? TrailingZeros(~Rest) : 64 - Position;
+                    Ones = Ones < 64 - Position ? Ones : 64 - Position;
+                    Ranges.back().Length += Ones;
+                    Position += Ones;
+                    if (Position < 64)
+                        Open = false;
+                }
+                else
+                {
+                    if (!Rest)
+                        break;
+                    Position += TrailingZeros(Rest);
+                    Ranges.push_back({static_cast<Word>(Page * 256 + Part * 64 + Position), 0});
+                    Open = true;
+                }
+            }
+        }
+    }
+}
+
+std::vector<cpu6502::MemRange> cpu6502::DiffMemory(const Mem &A, const Mem &B, u32 SinceA, u32 SinceB)
+{
+    std::vector<MemRange> Ranges;
+    bool Open = false;
+    for (u32 Page = 0; Page < Mem::NUM_PAGES; Page++)
+    {
+        if (!A.WrittenSince(Page, SinceA) && !B.WrittenSince(Page, SinceB))
+        {
+            Open = false;
+            continue;
+        }
+        u64 Mask[4];
+        DifferenceMask(&A.Data[Page * 256], &B.Data[Page * 256], Mask);
+        if (!(Mask[0] | Mask[1] | Mask[2] | Mask[3]))
+        {
+            Open = false;
+            continue;
+        }
+        AddRuns(Page, Mask, Ranges, Open);
+    }
+    return Ranges;
+}
+
+cpu6502::StateDiff cpu6502::CompareState(const CPU &CpuA, const Mem &MemA, const CPU &CpuB, const Mem &MemB,
+                                         u32 SinceA, u32 SinceB)
+{
+    StateDiff Result;
+    // Reset leaves the unused status bit as it was, it never means anything
+    const Byte UnusedBit = 0x20;
+    Result.Registers = (CpuA.PC != CpuB.PC ? StateDiff::PC : 0) | (CpuA.SP != CpuB.SP ? StateDiff::SP : 0) |
+                       (CpuA.A != CpuB.A ? StateDiff::A : 0) | (CpuA.X != CpuB.X ? StateDiff::X : 0) |
+                       (CpuA.Y != CpuB.Y ? StateDiff::Y : 0) | ((CpuA.PS ^ CpuB.PS) & ~UnusedBit ? StateDiff::PS : 0) |
+                       (CpuA.CycleCount != CpuB.CycleCount ? StateDiff::CYCLES : 0) |
+                       (CpuA.IRQLines != CpuB.IRQLines || CpuA.NMIPending != CpuB.NMIPending ? StateDiff::INTERRUPTS : 0);
+    Result.Memory = DiffMemory(MemA, MemB, SinceA, SinceB);
+    return Result;
+}
+
+std::string cpu6502::StateDiff::Describe(const CPU &CpuA, const Mem &MemA, const CPU &CpuB, const Mem &MemB) const
+{
+    std::string Text;
+    char Line[128];
+    const struct
+    {
+        u32 Bit;
+        const char *Name;
+        unsigned long long Left, Right;
+        int Digits;
+    } Fields[] = {{PC, "PC", CpuA.PC, CpuB.PC, 4},
+                  {SP, "SP", CpuA.SP, CpuB.SP, 2},
+                  {A, "A", CpuA.A, CpuB.A, 2},
+                  {X, "X", CpuA.X, CpuB.X, 2},
+                  {Y, "Y", CpuA.Y, CpuB.Y, 2},
+                  {PS, "P", CpuA.PS, CpuB.PS, 2},
+                  {CYCLES, "cycles", CpuA.CycleCount, CpuB.CycleCount, 0},
+                  {INTERRUPTS, "IRQ lines", 0, 0, 0}};
+    for (const auto &Field : Fields)
+    {
+        if (!(Registers & Field.Bit))
+            continue;
+        if (Field.Digits)
+            snprintf(Line, sizeof(Line), "%s $%0*llX / $%0*llX\n", Field.Name, Field.Digits, Field.Left,
+                     Field.Digits, Field.Right);
+        else if (Field.Bit == INTERRUPTS)
+            snprintf(Line, sizeof(Line), "%s $%X%s / $%X%s\n", Field.Name, CpuA.IRQLines, CpuA.NMIPending ? " NMI" : "",
+                     CpuB.IRQLines, CpuB.NMIPending ? " NMI" : "");
+        else
+            snprintf(Line, sizeof(Line), "%s %llu / %llu\n", Field.Name, Field.Left, Field.Right);
+        Text += Line;
+    }
+
+    // The first 8 bytes of each range are shown
+    for (const MemRange &Range : Memory)
+    {
+        snprintf(Line, sizeof(Line), "$%04X-$%04X %u bytes:", Range.Address, Range.Address + Range.Length - 1,
+                 Range.Length);
+        Text += Line;
+        const u32 Shown = Range.Length < 8 ? Range.Length : 8;
+        for (const Mem *Side : {&MemA, &MemB})
+        {
+            for (u32 i = 0; i < Shown; i++)
+            {
+                snprintf(Line, sizeof(Line), " %02X", (*Side)[Range.Address + i]);
+                Text += Line;
+            }
+            Text += Side == &MemA ? " /" : (Shown < Range.Length ? " ...\n" : "\n");
+        }
+    }
+    return Text;
+}
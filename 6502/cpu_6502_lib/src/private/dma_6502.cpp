@@ -0,0 +1,22 @@
+#include "dma_6502.h"
+
+void cpu6502::DMA::Start(Byte Page, u64 Cycle)
+{
+    const u32 Source = Page * PAGE_SIZE;
+    Byte Buffer[PAGE_SIZE];
+    const Byte *Data = &memory.Data[Source];
+    if (Device *IO = memory.IO[Page])
+    {
+        for (u32 i = 0; i < PAGE_SIZE; i++)
+        {
+            Buffer[i] = IO->Read(static_cast<Word>(Source + i), Cycle);
+        }
+        Data = Buffer;
+    }
+
+    // Splits at page owners and marks RAM pages written
+    memory.WriteBlock(Target, Data, PAGE_SIZE, MemView::Bus, Cycle);
+
+    Transfers++;
+    cpu.Stall(STALL_CYCLES + (Cycle & 1));
+}
@@ -0,0 +1,86 @@
+#include "fork_6502.h"
+#include <string.h>
+
+namespace
+{
+    using cpu6502::Byte;
+
+    bool AllZero(const Byte *Data)
+    {
+        static const Byte Zeros[256] = {};
+        return memcmp(Data, Zeros, 256) == 0;
+    }
+}
+
+cpu6502::Machine cpu6502::Machine::Capture(const CPU &State, const Mem &memory)
+{
+    Machine Result;
+    Result.cpu = State;
+    for (u32 Page = 0; Page < Mem::NUM_PAGES; Page++)
+    {
+        const Byte *Data = &memory.Data[Page * 256];
+        if (AllZero(Data))
+            continue;
+        auto Copy = std::make_shared<Machine::Page>();
+        memcpy(Copy->Bytes, Data, 256);
+        Result.Pages[Page] = std::move(Copy);
+    }
+    return Result;
+}
+
+cpu6502::u32 cpu6502::Machine::PagesNotSharedWith(const Machine &Other) const
+{
+    u32 Count = 0;
+    for (u32 Page = 0; Page < Mem::NUM_PAGES; Page++)
+    {
+        Count += Pages[Page] != Other.Pages[Page];
+    }
+    return Count;
+}
+
+cpu6502::ForkRunner::ForkRunner()
+{
+    // Zeros, as a Machine's null pages
+    memory.Init();
+    Since = memory.Checkpoint();
+}
+
+void cpu6502::ForkRunner::Load(const Machine &Target)
+{
+    for (u32 Page = 0; Page < Mem::NUM_PAGES; Page++)
+    {
+        const std::shared_ptr<const Machine::Page> &Wanted = Target.Pages[Page];
+        // Still the same page object and not written since: nothing to do
+        if (Loaded[Page] == Wanted && !memory.WrittenSince(Page, Since))
+            continue;
+        if (Wanted)
+            memcpy(&memory.Data[Page * 256], Wanted->Bytes, 256);
+        else
+            memset(&memory.Data[Page * 256], 0, 256);
+        Loaded[Page] = Wanted;
+        PagesCopied++;
+    }
+    Since = memory.Checkpoint();
+}
+
+void cpu6502::ForkRunner::Store(Machine &Target)
+{
+    for (u32 Page = 0; Page < Mem::NUM_PAGES; Page++)
+    {
+        if (!memory.WrittenSince(Page, Since))
+            continue;
+        auto Copy = std::make_shared<Machine::Page>();
+        memcpy(Copy->Bytes, &memory.Data[Page * 256], 256);
+        Target.Pages[Page] = std::move(Copy);
+        Loaded[Page] = Target.Pages[Page];
+    }
+    Since = memory.Checkpoint();
+}
+
+cpu6502::ExecuteResult cpu6502::ForkRunner::Run(Machine &Target, s32 Cycles)
+{
+    Load(Target);
+    ExecuteResult Result = Target.cpu.Execute(Cycles, memory);
+    Store(Target);
+    return Result;
+}
@@ -0,0 +1,188 @@
+#include "framebuffer_6502.h"
+#include <string.h>
+
+namespace
+{
+    using cpu6502::u64;
+
+    u64 Mix(u64 Value)
+    {
+        Value ^= Value >> 33;
+        Value *= 0xFF51AFD7ED558CCDull;
+        Value ^= Value >> 33;
+        Value *= 0xC4CEB9FE1A85EC53ull;
+        return Value ^ (Value >> 33);
+    }
+
+    int LowestBit(u64 Bits)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(Bits);
+#else
+        int Bit = 0;
+        while (!(Bits & 1))
+        {
+            Bits >>= 1;
+            Bit++;
+        }
+        return Bit;
+#endif
+    }
+}
+
+cpu6502::Framebuffer::Framebuffer(Scheduler &Clock, Word Start, u32 Columns, u32 Rows, u32 Period)
+    : Base(Start), Width(Columns), Height(Rows), FrameCycles(Period), Events(Clock),
+      TilesX((Columns + TILE - 1) / TILE), TilesY((Rows + TILE - 1) / TILE), Pixels(Columns * Rows, 0),
+      Dirty((TilesX * TilesY + 63) / 64, ~0ull), Rehash(Dirty), TileHashes(TilesX * TilesY, 0)
+{
+    // Bits past the last tile stay clear
+    if (u32 Spare = (TilesX * TilesY) % 64)
+        Dirty.back() = Rehash.back() = (1ull << Spare) - 1;
+    Pending = Events.Schedule(FrameCycles, [this](u64 Due) { VBlank(Due); });
+}
+
+cpu6502::Framebuffer::~Framebuffer()
+{
+    if (Pending)
+        Events.Cancel(Pending);
+}
+
+cpu6502::Byte cpu6502::Framebuffer::Read(Word Address, u64 /*Cycle*/)
+{
+    u32 Offset = static_cast<Word>(Address - Base);
+    return Offset < Pixels.size() ? Pixels[Offset] : 0xFF;
+}
+
+void cpu6502::Framebuffer::Touch(u32 Offset)
+{
+    u32 Tile = (Offset / Width / TILE) * TilesX + (Offset % Width) / TILE;
+    Dirty[Tile / 64] |= 1ull << (Tile % 64);
+    Rehash[Tile / 64] |= 1ull << (Tile % 64);
+}
+
+void cpu6502::Framebuffer::Write(Word Address, Byte Value, u64 /*Cycle*/)
+{
+    u32 Offset = static_cast<Word>(Address - Base);
+    if (Offset >= Pixels.size() || Pixels[Offset] == Value)
+        return;
+    Pixels[Offset] = Value;
+    Touch(Offset);
+}
+
+void cpu6502::Framebuffer::WriteBlock(Word Address, const Byte *Data, u32 Count, u64 /*Cycle*/)
+{
+    u32 Offset = static_cast<Word>(Address - Base);
+    if (Offset >= Pixels.size())
+        return;
+    if (Count > Pixels.size() - Offset)
+        Count = static_cast<u32>(Pixels.size() - Offset);
+    if (memcmp(&Pixels[Offset], Data, Count) == 0)
+        return;
+    memcpy(&Pixels[Offset], Data, Count);
+    // One pixel per tile and row is enough to mark each tile passed. Tiles
+    // line up with columns, rows start mid tile when Width is not a multiple
+    // of TILE, so every run also stops at the end of its row.
+    for (u32 i = 0; i < Count;)
+    {
+        u32 Column = (Offset + i) % Width;
+        u32 Run = TILE - Column % TILE;
+        Touch(Offset + i);
+        i += Run < Width - Column ? Run : Width - Column;
+    }
+}
+
+cpu6502::u64 cpu6502::Framebuffer::HashTile(u32 Tile) const
+{
+    u32 X = (Tile % TilesX) * TILE, Y = (Tile / TilesX) * TILE;
+    // Edge tiles may be narrower / shorter than TILE
+    u32 Columns = Width - X < TILE ? Width - X : TILE;
+    u32 Rows = Height - Y < TILE ? Height - Y : TILE;
+    const Byte *Row = &Pixels[Y * Width + X];
+    u64 Value = Mix(Tile + 1);
+    for (u32 y = 0; y < Rows; y++, Row += Width)
+    {
+        u64 Bytes = 0;
+        memcpy(&Bytes, Row, Columns);
+        Value = (Value ^ Bytes) * 0x9E3779B97F4A7C15ull;
+        Value ^= Value >> 29;
+    }
+    return Mix(Value);
+}
+
+void cpu6502::Framebuffer::VBlank(u64 Cycle)
+{
+    Pending = Events.Schedule(Cycle + FrameCycles, [this](u64 Due) { VBlank(Due); });
+    Frames++;
+
+    // The screen hash is the XOR of the tile hashes, swap out the changed ones
+    for (u32 Index = 0; Index < Rehash.size(); Index++)
+    {
+        for (u64 Bits = Rehash[Index]; Bits; Bits &= Bits - 1)
+        {
+            u32 Tile = Index * 64 + LowestBit(Bits);
+            u64 Updated = HashTile(Tile);
+            Hash ^= TileHashes[Tile] ^ Updated;
+            TileHashes[Tile] = Updated;
+        }
+        Rehash[Index] = 0;
+    }
+
+    if (!Output.CanPush())
+    {
+        DroppedFrames++;
+        return;
+    }
+
+    Frame Image;
+    Image.Number = Frames;
+    Image.Cycle = Cycle;
+    Image.Hash = Hash;
+    u32 Left = TilesX, Top = TilesY, Right = 0, Bottom = 0;
+    for (u32 Index = 0; Index < Dirty.size(); Index++)
+    {
+        for (u64 Bits = Dirty[Index]; Bits; Bits &= Bits - 1)
+        {
+            u32 Tile = Index * 64 + LowestBit(Bits);
+            u32 X = Tile % TilesX, Y = Tile / TilesX;
+            Left = X < Left ? X : Left;
+            Right = X + 1 > Right ? X + 1 : Right;
+            Top = Y < Top ? Y : Top;
+            Bottom = Y + 1;
+        }
+        Dirty[Index] = 0;
+    }
+    if (Right)
+    {
+        Image.X = Left * TILE;
+        Image.Y = Top * TILE;
+        Image.Width = (Right * TILE < Width ? Right * TILE : Width) - Image.X;
+        Image.Height = (Bottom * TILE < Height ? Bottom * TILE : Height) - Image.Y;
+        Image.Pixels.resize(Image.Width * Image.Height);
+        for (u32 y = 0; y < Image.Height; y++)
+        {
+            memcpy(&Image.Pixels[y * Image.Width], &Pixels[(Image.Y + y) * Width + Image.X], Image.Width);
+        }
+    }
+    Output.Push(std::move(Image));
+}
+
+bool cpu6502::Framebuffer::WritePPM(FILE *File, const Frame &Image, const u32 *Palette)
+{
+    if (Image.Width == 0)
+        return false;
+    fprintf(File, "P6\n%u %u\n255\n", Image.Width, Image.Height);
+    std::vector<Byte> Row(Image.Width * 3);
+    for (u32 y = 0; y < Image.Height; y++)
+    {
+        for (u32 x = 0; x < Image.Width; x++)
+        {
+            Byte Index = Image.Pixels[y * Image.Width + x];
+            u32 Colour = Palette ? Palette[Index] : Index * 0x010101u;
+            Row[x * 3 + 0] = static_cast<Byte>(Colour >> 16);
+            Row[x * 3 + 1] = static_cast<Byte>(Colour >> 8);
+            Row[x * 3 + 2] = static_cast<Byte>(Colour);
+        }
+        fwrite(Row.data(), 1, Row.size(), File);
+    }
+    return true;
+}
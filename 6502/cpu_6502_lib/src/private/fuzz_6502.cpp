@@ -0,0 +1,66 @@
+#include "fuzz_6502.h"
+#include <string.h>
+
+void cpu6502::FuzzTarget::Snapshot()
+{
+    Start = cpu;
+    memcpy(Pristine, memory.Data, Mem::MAX_MEM);
+    Since = memory.Checkpoint();
+}
+
+void cpu6502::FuzzTarget::Restore()
+{
+    for (u32 Page = 0; Page < Mem::NUM_PAGES; Page++)
+    {
+        if (!memory.WrittenSince(Page, Since))
+            continue;
+        memcpy(&memory.Data[Page * 256], &Pristine[Page * 256], 256);
+        PagesRestored++;
+    }
+    Since = memory.Checkpoint();
+}
+
+cpu6502::FuzzTarget::Outcome cpu6502::FuzzTarget::Run(const Byte *Data, size_t Size)
+{
+    Restore();
+    cpu = Start;
+    cpu.Coverage = Map;
+
+    u32 Length = Size < Config.MaxInput ? static_cast<u32>(Size) : Config.MaxInput;
+    if (Length)
+        memory.WriteBlock(Config.InputAddress, Data, Length);
+    if (Config.LengthAddress != NO_LENGTH)
+    {
+        const Byte LengthBytes[2] = {static_cast<Byte>(Length), static_cast<Byte>(Length >> 8)};
+        memory.WriteBlock(static_cast<Word>(Config.LengthAddress), LengthBytes, 2);
+    }
+
+    Last = cpu.Execute(Config.CycleLimit, memory);
+    Runs++;
+    switch (Last.Reason)
+    {
+    case StopReason::HostCall:
+    case StopReason::Breakpoint:
+        return Outcome::Finished;
+    case StopReason::BudgetExhausted:
+        return Outcome::Timeout;
+    default:
+        return Outcome::Crashed;
+    }
+}
+
+void cpu6502::FuzzTarget::ClearCoverage()
+{
+    if (Map)
+        memset(Map, 0, CPU::COVERAGE_SIZE);
+}
+
+cpu6502::u32 cpu6502::FuzzTarget::EdgesHit() const
+{
+    u32 Count = 0;
+    for (u32 i = 0; Map && i < CPU::COVERAGE_SIZE; i++)
+    {
+        Count += Map[i] != 0;
+    }
+    return Count;
+}
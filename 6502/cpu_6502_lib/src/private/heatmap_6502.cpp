@@ -0,0 +1,131 @@
+#include "heatmap_6502.h"
+#include <algorithm>
+#include <cmath>
+
+cpu6502::MemoryHeatmap::MemoryHeatmap(bool PerByteCounters) : PerByte(PerByteCounters)
+{
+    Clear();
+}
+
+void cpu6502::MemoryHeatmap::Clear()
+{
+    std::fill(std::begin(PageReads), std::end(PageReads), 0);
+    std::fill(std::begin(PageWrites), std::end(PageWrites), 0);
+    std::fill(std::begin(PageExecutes), std::end(PageExecutes), 0);
+    if (PerByte)
+    {
+        ByteReads.assign(Mem::MAX_MEM, 0);
+        ByteWrites.assign(Mem::MAX_MEM, 0);
+        ByteExecutes.assign(Mem::MAX_MEM, 0);
+    }
+}
+
+void cpu6502::MemoryHeatmap::OnInstruction(const CPU & /*cpu*/, Word PC, Byte /*Opcode*/, u64 /*Cycle*/)
+{
+    PageExecutes[PC >> 8]++;
+    if (PerByte)
+        ByteExecutes[PC]++;
+}
+
+void cpu6502::MemoryHeatmap::OnRead(Word Address, Byte /*Value*/, u64 /*Cycle*/)
+{
+    PageReads[Address >> 8]++;
+    if (PerByte)
+        ByteReads[Address]++;
+}
+
+void cpu6502::MemoryHeatmap::OnWrite(Word Address, Byte /*Value*/, u64 /*Cycle*/)
+{
+    PageWrites[Address >> 8]++;
+    if (PerByte)
+        ByteWrites[Address]++;
+}
+
+cpu6502::u64 cpu6502::MemoryHeatmap::Cell(u32 Row, u32 Column, HeatmapKind Kind) const
+{
+    if (PerByte)
+    {
+        u32 Address = (Row << 8) | Column;
+        switch (Kind)
+        {
+        case HeatmapKind::Reads:
+            return ByteReads[Address];
+        case HeatmapKind::Writes:
+            return ByteWrites[Address];
+        case HeatmapKind::Executes:
+            return ByteExecutes[Address];
+        default:
+            return u64(ByteReads[Address]) + ByteWrites[Address] + ByteExecutes[Address];
+        }
+    }
+
+    u32 Page = (Row / 16) * 16 + (Column / 16);
+    switch (Kind)
+    {
+    case HeatmapKind::Reads:
+        return PageReads[Page];
+    case HeatmapKind::Writes:
+        return PageWrites[Page];
+    case HeatmapKind::Executes:
+        return PageExecutes[Page];
+    default:
+        return PageReads[Page] + PageWrites[Page] + PageExecutes[Page];
+    }
+}
+
+bool cpu6502::MemoryHeatmap::WritePPM(const char *Path) const
+{
+    FILE *File = fopen(Path, "wb");
+    if (!File)
+        return false;
+
+    // One channel per kind, log scaled against that channel's maximum
+    const HeatmapKind Channels[3] = {HeatmapKind::Writes, HeatmapKind::Reads, HeatmapKind::Executes};
+    double Scale[3];
+    for (u32 c = 0; c < 3; c++)
+    {
+        u64 Max = 0;
+        for (u32 Row = 0; Row < IMAGE_SIZE; Row++)
+        {
+            for (u32 Column = 0; Column < IMAGE_SIZE; Column++)
+            {
+                Max = std::max(Max, Cell(Row, Column, Channels[c]));
+            }
+        }
+        Scale[c] = Max ? 255.0 / std::log1p(double(Max)) : 0.0;
+    }
+
+    fprintf(File, "P6\n%u %u\n255\n", IMAGE_SIZE, IMAGE_SIZE);
+    std::vector<Byte> Pixels;
+    Pixels.reserve(IMAGE_SIZE * IMAGE_SIZE * 3);
+    for (u32 Row = 0; Row < IMAGE_SIZE; Row++)
+    {
+        for (u32 Column = 0; Column < IMAGE_SIZE; Column++)
+        {
+            for (u32 c = 0; c < 3; c++)
+            {
+                double Value = std::log1p(double(Cell(Row, Column, Channels[c]))) * Scale[c];
+                Pixels.push_back(static_cast<Byte>(std::lround(Value)));
+            }
+        }
+    }
+    bool Ok = fwrite(Pixels.data(), 1, Pixels.size(), File) == Pixels.size();
+    return (fclose(File) == 0) && Ok;
+}
+
+bool cpu6502::MemoryHeatmap::WriteCSV(const char *Path, HeatmapKind Kind) const
+{
+    FILE *File = fopen(Path, "w");
+    if (!File)
+        return false;
+
+    for (u32 Row = 0; Row < IMAGE_SIZE; Row++)
+    {
+        for (u32 Column = 0; Column < IMAGE_SIZE; Column++)
+        {
+            fprintf(File, Column ? ",%llu" : "%llu", Cell(Row, Column, Kind));
+        }
+        fputc('\n', File);
+    }
+    return fclose(File) == 0;
+}
@@ -0,0 +1,98 @@
+#include "main_6502.h"
+
+namespace
+{
+    // Longest loop body worth looking at, polling loops are a handful of bytes
+    constexpr cpu6502::u32 MAX_IDLE_LOOP_BYTES = 32;
+
+    // Instructions that only read memory and change registers / flags
+    bool IsPure(cpu6502::Byte Opcode)
+    {
+        using C = cpu6502::CPU;
+        switch (Opcode)
+        {
+        case C::INS_LDA_IM: case C::INS_LDA_ZEROP: case C::INS_LDA_ZEROP_X: case C::INS_LDA_ABS:
+        case C::INS_LDA_ABS_X: case C::INS_LDA_ABS_Y: case C::INS_LDA_IND_X: case C::INS_LDA_IND_Y:
+        case C::INS_LDX_IM: case C::INS_LDX_ZEROP: case C::INS_LDX_ZEROP_Y: case C::INS_LDX_ABS:
+        case C::INS_LDX_ABS_Y:
+        case C::INS_LDY_IM: case C::INS_LDY_ZEROP: case C::INS_LDY_ZEROP_X: case C::INS_LDY_ABS:
+        case C::INS_LDY_ABS_X:
+        case C::INS_AND_IM: case C::INS_AND_ZERO_P: case C::INS_AND_ZERO_PX: case C::INS_AND_ABS:
+        case C::INS_AND_ABS_X: case C::INS_AND_ABS_Y: case C::INS_AND_IND_X: case C::INS_AND_IND_Y:
+        case C::INS_EOR_IM: case C::INS_EOR_ZERO_P: case C::INS_EOR_ZERO_PX: case C::INS_EOR_ABS:
+        case C::INS_EOR_ABS_X: case C::INS_EOR_ABS_Y: case C::INS_EOR_IND_X: case C::INS_EOR_IND_Y:
+        case C::INS_ORA_IM: case C::INS_ORA_ZERO_P: case C::INS_ORA_ZERO_PX: case C::INS_ORA_ABS:
+        case C::INS_ORA_ABS_X: case C::INS_ORA_ABS_Y: case C::INS_ORA_IND_X: case C::INS_ORA_IND_Y:
+        case C::INS_ADC_IM: case C::INS_ADC_ZERO_P: case C::INS_ADC_ZERO_PX: case C::INS_ADC_ABS:
+        case C::INS_ADC_ABS_X: case C::INS_ADC_ABS_Y: case C::INS_ADC_IND_X: case C::INS_ADC_IND_Y:
+        case C::INS_SBC_IM: case C::INS_SBC_ZERO_P: case C::INS_SBC_ZERO_PX: case C::INS_SBC_ABS:
+        case C::INS_SBC_ABS_X: case C::INS_SBC_ABS_Y: case C::INS_SBC_IND_X: case C::INS_SBC_IND_Y:
+        case C::INS_CMP_IM: case C::INS_CMP_ZERO_P: case C::INS_CMP_ZERO_PX: case C::INS_CMP_ABS:
+        case C::INS_CMP_ABS_X: case C::INS_CMP_ABS_Y: case C::INS_CMP_IND_X: case C::INS_CMP_IND_Y:
+        case C::INS_CPX_IM: case C::INS_CPX_ZERO_P: case C::INS_CPX_ABS:
+        case C::INS_CPY_IM: case C::INS_CPY_ZERO_P: case C::INS_CPY_ABS:
+        case C::INS_BIT_ZERO_P: case C::INS_BIT_ABS:
+        case C::INS_TAX: case C::INS_TAY: case C::INS_TXA: case C::INS_TYA: case C::INS_TSX: case C::INS_TXS:
+        case C::INS_INX: case C::INS_INY: case C::INS_DEX: case C::INS_DEY:
+        case C::INS_ASL: case C::INS_LSR: case C::INS_ROL: case C::INS_ROR:
+        case C::INS_CLC: case C::INS_CLD: case C::INS_CLI: case C::INS_CLV:
+        case C::INS_SEC: case C::INS_SED: case C::INS_SEI:
+        case C::INS_NOP:
+        case C::INS_BCC: case C::INS_BCS: case C::INS_BEQ: case C::INS_BMI:
+        case C::INS_BNE: case C::INS_BPL: case C::INS_BVC: case C::INS_BVS:
+        case C::INS_JMP_ABS:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    cpu6502::u32 LengthOf(cpu6502::AddressingMode Mode)
+    {
+        using M = cpu6502::AddressingMode;
+        switch (Mode)
+        {
+        case M::Implied:
+        case M::Accumulator:
+            return 1;
+        case M::Absolute:
+        case M::AbsoluteX:
+        case M::AbsoluteY:
+        case M::Indirect:
+            return 3;
+        default:
+            return 2;
+        }
+    }
+}
+
+bool cpu6502::CPU::IsIdleLoop(const Mem &memory, Word Head, Word Tail)
+{
+    if (Tail < Head || u32(Tail - Head) >= MAX_IDLE_LOOP_BYTES)
+        return false;
+
+    u32 Address = Head;
+    while (Address <= Tail)
+    {
+        Byte Opcode = memory[Address];
+        if (!IsPure(Opcode))
+            return false;
+
+        AddressingMode Mode = AddressingModeOf(Opcode);
+        u32 Length = LengthOf(Mode);
+        u32 Target = Address + Length;
+        if (Mode == AddressingMode::Relative)
+            Target = (Address + 2 + static_cast<SByte>(memory[(Address + 1) & 0xFFFF])) & 0xFFFF;
+        else if (Opcode == INS_JMP_ABS)
+            Target = memory[(Address + 1) & 0xFFFF] | (memory[(Address + 2) & 0xFFFF] << 8);
+
+        // Every way on must stay inside the loop, only Tail may fall out of it
+        if ((Target < Head || Target > Tail) && Address != Tail)
+            return false;
+        if (Address == Tail)
+            return Target == Head;
+        Address += Length;
+    }
+    // An instruction overlaps Tail
+    return false;
+}
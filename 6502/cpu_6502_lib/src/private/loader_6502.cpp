@@ -0,0 +1,394 @@
+#include "loader_6502.h"
+#include <cctype>
+#include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <stdlib.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+cpu6502::MappedFile::MappedFile(MappedFile &&Other) noexcept
+    : Data(Other.Data), Size(Other.Size), Mapped(Other.Mapped)
+{
+    Other.Data = nullptr;
+    Other.Size = 0;
+}
+
+cpu6502::MappedFile &cpu6502::MappedFile::operator=(MappedFile &&Other) noexcept
+{
+    if (this != &Other)
+    {
+        Close();
+        Data = Other.Data;
+        Size = Other.Size;
+        Mapped = Other.Mapped;
+        Other.Data = nullptr;
+        Other.Size = 0;
+    }
+    return *this;
+}
+
+bool cpu6502::MappedFile::Open(const char *Path)
+{
+    Close();
+#if defined(_WIN32)
+    FILE *File = fopen(Path, "rb");
+    if (!File)
+        return false;
+    fseek(File, 0, SEEK_END);
+    long Length = ftell(File);
+    fseek(File, 0, SEEK_SET);
+    Byte *Buffer = Length > 0 ? static_cast<Byte *>(malloc(Length)) : nullptr;
+    bool Ok = Length >= 0 && (Length == 0 || (Buffer && fread(Buffer, 1, Length, File) == size_t(Length)));
+    fclose(File);
+    if (!Ok)
+    {
+        free(Buffer);
+        return false;
+    }
+    Data = Buffer;
+    Size = size_t(Length);
+    Mapped = false;
+    return true;
+#else
+    int Descriptor = open(Path, O_RDONLY);
+    if (Descriptor < 0)
+        return false;
+    struct stat Info;
+    if (fstat(Descriptor, &Info) != 0)
+    {
+        close(Descriptor);
+        return false;
+    }
+    Size = size_t(Info.st_size);
+    if (Size)
+    {
+        void *Address = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+        if (Address == MAP_FAILED)
+        {
+            close(Descriptor);
+            Size = 0;
+            return false;
+        }
+        Data = static_cast<const Byte *>(Address);
+        Mapped = true;
+    }
+    // The mapping keeps the file alive
+    close(Descriptor);
+    return true;
+#endif
+}
+
+void cpu6502::MappedFile::Close()
+{
+#if defined(_WIN32)
+    free(const_cast<Byte *>(Data));
+#else
+    if (Mapped)
+        munmap(const_cast<Byte *>(Data), Size);
+#endif
+    Data = nullptr;
+    Size = 0;
+    Mapped = false;
+}
+
+namespace
+{
+    using cpu6502::Byte;
+    using cpu6502::u32;
+
+    // Hex digit value, 0xFF for anything else
+    struct HexDigits
+    {
+        Byte Value[256];
+        HexDigits()
+        {
+            memset(Value, 0xFF, sizeof(Value));
+            for (int i = 0; i < 10; i++)
+                Value['0' + i] = static_cast<Byte>(i);
+            for (int i = 0; i < 6; i++)
+                Value['A' + i] = Value['a' + i] = static_cast<Byte>(10 + i);
+        }
+    };
+    const HexDigits Hex;
+
+    // Two hex digits at Text, false when either is not one
+    bool HexByte(const Byte *Text, Byte &Out)
+    {
+        Byte High = Hex.Value[Text[0]], Low = Hex.Value[Text[1]];
+        Out = static_cast<Byte>(High << 4 | Low);
+        return (High | Low) < 0x10;
+    }
+
+    bool HasExtension(const char *Path, const char *Extension)
+    {
+        size_t Length = strlen(Path), ExtensionLength = strlen(Extension);
+        if (Length < ExtensionLength)
+            return false;
+        const char *Tail = Path + Length - ExtensionLength;
+        for (size_t i = 0; i < ExtensionLength; i++)
+        {
+            if (tolower(static_cast<unsigned char>(Tail[i])) != Extension[i])
+                return false;
+        }
+        return true;
+    }
+
+    u32 LittleWord(const Byte *Data) { return Data[0] | Data[1] << 8; }
+
+    const Byte O65Magic[] = {0x01, 0x00, 'o', '6', '5'};
+}
+
+bool cpu6502::ProgramImage::Open(const char *Path, ImageFormat Format, Word RawAddress, std::string *Error)
+{
+    if (!File.Open(Path))
+    {
+        if (Error)
+            *Error = std::string("can't open ") + Path;
+        return false;
+    }
+    if (Format == ImageFormat::Detect)
+    {
+        if (File.Size >= sizeof(O65Magic) && memcmp(File.Data, O65Magic, sizeof(O65Magic)) == 0)
+            Format = ImageFormat::O65;
+        else if (HasExtension(Path, ".hex") || HasExtension(Path, ".ihx"))
+            Format = ImageFormat::IntelHex;
+        else if (HasExtension(Path, ".prg"))
+            Format = ImageFormat::Prg;
+        else
+            Format = ImageFormat::Raw;
+    }
+    return Parse(File.Data, File.Size, Format, RawAddress, Error);
+}
+
+bool cpu6502::ProgramImage::Parse(const Byte *Data, size_t Size, ImageFormat Format, Word RawAddress,
+                                  std::string *Error)
+{
+    Segments.clear();
+    Decoded.clear();
+    HasStart = false;
+    Start = 0;
+
+    std::string Message;
+    bool Ok = false;
+    switch (Format)
+    {
+    case ImageFormat::Raw:
+        Ok = Add(RawAddress, static_cast<u32>(Size), Data, Message);
+        HasStart = Ok;
+        Start = RawAddress;
+        break;
+    case ImageFormat::Prg:
+        Ok = ParsePrg(Data, Size, Message);
+        break;
+    case ImageFormat::IntelHex:
+        Ok = ParseIntelHex(Data, Size, Message);
+        break;
+    case ImageFormat::O65:
+    case ImageFormat::Detect:
+        Ok = ParseO65(Data, Size, Message);
+        break;
+    }
+    if (!Ok)
+    {
+        Segments.clear();
+        HasStart = false;
+        if (Error)
+            *Error = Message;
+    }
+    return Ok;
+}
+
+bool cpu6502::ProgramImage::Add(u32 Address, u32 Size, const Byte *Data, std::string &Error)
+{
+    if (Size > Mem::MAX_MEM || Address + Size > Mem::MAX_MEM)
+    {
+        Error = "segment runs past $FFFF";
+        return false;
+    }
+    if (Size == 0)
+        return true;
+    // Contiguous records (Intel HEX) become one segment
+    if (!Segments.empty())
+    {
+        Segment &Last = Segments.back();
+        if (Data && Last.Data && Last.Address + Last.Size == Address && Last.Data + Last.Size == Data)
+        {
+            Last.Size += Size;
+            return true;
+        }
+    }
+    Segments.push_back({static_cast<Word>(Address), Size, Data});
+    return true;
+}
+
+bool cpu6502::ProgramImage::ParsePrg(const Byte *Data, size_t Size, std::string &Error)
+{
+    if (Size < 2)
+    {
+        Error = "PRG shorter than its load address";
+        return false;
+    }
+    Start = static_cast<Word>(LittleWord(Data));
+    HasStart = true;
+    return Add(Start, static_cast<u32>(Size - 2), Data + 2, Error);
+}
+
+bool cpu6502::ProgramImage::ParseIntelHex(const Byte *Data, size_t Size, std::string &Error)
+{
+    // Never more payload (plus a checksum) than half the text, reserving
+    // it all up front keeps Segments' pointers valid
+    Decoded.reserve(Size / 2 + 1);
+    const Byte *Text = Data, *End = Data + Size;
+    u32 Base = 0;
+    u32 Line = 0;
+    while (Text < End)
+    {
+        if (*Text != ':')
+        {
+            if (*Text == '\n')
+                Line++;
+            Text++;
+            continue;
+        }
+        Line++;
+        Byte Header[4];
+        if (End - Text < 11 || !HexByte(Text + 1, Header[0]) || !HexByte(Text + 3, Header[1]) ||
+            !HexByte(Text + 5, Header[2]) || !HexByte(Text + 7, Header[3]))
+        {
+            Error = "bad record on line " + std::to_string(Line);
+            return false;
+        }
+        const u32 Count = Header[0];
+        if (End - Text < 11 + 2 * Count)
+        {
+            Error = "truncated record on line " + std::to_string(Line);
+            return false;
+        }
+        const Byte *Payload = Text + 9;
+        const size_t First = Decoded.size();
+        Decoded.resize(First + Count + 1); // checksum too, dropped below
+        Byte *Out = &Decoded[First];
+        Byte Sum = Header[0] + Header[1] + Header[2] + Header[3];
+        bool Digits = true;
+        for (u32 i = 0; i <= Count; i++)
+        {
+            Digits &= HexByte(Payload + 2 * i, Out[i]);
+            Sum += Out[i];
+        }
+        Decoded.pop_back();
+        if (!Digits)
+        {
+            Error = "bad digit on line " + std::to_string(Line);
+            return false;
+        }
+        if (Sum != 0)
+        {
+            Error = "checksum mismatch on line " + std::to_string(Line);
+            return false;
+        }
+        Text = Payload + 2 * Count + 2;
+
+        const u32 Offset = Header[1] << 8 | Header[2];
+        const Byte *Bytes = Decoded.data() + First;
+        switch (Header[3])
+        {
+        case 0x00: // data
+            if (!Add(Base + Offset, Count, Bytes, Error))
+                return false;
+            break;
+        case 0x01: // end of file
+            return true;
+        case 0x02: // extended segment address
+        case 0x04: // extended linear address
+            if (Count != 2)
+            {
+                Error = "bad address record on line " + std::to_string(Line);
+                return false;
+            }
+            Base = (Bytes[0] << 8 | Bytes[1]) << (Header[3] == 0x02 ? 4 : 16);
+            Decoded.resize(First);
+            break;
+        case 0x03: // start segment address CS:IP
+        case 0x05: // start linear address
+            if (Count != 4)
+            {
+                Error = "bad start record on line " + std::to_string(Line);
+                return false;
+            }
+            HasStart = true;
+            Start = static_cast<Word>(Bytes[2] << 8 | Bytes[3]);
+            Decoded.resize(First);
+            break;
+        default:
+            Error = "unknown record type on line " + std::to_string(Line);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool cpu6502::ProgramImage::ParseO65(const Byte *Data, size_t Size, std::string &Error)
+{
+    // magic(5) version(1) mode(2) tbase tlen dbase dlen bbase blen zbase zlen stack
+    const size_t HEADER = 26;
+    if (Size < HEADER || memcmp(Data, O65Magic, sizeof(O65Magic)) != 0)
+    {
+        Error = "not an o65 object";
+        return false;
+    }
+    const u32 Mode = LittleWord(Data + 6);
+    if (Mode & 0x2000)
+    {
+        Error = "32 bit o65 objects are not supported";
+        return false;
+    }
+    const u32 TextBase = LittleWord(Data + 8), TextLength = LittleWord(Data + 10);
+    const u32 DataBase = LittleWord(Data + 12), DataLength = LittleWord(Data + 14);
+    const u32 BssBase = LittleWord(Data + 16), BssLength = LittleWord(Data + 18);
+
+    // Header options: length (including itself), type, bytes; 0 ends them
+    size_t Offset = HEADER;
+    for (;;)
+    {
+        if (Offset >= Size)
+        {
+            Error = "truncated o65 header options";
+            return false;
+        }
+        if (Data[Offset] == 0)
+            break;
+        Offset += Data[Offset];
+    }
+    Offset++;
+    if (Size - Offset < size_t(TextLength) + DataLength)
+    {
+        Error = "truncated o65 segments";
+        return false;
+    }
+    Start = static_cast<Word>(TextBase);
+    HasStart = true;
+    return Add(TextBase, TextLength, Data + Offset, Error) &&
+           Add(DataBase, DataLength, Data + Offset + TextLength, Error) && Add(BssBase, BssLength, nullptr, Error);
+}
+
+void cpu6502::ProgramImage::CopyTo(Mem &memory) const
+{
+    for (const Segment &Part : Segments)
+    {
+        if (Part.Data)
+            memory.WriteBlock(Part.Address, Part.Data, Part.Size);
+        else
+            memory.Fill(Part.Address, 0, Part.Size);
+    }
+}
+
+void cpu6502::ProgramImage::Load(CPU &cpu, Mem &memory) const
+{
+    cpu.Reset(memory, HasStart ? Start : 0);
+    CopyTo(memory);
+}
@@ -1 +1,136 @@
 #include "main_6502.h"
+#include <string.h>
+
+namespace
+{
+    using namespace cpu6502;
+
+    // Splits Address..Address+Count into runs that neither wrap nor, in the
+    // Bus view, cross from one page owner to another, and hands each to
+    // Run(Address, Offset, Length, Device or nullptr)
+    template <typename Function>
+    void ForEachRun(const Mem &memory, Word Address, u32 Count, MemView View, Function Run)
+    {
+        assert(Count <= Mem::MAX_MEM);
+        for (u32 Offset = 0; Offset < Count;)
+        {
+            u32 At = (Address + Offset) & 0xFFFF;
+            u32 Length = Count - Offset < Mem::MAX_MEM - At ? Count - Offset : Mem::MAX_MEM - At;
+            Device *IO = nullptr;
+            if (View == MemView::Bus)
+            {
+                IO = memory.IO[At >> 8];
+                u32 End = (At & ~0xFFu) + 256;
+                while (End < At + Length && memory.IO[End >> 8] == IO)
+                {
+                    End += 256;
+                }
+                Length = End - At < Length ? End - At : Length;
+            }
+            Run(At, Offset, Length, IO);
+            Offset += Length;
+        }
+    }
+
+    void MarkWritten(Mem &memory, u32 At, u32 Length)
+    {
+        for (u32 Page = At >> 8; Page <= (At + Length - 1) >> 8; Page++)
+        {
+            memory.PageEpoch[Page] = memory.Epoch;
+        }
+    }
+
+    // Offset of the first differing byte, Length when equal. memcmp skips
+    // equal blocks, 8 byte words narrow a differing block down.
+    u32 FirstDifference(const Byte *A, const Byte *B, u32 Length)
+    {
+        const u32 BLOCK = 64;
+        u32 Offset = 0;
+        while (Offset + BLOCK <= Length && memcmp(A + Offset, B + Offset, BLOCK) == 0)
+        {
+            Offset += BLOCK;
+        }
+        for (; Offset + 8 <= Length; Offset += 8)
+        {
+            u64 Left, Right;
+            memcpy(&Left, A + Offset, 8);
+            memcpy(&Right, B + Offset, 8);
+            if (Left != Right)
+                break;
+        }
+        while (Offset < Length && A[Offset] == B[Offset])
+        {
+            Offset++;
+        }
+        return Offset;
+    }
+}
+
+void cpu6502::Mem::ReadBlock(Word Address, Byte *Out, u32 Count, MemView View, u64 Cycle) const
+{
+    ForEachRun(*this, Address, Count, View, [&](u32 At, u32 Offset, u32 Length, Device *Owner) {
+        if (!Owner)
+        {
+            memcpy(Out + Offset, &Data[At], Length);
+            return;
+        }
+        for (u32 i = 0; i < Length; i++)
+        {
+            Out[Offset + i] = Owner->Read(static_cast<Word>(At + i), Cycle);
+        }
+    });
+}
+
+void cpu6502::Mem::WriteBlock(Word Address, const Byte *Source, u32 Count, MemView View, u64 Cycle)
+{
+    ForEachRun(*this, Address, Count, View, [&](u32 At, u32 Offset, u32 Length, Device *Owner) {
+        if (!Owner)
+        {
+            memcpy(&Data[At], Source + Offset, Length);
+            MarkWritten(*this, At, Length);
+            return;
+        }
+        // Device::WriteBlock takes a page at a time
+        for (u32 Done = 0; Done < Length;)
+        {
+            u32 Chunk = 256 - ((At + Done) & 0xFF);
+            Chunk = Chunk < Length - Done ? Chunk : Length - Done;
+            Owner->WriteBlock(static_cast<Word>(At + Done), Source + Offset + Done, Chunk, Cycle);
+            Done += Chunk;
+        }
+    });
+}
+
+void cpu6502::Mem::Fill(Word Address, Byte Value, u32 Count, MemView View, u64 Cycle)
+{
+    Byte Page[256];
+    memset(Page, Value, sizeof(Page));
+    ForEachRun(*this, Address, Count, View, [&](u32 At, u32 /*Offset*/, u32 Length, Device *Owner) {
+        if (!Owner)
+        {
+            memset(&Data[At], Value, Length);
+            MarkWritten(*this, At, Length);
+            return;
+        }
+        for (u32 Done = 0; Done < Length;)
+        {
+            u32 Chunk = 256 - ((At + Done) & 0xFF);
+            Chunk = Chunk < Length - Done ? Chunk : Length - Done;
+            Owner->WriteBlock(static_cast<Word>(At + Done), Page, Chunk, Cycle);
+            Done += Chunk;
+        }
+    });
+}
+
+cpu6502::u32 cpu6502::Mem::Compare(Word Address, const Byte *Other, u32 Count) const
+{
+    u32 Result = Count;
+    ForEachRun(*this, Address, Count, MemView::RAM, [&](u32 At, u32 Offset, u32 Length, Device * /*Owner*/) {
+        if (Result != Count)
+            return;
+        u32 Difference = FirstDifference(&Data[At], Other + Offset, Length);
+        if (Difference < Length)
+            Result = Offset + Difference;
+    });
+    return Result;
+}
@@ -0,0 +1,90 @@
+#include "profiler_6502.h"
+#include <algorithm>
+
+void cpu6502::Profiler::Clear()
+{
+    SampleCount = 0;
+    std::fill(FlatSamples.begin(), FlatSamples.end(), 0);
+    StackSamples.clear();
+    CallStack.clear();
+    NextSampleCycle = 0;
+    PreviousOpcode = 0;
+}
+
+void cpu6502::Profiler::OnInstruction(const CPU &cpu, Word PC, Byte Opcode, u64 Cycle)
+{
+    // Finish bookkeeping for the previous instruction now that its effect is visible
+    if (PreviousOpcode == CPU::INS_JSR)
+    {
+        CallStack.push_back({PC, PreviousSP});
+    }
+    else if (PreviousOpcode == CPU::INS_RTS || PreviousOpcode == CPU::INS_TXS)
+    {
+        // Pop every frame the stack pointer went past (also handles stack resets)
+        while (!CallStack.empty() && CallStack.back().ReturnSP <= cpu.SP)
+        {
+            CallStack.pop_back();
+        }
+    }
+    PreviousOpcode = Opcode;
+    PreviousSP = cpu.SP;
+
+    if (Cycle < NextSampleCycle)
+        return;
+
+    NextSampleCycle += SamplePeriod * ((Cycle - NextSampleCycle) / SamplePeriod + 1);
+    SampleCount++;
+    FlatSamples[PC]++;
+
+    StackKey.clear();
+    for (const Frame &Call : CallStack)
+    {
+        StackKey.push_back(Call.Entry);
+    }
+    StackSamples[StackKey]++;
+}
+
+bool cpu6502::Profiler::WriteFlat(const char *Path, const SymbolTable *Symbols) const
+{
+    FILE *File = fopen(Path, "w");
+    if (!File)
+        return false;
+
+    std::vector<u32> Addresses;
+    for (u32 Address = 0; Address < FlatSamples.size(); Address++)
+    {
+        if (FlatSamples[Address])
+            Addresses.push_back(Address);
+    }
+    std::stable_sort(Addresses.begin(), Addresses.end(),
+                     [this](u32 L, u32 R) { return FlatSamples[L] > FlatSamples[R]; });
+
+    for (u32 Address : Addresses)
+    {
+        fprintf(File, "$%04X %llu", Address, FlatSamples[Address]);
+        if (Symbols)
+            fprintf(File, " %s", Symbols->Describe(static_cast<Word>(Address)).c_str());
+        fputc('\n', File);
+    }
+    return fclose(File) == 0;
+}
+
+bool cpu6502::Profiler::WriteFolded(const char *Path, const SymbolTable *Symbols) const
+{
+    FILE *File = fopen(Path, "w");
+    if (!File)
+        return false;
+
+    SymbolTable NoSymbols;
+    const SymbolTable &Names = Symbols ? *Symbols : NoSymbols;
+    for (const auto &Sample : StackSamples)
+    {
+        fputs("root", File);
+        for (Word Entry : Sample.first)
+        {
+            fprintf(File, ";%s", Names.NameOf(Entry).c_str());
+        }
+        fprintf(File, " %llu\n", Sample.second);
+    }
+    return fclose(File) == 0;
+}
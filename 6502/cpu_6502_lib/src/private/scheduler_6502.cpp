@@ -0,0 +1,98 @@
+#include "scheduler_6502.h"
+#include <algorithm>
+#include <climits>
+
+bool cpu6502::Scheduler::FiresLater(const Entry &a, const Entry &b)
+{
+    return a.Cycle != b.Cycle ? a.Cycle > b.Cycle : a.Sequence > b.Sequence;
+}
+
+cpu6502::Scheduler::EventId cpu6502::Scheduler::Schedule(u64 Cycle, Callback Event)
+{
+    EventId Id = NextId++;
+    Queue.push_back({Cycle, NextSequence++, Id, std::move(Event)});
+    std::push_heap(Queue.begin(), Queue.end(), FiresLater);
+    Live++;
+    if (Running)
+        Running->EndSliceAt(Cycle);
+    return Id;
+}
+
+bool cpu6502::Scheduler::Cancel(EventId Id)
+{
+    for (Entry &Pending : Queue)
+    {
+        if (Pending.Id == Id && Pending.Event)
+        {
+            Pending.Event = nullptr;
+            Live--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void cpu6502::Scheduler::DropCancelled()
+{
+    while (!Queue.empty() && !Queue.front().Event)
+    {
+        std::pop_heap(Queue.begin(), Queue.end(), FiresLater);
+        Queue.pop_back();
+    }
+}
+
+cpu6502::u64 cpu6502::Scheduler::NextEventCycle()
+{
+    DropCancelled();
+    return Queue.empty() ? NEVER : Queue.front().Cycle;
+}
+
+void cpu6502::Scheduler::RunDue(u64 Now)
+{
+    while (NextEventCycle() <= Now)
+    {
+        std::pop_heap(Queue.begin(), Queue.end(), FiresLater);
+        Entry Due = std::move(Queue.back());
+        Queue.pop_back();
+        Live--;
+        Due.Event(Due.Cycle);
+    }
+}
+
+cpu6502::ExecuteResult cpu6502::Scheduler::RunSlice(CPU &cpu, Mem &memory, u64 Until)
+{
+    // Execute takes an s32 budget
+    constexpr u64 MAX_SLICE = 1u << 30;
+    u64 SliceEnd = std::min(Until, NextEventCycle());
+    if (SliceEnd <= cpu.CycleCount)
+        return ExecuteResult{0, StopReason::BudgetExhausted, cpu.PC, memory[cpu.PC]};
+    Running = &cpu;
+    // A DMA stall must not run past the next event either
+    cpu.StallLimit = SliceEnd;
+    ExecuteResult Result = cpu.Execute(static_cast<s32>(std::min(SliceEnd - cpu.CycleCount, MAX_SLICE)), memory);
+    Running = nullptr;
+    return Result;
+}
+
+cpu6502::ExecuteResult cpu6502::Scheduler::RunUntil(CPU &cpu, Mem &memory, u64 Until)
+{
+    const u64 Start = cpu.CycleCount;
+    ExecuteResult Result{0, StopReason::BudgetExhausted, cpu.PC, memory[cpu.PC]};
+    for (;;)
+    {
+        RunDue(cpu.CycleCount);
+        if (cpu.CycleCount >= Until)
+            break;
+        Result = RunSlice(cpu, memory, Until);
+        if (Result.Reason != StopReason::BudgetExhausted)
+            break;
+    }
+    Result.Cycles = static_cast<s32>(std::min<u64>(cpu.CycleCount - Start, INT_MAX));
+    return Result;
+}
+
+void cpu6502::Scheduler::Clear()
+{
+    Queue.clear();
+    Live = 0;
+}
@@ -0,0 +1,159 @@
+#include "sound_6502.h"
+
+cpu6502::SoundChip::SoundChip(Scheduler &Clock, Word Start, u32 Batch)
+    : Base(Start), BatchCycles(Batch < MAX_BATCH ? Batch : MAX_BATCH), Events(Clock)
+{
+    Pending = Events.Schedule(BatchCycles, [this](u64 Due) { EndBatch(Due); });
+}
+
+void cpu6502::SoundChip::EndBatch(u64 Cycle)
+{
+    Pending = Events.Schedule(Cycle + BatchCycles, [this](u64 Due) { EndBatch(Due); });
+    Sync(Cycle);
+    // Whatever the guest does next batch has to fit
+    if (Log.Free() >= BatchEntries(BatchCycles))
+        return;
+    RendererWaits++;
+    do
+    {
+        WaitForRenderer();
+    } while (Log.Free() < BatchEntries(BatchCycles));
+}
+
+cpu6502::SoundChip::~SoundChip()
+{
+    if (Pending)
+        Events.Cancel(Pending);
+}
+
+void cpu6502::SoundChip::Append(const Event &Entry)
+{
+    // Guest writes always fit, see EndBatch
+    while (!Log.Push(Entry))
+    {
+        WaitForRenderer();
+    }
+}
+
+cpu6502::Byte cpu6502::SoundChip::Read(Word Address, u64 /*Cycle*/)
+{
+    Byte Register = static_cast<Word>(Address - Base) & 0x0F;
+    return Register < sizeof(Registers) ? Registers[Register] : 0xFF;
+}
+
+void cpu6502::SoundChip::Write(Word Address, Byte Value, u64 Cycle)
+{
+    Byte Register = static_cast<Word>(Address - Base) & 0x0F;
+    if (Register >= sizeof(Registers) || (Register & 3) > VOLUME)
+        return;
+    Registers[Register] = Value;
+    Append({Cycle, Register, Value});
+}
+
+cpu6502::SoundRenderer::SoundRenderer(u32 Clock, u32 Rate) : ClockHz(Clock), SampleRate(Rate)
+{
+}
+
+void cpu6502::SoundRenderer::Channel::Advance(u64 Cycles)
+{
+    if (!HalfPeriod)
+        return;
+    if (Cycles < Countdown)
+    {
+        Countdown -= static_cast<u32>(Cycles);
+        return;
+    }
+    Cycles -= Countdown;
+    High ^= (1 + Cycles / HalfPeriod) & 1;
+    Countdown = HalfPeriod - static_cast<u32>(Cycles % HalfPeriod);
+}
+
+void cpu6502::SoundRenderer::RenderUntil(u64 Until, std::vector<s16> &Out)
+{
+    for (u64 Next = SampleCycle(NextSample); Next < Until; Next = SampleCycle(++NextSample))
+    {
+        s32 Mixed = 0;
+        for (Channel &Voice : Channels)
+        {
+            Voice.Advance(Next - Cycle);
+            if (Voice.HalfPeriod)
+                Mixed += (Voice.High ? Voice.Volume : -Voice.Volume) * 512;
+        }
+        Cycle = Next;
+        Out.push_back(static_cast<s16>(Mixed));
+    }
+    for (Channel &Voice : Channels)
+    {
+        Voice.Advance(Until - Cycle);
+    }
+    Cycle = Until;
+}
+
+void cpu6502::SoundRenderer::Apply(const SoundChip::Event &Entry, std::vector<s16> &Out)
+{
+    // Samples on the write's own cycle already hear it
+    if (Entry.Cycle > Cycle)
+        RenderUntil(Entry.Cycle, Out);
+    if (Entry.Register == SoundChip::SYNC)
+        return;
+
+    Registers[Entry.Register] = Entry.Value;
+    Channel &Voice = Channels[Entry.Register / 4];
+    const Byte *Regs = &Registers[Entry.Register & ~3];
+    if ((Entry.Register & 3) == SoundChip::VOLUME)
+    {
+        Voice.Volume = Entry.Value & 0x0F;
+        return;
+    }
+    // A new period starts with the next flip, unless that is further off
+    u32 Period = Regs[SoundChip::PERIOD_LO] | (Regs[SoundChip::PERIOD_HI] & 0x0F) << 8;
+    Voice.HalfPeriod = Period * 8;
+    if (Voice.Countdown == 0 || Voice.Countdown > Voice.HalfPeriod)
+        Voice.Countdown = Voice.HalfPeriod;
+}
+
+cpu6502::u32 cpu6502::SoundRenderer::Render(SoundChip &Chip, std::vector<s16> &Out)
+{
+    // The log is in cycle order, so samples before an entry never change
+    // once it has been seen
+    size_t Start = Out.size();
+    SoundChip::Event Entry;
+    while (Chip.Pop(Entry))
+    {
+        Apply(Entry, Out);
+    }
+    return static_cast<u32>(Out.size() - Start);
+}
+
+namespace
+{
+    void Put(FILE *File, cpu6502::u32 Value, int Bytes)
+    {
+        for (int i = 0; i < Bytes; i++)
+        {
+            fputc((Value >> (i * 8)) & 0xFF, File);
+        }
+    }
+}
+
+bool cpu6502::SoundRenderer::WriteWav(FILE *File, const s16 *Samples, u32 Count, u32 Rate)
+{
+    const u32 DataSize = Count * 2;
+    fwrite("RIFF", 1, 4, File);
+    Put(File, 36 + DataSize, 4);
+    fwrite("WAVEfmt ", 1, 8, File);
+    Put(File, 16, 4);       // fmt chunk size
+    Put(File, 1, 2);        // PCM
+    Put(File, 1, 2);        // mono
+    Put(File, Rate, 4);
+    Put(File, Rate * 2, 4); // bytes per second
+    Put(File, 2, 2);        // bytes per frame
+    Put(File, 16, 2);       // bits per sample
+    fwrite("data", 1, 4, File);
+    Put(File, DataSize, 4);
+    for (u32 i = 0; i < Count; i++)
+    {
+        Put(File, static_cast<Word>(Samples[i]), 2);
+    }
+    return !ferror(File);
+}
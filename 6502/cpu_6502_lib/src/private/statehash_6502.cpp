@@ -0,0 +1,143 @@
+#include "statehash_6502.h"
+#include <string.h>
+
+namespace
+{
+    using cpu6502::Byte;
+    using cpu6502::u32;
+    using cpu6502::u64;
+
+    constexpr u64 PRIME1 = 0x9E3779B185EBCA87ull;
+    constexpr u64 PRIME2 = 0xC2B2AE3D27D4EB4Full;
+
+    u64 Mix(u64 Value)
+    {
+        Value ^= Value >> 33;
+        Value *= 0xFF51AFD7ED558CCDull;
+        Value ^= Value >> 33;
+        Value *= 0xC4CEB9FE1A85EC53ull;
+        return Value ^ (Value >> 33);
+    }
+
+    u64 Round(u64 Lane, u64 Input)
+    {
+        Lane += Input * PRIME2;
+        Lane = (Lane << 31) | (Lane >> 33);
+        return Lane * PRIME1;
+    }
+
+    // Four independent lanes over the page's 32 words
+    u64 HashPage(const Byte *Data, u32 Page)
+    {
+        u64 Lanes[4] = {Page + PRIME1, Page + PRIME2, Page, Page - PRIME1};
+        for (u32 i = 0; i < 256; i += 32)
+        {
+            for (u32 Lane = 0; Lane < 4; Lane++)
+            {
+                u64 Input;
+                memcpy(&Input, Data + i + Lane * 8, 8);
+                Lanes[Lane] = Round(Lanes[Lane], Input);
+            }
+        }
+        return Mix(Lanes[0] ^ (Lanes[1] << 1 | Lanes[1] >> 63) ^ (Lanes[2] << 7 | Lanes[2] >> 57) ^
+                   (Lanes[3] << 12 | Lanes[3] >> 52));
+    }
+
+    // Order matters, swapping two pages changes the root
+    u64 Combine(u64 Left, u64 Right) { return Mix(Left * PRIME1 + Right); }
+}
+
+cpu6502::StateHasher::StateHasher(Mem &Memory) : memory(Memory)
+{
+    Rebuild();
+}
+
+void cpu6502::StateHasher::Rebuild()
+{
+    Since = 0;
+    Update();
+}
+
+void cpu6502::StateHasher::Update()
+{
+    // Changed nodes of one level in ascending order, starting with the
+    // pages; each parent is recombined once per level
+    u32 Nodes[LEAVES];
+    u32 Count = 0;
+    for (u32 Page = 0; Page < LEAVES; Page++)
+    {
+        if (!memory.WrittenSince(Page, Since))
+            continue;
+        Tree[LEAVES - 1 + Page] = HashPage(&memory.Data[Page * 256], Page);
+        Nodes[Count++] = LEAVES - 1 + Page;
+    }
+    PagesHashed += Count;
+    while (Count && Nodes[0] != 0)
+    {
+        u32 Parents = 0;
+        for (u32 i = 0; i < Count; i++)
+        {
+            u32 Parent = (Nodes[i] - 1) / 2;
+            if (Parents && Nodes[Parents - 1] == Parent)
+                continue;
+            Tree[Parent] = Combine(Tree[2 * Parent + 1], Tree[2 * Parent + 2]);
+            Nodes[Parents++] = Parent;
+        }
+        Count = Parents;
+    }
+    Since = memory.Checkpoint();
+}
+
+cpu6502::u64 cpu6502::StateHasher::Hash(const CPU &cpu)
+{
+    Update();
+    u64 Registers = u64(cpu.PC) | u64(cpu.SP) << 16 | u64(cpu.A) << 24 | u64(cpu.X) << 32 | u64(cpu.Y) << 40 |
+                    u64(cpu.PS) << 48 | u64(cpu.NMIPending) << 56;
+    return Combine(Combine(Tree[0], Mix(Registers)), Mix(cpu.IRQLines));
+}
+
+cpu6502::StateSet::StateSet(u32 Capacity)
+{
+    u32 Size = 16;
+    while (Size < Capacity)
+        Size <<= 1;
+    Mask = Size - 1;
+    Slots.reset(new std::atomic<u64>[Size]);
+    for (u32 i = 0; i < Size; i++)
+        Slots[i].store(0, std::memory_order_relaxed);
+}
+
+cpu6502::StateSet::Result cpu6502::StateSet::Insert(u64 Hash)
+{
+    const u64 Wanted = Key(Hash);
+    for (u32 Probe = 0, Slot = static_cast<u32>(Mix(Wanted)) & Mask; Probe <= Mask; Probe++, Slot = (Slot + 1) & Mask)
+    {
+        u64 Seen = Slots[Slot].load(std::memory_order_acquire);
+        if (Seen == 0)
+        {
+            if (Slots[Slot].compare_exchange_strong(Seen, Wanted, std::memory_order_acq_rel))
+            {
+                Count.fetch_add(1, std::memory_order_relaxed);
+                return Result::Added;
+            }
+            // Lost the race, Seen now holds the winner
+        }
+        if (Seen == Wanted)
+            return Result::Present;
+    }
+    return Result::Full;
+}
+
+bool cpu6502::StateSet::Contains(u64 Hash) const
+{
+    const u64 Wanted = Key(Hash);
+    for (u32 Probe = 0, Slot = static_cast<u32>(Mix(Wanted)) & Mask; Probe <= Mask; Probe++, Slot = (Slot + 1) & Mask)
+    {
+        u64 Seen = Slots[Slot].load(std::memory_order_acquire);
+        if (Seen == Wanted)
+            return true;
+        if (Seen == 0)
+            return false;
+    }
+    return false;
+}
@@ -0,0 +1,88 @@
+#include "symbols_6502.h"
+#include <cctype>
+#include <cstring>
+
+namespace
+{
+    bool ParseHexAddress(const char *Text, cpu6502::Word &Address)
+    {
+        if (*Text == '$')
+            Text++;
+        else if (Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
+            Text += 2;
+        else if ((Text[0] == 'C' || Text[0] == 'c') && Text[1] == ':')
+            Text += 2; // VICE memory space prefix
+        char *End = nullptr;
+        unsigned long Value = strtoul(Text, &End, 16);
+        if (End == Text || *End != '\0' || Value > 0xFFFF)
+            return false;
+        Address = static_cast<cpu6502::Word>(Value);
+        return true;
+    }
+
+    std::string HexName(cpu6502::Word Address)
+    {
+        char Buffer[8];
+        snprintf(Buffer, sizeof(Buffer), "$%04X", Address);
+        return Buffer;
+    }
+}
+
+bool cpu6502::SymbolTable::Load(const char *Path)
+{
+    FILE *File = fopen(Path, "r");
+    if (!File)
+        return false;
+
+    char Line[512];
+    while (fgets(Line, sizeof(Line), File))
+    {
+        char *Tokens[4] = {};
+        int Count = 0;
+        for (char *Token = strtok(Line, " \t\r\n"); Token && Count < 4; Token = strtok(nullptr, " \t\r\n"))
+        {
+            Tokens[Count++] = Token;
+        }
+        if (Count < 2 || Tokens[0][0] == ';' || Tokens[0][0] == '#')
+            continue;
+
+        Word Address = 0;
+        if (strcmp(Tokens[0], "al") == 0 && Count >= 3 && ParseHexAddress(Tokens[1], Address))
+        {
+            // al C:c000 .main
+            Add(Address, Tokens[2][0] == '.' ? Tokens[2] + 1 : Tokens[2]);
+        }
+        else if (Count >= 3 && (strcmp(Tokens[1], "=") == 0 || strcmp(Tokens[1], ":=") == 0) &&
+                 ParseHexAddress(Tokens[2], Address))
+        {
+            // main = $C000
+            Add(Address, Tokens[0]);
+        }
+        else if (ParseHexAddress(Tokens[0], Address))
+        {
+            // $C000 main
+            Add(Address, Tokens[1]);
+        }
+    }
+    fclose(File);
+    return true;
+}
+
+std::string cpu6502::SymbolTable::NameOf(Word Address) const
+{
+    auto It = Labels.find(Address);
+    return It != Labels.end() ? It->second : HexName(Address);
+}
+
+std::string cpu6502::SymbolTable::Describe(Word Address) const
+{
+    auto It = Labels.upper_bound(Address);
+    if (It == Labels.begin())
+        return HexName(Address);
+    --It;
+    if (It->first == Address)
+        return It->second;
+    char Offset[8];
+    snprintf(Offset, sizeof(Offset), "+$%X", Address - It->first);
+    return It->second + Offset;
+}
@@ -0,0 +1,228 @@
+#include "trace_6502.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr char TRACE_MAGIC[4] = {'M', '6', '5', 'T'};
+    constexpr cpu6502::u32 TRACE_VERSION = 1;
+
+    // On-disk layout of one access (packed, little endian host assumed)
+    struct FileAccess
+    {
+        cpu6502::u64 Cycle;
+        cpu6502::Word PC;
+        cpu6502::Word Address;
+        cpu6502::Byte Value;
+        cpu6502::Byte Kind;
+        cpu6502::Byte Padding[2];
+    };
+
+    struct FileInstruction
+    {
+        cpu6502::u64 Cycle;
+        cpu6502::Word PC;
+        cpu6502::Byte Opcode;
+        cpu6502::Byte Padding[5];
+    };
+}
+
+void cpu6502::TraceRecorder::Clear()
+{
+    Instructions.clear();
+    Accesses.clear();
+    ReadIndex.clear();
+    WriteIndex.clear();
+}
+
+void cpu6502::TraceRecorder::BuildIndex()
+{
+    ReadIndex.assign(NUM_ADDRESSES, {});
+    WriteIndex.assign(NUM_ADDRESSES, {});
+    for (u32 i = 0; i < Accesses.size(); i++)
+    {
+        AddToIndex(i);
+    }
+}
+
+void cpu6502::TraceRecorder::AddToIndex(u32 AccessIndex)
+{
+    const TraceAccess &Access = Accesses[AccessIndex];
+    auto &Index = (Access.Kind == AccessKind::Read) ? ReadIndex : WriteIndex;
+    Index[Access.Address].push_back(AccessIndex);
+}
+
+const std::vector<cpu6502::u32> &cpu6502::TraceRecorder::IndexFor(Word Address, AccessKind Kind) const
+{
+    static const std::vector<u32> Empty;
+    const auto &Index = (Kind == AccessKind::Read) ? ReadIndex : WriteIndex;
+    return Index.empty() ? Empty : Index[Address];
+}
+
+const cpu6502::TraceAccess *cpu6502::TraceRecorder::LastWriteBefore(Word Address, u64 Cycle) const
+{
+    const std::vector<u32> &Writes = IndexFor(Address, AccessKind::Write);
+    // Accesses are appended in cycle order, so every per-address list is sorted
+    auto It = std::lower_bound(Writes.begin(), Writes.end(), Cycle,
+                               [this](u32 Index, u64 Value) { return Accesses[Index].Cycle < Value; });
+    if (It == Writes.begin())
+        return nullptr;
+    return &Accesses[*(It - 1)];
+}
+
+const cpu6502::TraceAccess *cpu6502::TraceRecorder::NextReadAfter(Word Address, u64 Cycle) const
+{
+    const std::vector<u32> &Reads = IndexFor(Address, AccessKind::Read);
+    auto It = std::lower_bound(Reads.begin(), Reads.end(), Cycle,
+                               [this](u32 Index, u64 Value) { return Accesses[Index].Cycle < Value; });
+    if (It == Reads.end())
+        return nullptr;
+    return &Accesses[*It];
+}
+
+std::vector<const cpu6502::TraceAccess *> cpu6502::TraceRecorder::AccessesTo(Word Address, AccessKind Kind,
+                                                                            u64 FromCycle, u64 ToCycle) const
+{
+    const std::vector<u32> &List = IndexFor(Address, Kind);
+    auto ByCycle = [this](u32 Index, u64 Value) { return Accesses[Index].Cycle < Value; };
+    auto First = std::lower_bound(List.begin(), List.end(), FromCycle, ByCycle);
+    auto Last = std::lower_bound(First, List.end(), ToCycle, ByCycle);
+
+    std::vector<const TraceAccess *> Result;
+    Result.reserve(Last - First);
+    for (auto It = First; It != Last; ++It)
+    {
+        Result.push_back(&Accesses[*It]);
+    }
+    return Result;
+}
+
+std::vector<cpu6502::Word> cpu6502::TraceRecorder::DistinctPCs(Word Address, AccessKind Kind) const
+{
+    std::vector<Word> PCs;
+    for (u32 Index : IndexFor(Address, Kind))
+    {
+        PCs.push_back(Accesses[Index].PC);
+    }
+    std::sort(PCs.begin(), PCs.end());
+    PCs.erase(std::unique(PCs.begin(), PCs.end()), PCs.end());
+    return PCs;
+}
+
+std::vector<cpu6502::Word> cpu6502::TraceRecorder::ReadersOf(Word Address) const
+{
+    return DistinctPCs(Address, AccessKind::Read);
+}
+
+std::vector<cpu6502::Word> cpu6502::TraceRecorder::WritersOf(Word Address) const
+{
+    return DistinctPCs(Address, AccessKind::Write);
+}
+
+void cpu6502::TraceRecorder::OnInstruction(const CPU & /*cpu*/, Word PC, Byte Opcode, u64 Cycle)
+{
+    CurrentPC = PC;
+    Instructions.push_back({Cycle, PC, Opcode});
+}
+
+void cpu6502::TraceRecorder::OnRead(Word Address, Byte Value, u64 Cycle)
+{
+    Record(Address, Value, Cycle, AccessKind::Read);
+}
+
+void cpu6502::TraceRecorder::OnWrite(Word Address, Byte Value, u64 Cycle)
+{
+    Record(Address, Value, Cycle, AccessKind::Write);
+}
+
+void cpu6502::TraceRecorder::Record(Word Address, Byte Value, u64 Cycle, AccessKind Kind)
+{
+    Accesses.push_back({Cycle, CurrentPC, Address, Value, Kind});
+    if (IndexWhileRecording)
+    {
+        if (ReadIndex.empty())
+        {
+            ReadIndex.resize(NUM_ADDRESSES);
+            WriteIndex.resize(NUM_ADDRESSES);
+        }
+        AddToIndex(static_cast<u32>(Accesses.size() - 1));
+    }
+}
+
+bool cpu6502::TraceRecorder::Save(const char *Path) const
+{
+    FILE *File = fopen(Path, "wb");
+    if (!File)
+        return false;
+
+    const u64 Counts[2] = {Instructions.size(), Accesses.size()};
+    bool Ok = fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1, File) == 1 &&
+              fwrite(&TRACE_VERSION, sizeof(TRACE_VERSION), 1, File) == 1 &&
+              fwrite(Counts, sizeof(Counts), 1, File) == 1;
+
+    for (const TraceInstruction &Ins : Instructions)
+    {
+        FileInstruction Out = {Ins.Cycle, Ins.PC, Ins.Opcode, {}};
+        Ok = Ok && fwrite(&Out, sizeof(Out), 1, File) == 1;
+    }
+    for (const TraceAccess &Access : Accesses)
+    {
+        FileAccess Out = {Access.Cycle, Access.PC, Access.Address, Access.Value,
+                          static_cast<Byte>(Access.Kind), {}};
+        Ok = Ok && fwrite(&Out, sizeof(Out), 1, File) == 1;
+    }
+    return (fclose(File) == 0) && Ok;
+}
+
+bool cpu6502::TraceRecorder::Load(const char *Path)
+{
+    FILE *File = fopen(Path, "rb");
+    if (!File)
+        return false;
+
+    char Magic[4];
+    u32 Version = 0;
+    u64 Counts[2] = {};
+    bool Ok = fread(Magic, sizeof(Magic), 1, File) == 1 &&
+              memcmp(Magic, TRACE_MAGIC, sizeof(Magic)) == 0 &&
+              fread(&Version, sizeof(Version), 1, File) == 1 && Version == TRACE_VERSION &&
+              fread(Counts, sizeof(Counts), 1, File) == 1;
+
+    // The counts come from the file: make sure it holds that many records
+    // before sizing anything by them
+    if (Ok)
+    {
+        long Here = ftell(File);
+        Ok = Here >= 0 && fseek(File, 0, SEEK_END) == 0;
+        long End = Ok ? ftell(File) : -1;
+        Ok = Ok && End >= Here && fseek(File, Here, SEEK_SET) == 0;
+        u64 Remaining = Ok ? static_cast<u64>(End - Here) : 0;
+        Ok = Ok && Counts[0] <= Remaining / sizeof(FileInstruction) &&
+             Counts[1] <= (Remaining - Counts[0] * sizeof(FileInstruction)) / sizeof(FileAccess);
+    }
+
+    Clear();
+    if (Ok)
+    {
+        std::vector<FileInstruction> InsIn(Counts[0]);
+        std::vector<FileAccess> AccessIn(Counts[1]);
+        Ok = (InsIn.empty() || fread(InsIn.data(), sizeof(FileInstruction), InsIn.size(), File) == InsIn.size()) &&
+             (AccessIn.empty() || fread(AccessIn.data(), sizeof(FileAccess), AccessIn.size(), File) == AccessIn.size());
+        if (Ok)
+        {
+            Instructions.reserve(InsIn.size());
+            for (const FileInstruction &In : InsIn)
+            {
+                Instructions.push_back({In.Cycle, In.PC, In.Opcode});
+            }
+            Accesses.reserve(AccessIn.size());
+            for (const FileAccess &In : AccessIn)
+            {
+                Accesses.push_back({In.Cycle, In.PC, In.Address, In.Value, static_cast<AccessKind>(In.Kind)});
+            }
+            BuildIndex();
+        }
+    }
+    fclose(File);
+    return Ok;
+}
@@ -0,0 +1,31 @@
+#include "uart_6502.h"
+
+cpu6502::u32 cpu6502::Uart::FlushTo(FILE *File)
+{
+    return Output.Drain([File](const Byte *Data, u32 Count) {
+        return static_cast<u32>(fwrite(Data, 1, Count, File));
+    });
+}
+
+cpu6502::Byte cpu6502::Uart::Read(Word Address, u64 /*Cycle*/)
+{
+    switch (static_cast<Word>(Address - Base))
+    {
+    case DATA:
+    {
+        Byte Value = 0;
+        Input.Pop(Value);
+        return Value;
+    }
+    case STATUS:
+        return (Input.CanPop() ? RX_READY : 0) | (Output.CanPush() ? TX_READY : 0);
+    default:
+        return 0xFF;
+    }
+}
+
+void cpu6502::Uart::Write(Word Address, Byte Value, u64 /*Cycle*/)
+{
+    if (static_cast<Word>(Address - Base) == DATA && !Output.Push(Value))
+        DroppedOutput++;
+}
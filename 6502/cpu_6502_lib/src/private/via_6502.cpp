@@ -0,0 +1,181 @@
+#include "via_6502.h"
+#include <algorithm>
+
+cpu6502::VIA::VIA(CPU &Target, Scheduler &Queue, u32 Source) : cpu(Target), Events(Queue), IRQSource(Source)
+{
+}
+
+cpu6502::VIA::~VIA()
+{
+    if (Pending)
+        Events.Cancel(Pending);
+    cpu.SetIRQ(IRQSource, false);
+}
+
+cpu6502::Word cpu6502::VIA::Count(const Timer &Counter, u64 Cycle)
+{
+    // Wraps through $FFFF once it has passed 0. A free-running timer shows
+    // $FFFF on the underflow cycle, the reload is already in place by then.
+    if (Cycle < Counter.Start)
+        return 0xFFFF;
+    return static_cast<Word>(Counter.Period - static_cast<s32>(Cycle - Counter.Start));
+}
+
+cpu6502::Word cpu6502::VIA::Timer1(u64 Cycle)
+{
+    Update(Cycle);
+    return Count(T1, Cycle);
+}
+
+cpu6502::Word cpu6502::VIA::Timer2(u64 Cycle)
+{
+    Update(Cycle);
+    return Count(T2, Cycle);
+}
+
+void cpu6502::VIA::Update(u64 Cycle)
+{
+    while (T1.Underflow <= Cycle)
+    {
+        SetFlags(IRQ_T1);
+        if (Regs[ACR] & ACR_T1_CONTINUOUS)
+        {
+            // Reloaded from the latch one cycle after showing $FFFF
+            T1.Start = T1.Underflow + 1;
+            T1.Period = T1Latch;
+            T1.Underflow = T1.Start + T1.Period + 1;
+        }
+        else
+        {
+            T1.Underflow = Scheduler::NEVER;
+        }
+    }
+    if (T2.Underflow <= Cycle)
+    {
+        SetFlags(IRQ_T2);
+        T2.Underflow = Scheduler::NEVER;
+    }
+}
+
+void cpu6502::VIA::Reschedule()
+{
+    u64 Next = std::min(T1.Underflow, T2.Underflow);
+    if (Next == PendingCycle)
+        return;
+    if (Pending)
+        Events.Cancel(Pending);
+    Pending = 0;
+    PendingCycle = Next;
+    if (Next != Scheduler::NEVER)
+    {
+        Pending = Events.Schedule(Next, [this](u64 Due) {
+            Pending = 0;
+            PendingCycle = Scheduler::NEVER;
+            Update(Due);
+            Reschedule();
+        });
+    }
+}
+
+void cpu6502::VIA::SetFlags(Byte Flags)
+{
+    Regs[IFR] |= Flags;
+    cpu.SetIRQ(IRQSource, (Regs[IFR] & Regs[IER] & 0x7F) != 0);
+}
+
+void cpu6502::VIA::ClearFlags(Byte Flags)
+{
+    Regs[IFR] &= ~Flags;
+    cpu.SetIRQ(IRQSource, (Regs[IFR] & Regs[IER] & 0x7F) != 0);
+}
+
+bool cpu6502::VIA::StableRead(Word Address) const
+{
+    // Counters move every cycle and reading their low byte clears a flag
+    Byte Index = Address & 0x0F;
+    return Index != T1CL && Index != T1CH && Index != T2CL && Index != T2CH;
+}
+
+cpu6502::Byte cpu6502::VIA::Read(Word Address, u64 Cycle)
+{
+    Update(Cycle);
+    switch (Address & 0x0F)
+    {
+    case ORB:
+        return PortB();
+    case ORA:
+    case ORA_NH:
+        return PortA();
+    case T1CL:
+        ClearFlags(IRQ_T1);
+        return Count(T1, Cycle) & 0xFF;
+    case T1CH:
+        return Count(T1, Cycle) >> 8;
+    case T1LL:
+        return T1Latch & 0xFF;
+    case T1LH:
+        return T1Latch >> 8;
+    case T2CL:
+        ClearFlags(IRQ_T2);
+        return Count(T2, Cycle) & 0xFF;
+    case T2CH:
+        return Count(T2, Cycle) >> 8;
+    case IFR:
+    {
+        Byte Flags = Regs[IFR] & 0x7F;
+        return Flags | ((Flags & Regs[IER]) ? IRQ_ANY : 0);
+    }
+    case IER:
+        return Regs[IER] | 0x80;
+    default:
+        return Regs[Address & 0x0F];
+    }
+}
+
+void cpu6502::VIA::Write(Word Address, Byte Value, u64 Cycle)
+{
+    Update(Cycle);
+    switch (Address & 0x0F)
+    {
+    case ORA_NH:
+        Regs[ORA] = Value;
+        break;
+    case T1CL:
+    case T1LL:
+        T1Latch = (T1Latch & 0xFF00) | Value;
+        break;
+    case T1CH:
+        // Load and start, the counter holds the latch from the next cycle
+        T1Latch = static_cast<Word>((Value << 8) | (T1Latch & 0xFF));
+        T1 = {Cycle + 1, T1Latch, Cycle + 1 + T1Latch + 1};
+        ClearFlags(IRQ_T1);
+        break;
+    case T1LH:
+        T1Latch = static_cast<Word>((Value << 8) | (T1Latch & 0xFF));
+        ClearFlags(IRQ_T1);
+        break;
+    case T2CL:
+        T2Latch = (T2Latch & 0xFF00) | Value;
+        break;
+    case T2CH:
+        T2 = {Cycle + 1, static_cast<Word>((Value << 8) | (T2Latch & 0xFF)), 0};
+        T2.Underflow = T2.Start + T2.Period + 1;
+        ClearFlags(IRQ_T2);
+        break;
+    case IFR:
+        // Writing 1s clears those flags
+        ClearFlags(Value & 0x7F);
+        break;
+    case IER:
+        if (Value & 0x80)
+            Regs[IER] |= Value & 0x7F;
+        else
+            Regs[IER] &= ~Value;
+        ClearFlags(0);
+        break;
+    default:
+        Regs[Address & 0x0F] = Value;
+        break;
+    }
+    Reschedule();
+}
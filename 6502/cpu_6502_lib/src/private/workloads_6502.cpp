@@ -0,0 +1,419 @@
+#include "workloads_6502.h"
+#include <algorithm>
+
+// Program images were assembled from the sources in the comments and
+// checked against an independent NMOS 6502 model for the cycle counts.
+
+using namespace cpu6502;
+
+namespace
+{
+    // Fills Count bytes of the "A = A * 5 + 1" sequence the programs
+    // generate their input data with (ASL / ASL / SEC / ADC tmp)
+    std::vector<Byte> LcgBytes(Byte Seed, u32 Count)
+    {
+        std::vector<Byte> Bytes(Count);
+        Byte Value = Seed;
+        for (Byte &b : Bytes)
+        {
+            b = Value;
+            Value = static_cast<Byte>(Value * 5 + 1);
+        }
+        return Bytes;
+    }
+
+    Word ReadWord(const Mem &memory, Word Address)
+    {
+        return static_cast<Word>(memory[Address] | (memory[Address + 1] << 8));
+    }
+
+    // Sieve of Eratosthenes over [0, 4096), one flag byte per number at
+    // $2000, non zero marks a composite. Prime count ends up in $10/$11.
+    const Byte SieveImage[] = {
+        // N = 4096, FLAGS = $2000, ptr = $00, i = $02, j = $04, count = $10
+        0xA9, 0x00,         // $0800         LDA #<FLAGS
+        0x85, 0x00,         // $0802         STA ptr
+        0xA9, 0x20,         // $0804         LDA #>FLAGS
+        0x85, 0x01,         // $0806         STA ptr+1
+        0xA9, 0x00,         // $0808         LDA #0
+        0xA2, 0x10,         // $080A         LDX #16
+        0xA0, 0x00,         // $080C         LDY #0
+        0x91, 0x00,         // $080E clr:    STA (ptr),Y
+        0xC8,               // $0810         INY
+        0xD0, 0xFB,         // $0811         BNE clr
+        0xE6, 0x01,         // $0813         INC ptr+1
+        0xCA,               // $0815         DEX
+        0xD0, 0xF6,         // $0816         BNE clr
+        0x85, 0x10,         // $0818         STA count
+        0x85, 0x11,         // $081A         STA count+1
+        0xA9, 0x02,         // $081C         LDA #2
+        0x85, 0x02,         // $081E         STA i
+        0xA9, 0x00,         // $0820         LDA #0
+        0x85, 0x03,         // $0822         STA i+1
+        0x18,               // $0824 outer:  CLC
+        0xA5, 0x02,         // $0825         LDA i
+        0x69, 0x00,         // $0827         ADC #<FLAGS
+        0x85, 0x00,         // $0829         STA ptr
+        0xA5, 0x03,         // $082B         LDA i+1
+        0x69, 0x20,         // $082D         ADC #>FLAGS
+        0x85, 0x01,         // $082F         STA ptr+1
+        0xB1, 0x00,         // $0831         LDA (ptr),Y
+        0xD0, 0x2D,         // $0833         BNE next
+        0xE6, 0x10,         // $0835         INC count
+        0xD0, 0x02,         // $0837         BNE nc
+        0xE6, 0x11,         // $0839         INC count+1
+        0x18,               // $083B nc:     CLC
+        0xA5, 0x00,         // $083C         LDA ptr
+        0x65, 0x02,         // $083E         ADC i
+        0x85, 0x04,         // $0840         STA j
+        0xA5, 0x01,         // $0842         LDA ptr+1
+        0x65, 0x03,         // $0844         ADC i+1
+        0x85, 0x05,         // $0846         STA j+1
+        0xA5, 0x05,         // $0848 mark:   LDA j+1
+        0xC9, 0x30,         // $084A         CMP #>FLAGS+N
+        0xB0, 0x14,         // $084C         BCS next
+        0xA9, 0x01,         // $084E         LDA #1
+        0x91, 0x04,         // $0850         STA (j),Y
+        0x18,               // $0852         CLC
+        0xA5, 0x04,         // $0853         LDA j
+        0x65, 0x02,         // $0855         ADC i
+        0x85, 0x04,         // $0857         STA j
+        0xA5, 0x05,         // $0859         LDA j+1
+        0x65, 0x03,         // $085B         ADC i+1
+        0x85, 0x05,         // $085D         STA j+1
+        0x4C, 0x48, 0x08,   // $085F         JMP mark
+        0xE6, 0x02,         // $0862 next:   INC i
+        0xD0, 0x02,         // $0864         BNE chk
+        0xE6, 0x03,         // $0866         INC i+1
+        0xA5, 0x03,         // $0868 chk:    LDA i+1
+        0xC9, 0x10,         // $086A         CMP #>N
+        0x90, 0xB6,         // $086C         BCC outer
+        0x42, 0x00,         // $086E done:   HOST_CALL 0
+    };
+
+    bool VerifySieve(const Mem &memory)
+    {
+        constexpr u32 N = 4096;
+        constexpr Word FLAGS = 0x2000;
+        std::vector<bool> Composite(N, false);
+        u32 Primes = 0;
+        for (u32 i = 2; i < N; i++)
+        {
+            if (Composite[i])
+                continue;
+            Primes++;
+            for (u32 j = i * 2; j < N; j += i)
+                Composite[j] = true;
+        }
+        for (u32 i = 2; i < N; i++)
+        {
+            if ((memory[FLAGS + i] != 0) != Composite[i])
+                return false;
+        }
+        return ReadWord(memory, 0x0010) == Primes;
+    }
+
+    // Bitwise (table free) CRC-32 of 512 generated bytes at $3000, result
+    // little endian in $20-$23
+    const Byte Crc32Image[] = {
+        // BUF = $3000, ptr = $00, tmp = $06, crc = $20
+        0xA9, 0x00,         // $0800         LDA #<BUF
+        0x85, 0x00,         // $0802         STA ptr
+        0xA9, 0x30,         // $0804         LDA #>BUF
+        0x85, 0x01,         // $0806         STA ptr+1
+        0xA2, 0x02,         // $0808         LDX #2
+        0xA0, 0x00,         // $080A         LDY #0
+        0xA9, 0x5A,         // $080C         LDA #$5A
+        0x91, 0x00,         // $080E fill:   STA (ptr),Y
+        0x85, 0x06,         // $0810         STA tmp
+        0x0A,               // $0812         ASL A
+        0x0A,               // $0813         ASL A
+        0x38,               // $0814         SEC
+        0x65, 0x06,         // $0815         ADC tmp
+        0xC8,               // $0817         INY
+        0xD0, 0xF4,         // $0818         BNE fill
+        0xE6, 0x01,         // $081A         INC ptr+1
+        0xCA,               // $081C         DEX
+        0xD0, 0xEF,         // $081D         BNE fill
+        0xA9, 0xFF,         // $081F         LDA #$FF
+        0x85, 0x20,         // $0821         STA crc
+        0x85, 0x21,         // $0823         STA crc+1
+        0x85, 0x22,         // $0825         STA crc+2
+        0x85, 0x23,         // $0827         STA crc+3
+        0xA9, 0x30,         // $0829         LDA #>BUF
+        0x85, 0x01,         // $082B         STA ptr+1
+        0xA2, 0x02,         // $082D         LDX #2
+        0xB1, 0x00,         // $082F byte:   LDA (ptr),Y
+        0x45, 0x20,         // $0831         EOR crc
+        0x85, 0x20,         // $0833         STA crc
+        0x8A,               // $0835         TXA
+        0x48,               // $0836         PHA
+        0xA2, 0x08,         // $0837         LDX #8
+        0x46, 0x23,         // $0839 bit:    LSR crc+3
+        0x66, 0x22,         // $083B         ROR crc+2
+        0x66, 0x21,         // $083D         ROR crc+1
+        0x66, 0x20,         // $083F         ROR crc
+        0x90, 0x18,         // $0841         BCC nox
+        0xA5, 0x23,         // $0843         LDA crc+3
+        0x49, 0xED,         // $0845         EOR #$ED
+        0x85, 0x23,         // $0847         STA crc+3
+        0xA5, 0x22,         // $0849         LDA crc+2
+        0x49, 0xB8,         // $084B         EOR #$B8
+        0x85, 0x22,         // $084D         STA crc+2
+        0xA5, 0x21,         // $084F         LDA crc+1
+        0x49, 0x83,         // $0851         EOR #$83
+        0x85, 0x21,         // $0853         STA crc+1
+        0xA5, 0x20,         // $0855         LDA crc
+        0x49, 0x20,         // $0857         EOR #$20
+        0x85, 0x20,         // $0859         STA crc
+        0xCA,               // $085B nox:    DEX
+        0xD0, 0xDB,         // $085C         BNE bit
+        0x68,               // $085E         PLA
+        0xAA,               // $085F         TAX
+        0xC8,               // $0860         INY
+        0xD0, 0xCC,         // $0861         BNE byte
+        0xE6, 0x01,         // $0863         INC ptr+1
+        0xCA,               // $0865         DEX
+        0xD0, 0xC7,         // $0866         BNE byte
+        0xA2, 0x03,         // $0868         LDX #3
+        0xB5, 0x20,         // $086A fin:    LDA crc,X
+        0x49, 0xFF,         // $086C         EOR #$FF
+        0x95, 0x20,         // $086E         STA crc,X
+        0xCA,               // $0870         DEX
+        0x10, 0xF7,         // $0871         BPL fin
+        0x42, 0x00,         // $0873 done:   HOST_CALL 0
+    };
+
+    bool VerifyCrc32(const Mem &memory)
+    {
+        std::vector<Byte> Buffer = LcgBytes(0x5A, 512);
+        u32 Crc = 0xFFFFFFFF;
+        for (u32 i = 0; i < Buffer.size(); i++)
+        {
+            if (memory[0x3000 + i] != Buffer[i])
+                return false;
+            Crc ^= Buffer[i];
+            for (u32 Bit = 0; Bit < 8; Bit++)
+                Crc = (Crc >> 1) ^ ((Crc & 1) ? 0xEDB88320 : 0);
+        }
+        Crc = ~Crc;
+        u32 Result = memory[0x20] | (memory[0x21] << 8) | (memory[0x22] << 16) | (u32(memory[0x23]) << 24);
+        return Result == Crc;
+    }
+
+    // Fills 4K at $4000 with a pattern, copies it to $6000 and clears the
+    // source again, all through (zp),Y pointers
+    const Byte MemcpyMemsetImage[] = {
+        // SRC = $4000, DST = $6000, src = $00, dst = $02, tmp = $06
+        0xA9, 0x00,         // $0800         LDA #0
+        0x85, 0x00,         // $0802         STA src
+        0x85, 0x02,         // $0804         STA dst
+        0xA9, 0x40,         // $0806         LDA #>SRC
+        0x85, 0x01,         // $0808         STA src+1
+        0xA2, 0x00,         // $080A         LDX #0
+        0x86, 0x06,         // $080C pf:     STX tmp
+        0xA0, 0x00,         // $080E         LDY #0
+        0x98,               // $0810 pfl:    TYA
+        0x45, 0x06,         // $0811         EOR tmp
+        0x91, 0x00,         // $0813         STA (src),Y
+        0xC8,               // $0815         INY
+        0xD0, 0xF8,         // $0816         BNE pfl
+        0xE6, 0x01,         // $0818         INC src+1
+        0xE8,               // $081A         INX
+        0xE0, 0x10,         // $081B         CPX #16
+        0xD0, 0xED,         // $081D         BNE pf
+        0xA9, 0x40,         // $081F         LDA #>SRC
+        0x85, 0x01,         // $0821         STA src+1
+        0xA9, 0x60,         // $0823         LDA #>DST
+        0x85, 0x03,         // $0825         STA dst+1
+        0xA2, 0x10,         // $0827         LDX #16
+        0xB1, 0x00,         // $0829 cp:     LDA (src),Y
+        0x91, 0x02,         // $082B         STA (dst),Y
+        0xC8,               // $082D         INY
+        0xD0, 0xF9,         // $082E         BNE cp
+        0xE6, 0x01,         // $0830         INC src+1
+        0xE6, 0x03,         // $0832         INC dst+1
+        0xCA,               // $0834         DEX
+        0xD0, 0xF2,         // $0835         BNE cp
+        0xA9, 0x40,         // $0837         LDA #>SRC
+        0x85, 0x01,         // $0839         STA src+1
+        0xA9, 0x00,         // $083B         LDA #0
+        0xA2, 0x10,         // $083D         LDX #16
+        0x91, 0x00,         // $083F ms:     STA (src),Y
+        0xC8,               // $0841         INY
+        0xD0, 0xFB,         // $0842         BNE ms
+        0xE6, 0x01,         // $0844         INC src+1
+        0xCA,               // $0846         DEX
+        0xD0, 0xF6,         // $0847         BNE ms
+        0x42, 0x00,         // $0849 done:   HOST_CALL 0
+    };
+
+    bool VerifyMemcpyMemset(const Mem &memory)
+    {
+        for (u32 Page = 0; Page < 16; Page++)
+        {
+            for (u32 i = 0; i < 256; i++)
+            {
+                if (memory[0x6000 + Page * 256 + i] != (i ^ Page))
+                    return false;
+                if (memory[0x4000 + Page * 256 + i] != 0)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Bubble sort of 128 generated bytes at $0300
+    const Byte BubbleSortImage[] = {
+        // ARR = $0300, LEN = 128, tmp = $06, swapped = $07
+        0xA2, 0x00,         // $0800         LDX #0
+        0xA9, 0xC3,         // $0802         LDA #$C3
+        0x9D, 0x00, 0x03,   // $0804 gen:    STA ARR,X
+        0x85, 0x06,         // $0807         STA tmp
+        0x0A,               // $0809         ASL A
+        0x0A,               // $080A         ASL A
+        0x38,               // $080B         SEC
+        0x65, 0x06,         // $080C         ADC tmp
+        0xE8,               // $080E         INX
+        0x10, 0xF3,         // $080F         BPL gen
+        0xA9, 0x00,         // $0811 outer:  LDA #0
+        0x85, 0x07,         // $0813         STA swapped
+        0xA2, 0x00,         // $0815         LDX #0
+        0xBD, 0x00, 0x03,   // $0817 inner:  LDA ARR,X
+        0xDD, 0x01, 0x03,   // $081A         CMP ARR+1,X
+        0x90, 0x11,         // $081D         BCC noswap
+        0xF0, 0x0F,         // $081F         BEQ noswap
+        0xA8,               // $0821         TAY
+        0xBD, 0x01, 0x03,   // $0822         LDA ARR+1,X
+        0x9D, 0x00, 0x03,   // $0825         STA ARR,X
+        0x98,               // $0828         TYA
+        0x9D, 0x01, 0x03,   // $0829         STA ARR+1,X
+        0xA9, 0x01,         // $082C         LDA #1
+        0x85, 0x07,         // $082E         STA swapped
+        0xE8,               // $0830 noswap: INX
+        0xE0, 0x7F,         // $0831         CPX #LEN-1
+        0xD0, 0xE2,         // $0833         BNE inner
+        0xA5, 0x07,         // $0835         LDA swapped
+        0xD0, 0xD8,         // $0837         BNE outer
+        0x42, 0x00,         // $0839 done:   HOST_CALL 0
+    };
+
+    bool VerifyBubbleSort(const Mem &memory)
+    {
+        std::vector<Byte> Sorted = LcgBytes(0xC3, 128);
+        std::sort(Sorted.begin(), Sorted.end());
+        for (u32 i = 0; i < Sorted.size(); i++)
+        {
+            if (memory[0x0300 + i] != Sorted[i])
+                return false;
+        }
+        return true;
+    }
+
+    // Decimal mode: counts a 4 digit BCD value up from 0000 and another
+    // one down from 9999 until the first reaches 9999
+    const Byte BcdCounterImage[] = {
+        // up = $30, down = $32
+        0xF8,               // $0800         SED
+        0xA9, 0x00,         // $0801         LDA #0
+        0x85, 0x30,         // $0803         STA up
+        0x85, 0x31,         // $0805         STA up+1
+        0xA9, 0x99,         // $0807         LDA #$99
+        0x85, 0x32,         // $0809         STA down
+        0x85, 0x33,         // $080B         STA down+1
+        0x18,               // $080D loop:   CLC
+        0xA5, 0x30,         // $080E         LDA up
+        0x69, 0x01,         // $0810         ADC #1
+        0x85, 0x30,         // $0812         STA up
+        0xA5, 0x31,         // $0814         LDA up+1
+        0x69, 0x00,         // $0816         ADC #0
+        0x85, 0x31,         // $0818         STA up+1
+        0x38,               // $081A         SEC
+        0xA5, 0x32,         // $081B         LDA down
+        0xE9, 0x01,         // $081D         SBC #1
+        0x85, 0x32,         // $081F         STA down
+        0xA5, 0x33,         // $0821         LDA down+1
+        0xE9, 0x00,         // $0823         SBC #0
+        0x85, 0x33,         // $0825         STA down+1
+        0xA5, 0x30,         // $0827         LDA up
+        0xC9, 0x99,         // $0829         CMP #$99
+        0xD0, 0xE0,         // $082B         BNE loop
+        0xA5, 0x31,         // $082D         LDA up+1
+        0xC9, 0x99,         // $082F         CMP #$99
+        0xD0, 0xDA,         // $0831         BNE loop
+        0xD8,               // $0833         CLD
+        0x42, 0x00,         // $0834 done:   HOST_CALL 0
+    };
+
+    bool VerifyBcdCounter(const Mem &memory)
+    {
+        return ReadWord(memory, 0x0030) == 0x9999 && ReadWord(memory, 0x0032) == 0x0000;
+    }
+
+    // Naive recursive Fibonacci, fib(18) summed from its leaves into $40/$41.
+    // Exercises JSR / RTS and the stack.
+    const Byte RecursiveFibImage[] = {
+        // res = $40
+        0xA2, 0xFF,         // $0800         LDX #$FF
+        0x9A,               // $0802         TXS
+        0xA9, 0x00,         // $0803         LDA #0
+        0x85, 0x40,         // $0805         STA res
+        0x85, 0x41,         // $0807         STA res+1
+        0xA9, 0x12,         // $0809         LDA #18
+        0x20, 0x11, 0x08,   // $080B         JSR fib
+        0x42, 0x00,         // $080E done:   HOST_CALL 0
+        0xEA,               // $0810         NOP (padding)
+        0xC9, 0x02,         // $0811 fib:    CMP #2
+        0xB0, 0x0A,         // $0813         BCS rec
+        0x18,               // $0815         CLC
+        0x65, 0x40,         // $0816         ADC res
+        0x85, 0x40,         // $0818         STA res
+        0x90, 0x02,         // $081A         BCC fr
+        0xE6, 0x41,         // $081C         INC res+1
+        0x60,               // $081E fr:     RTS
+        0x48,               // $081F rec:    PHA
+        0x38,               // $0820         SEC
+        0xE9, 0x01,         // $0821         SBC #1
+        0x20, 0x11, 0x08,   // $0823         JSR fib
+        0x68,               // $0826         PLA
+        0x38,               // $0827         SEC
+        0xE9, 0x02,         // $0828         SBC #2
+        0x20, 0x11, 0x08,   // $082A         JSR fib
+        0x60,               // $082D         RTS
+    };
+
+    bool VerifyRecursiveFib(const Mem &memory)
+    {
+        Word Previous = 0, Current = 1;
+        for (u32 i = 1; i < 18; i++)
+        {
+            Word Next = static_cast<Word>(Previous + Current);
+            Previous = Current;
+            Current = Next;
+        }
+        return ReadWord(memory, 0x0040) == Current;
+    }
+}
+
+const std::vector<cpu6502::Workload> &cpu6502::Workloads()
+{
+    static const std::vector<Workload> All = {
+        {"Sieve", "prime sieve up to 4096", 0x0800, SieveImage, sizeof(SieveImage), 0x086E, 577090, VerifySieve},
+        {"Crc32", "bitwise CRC-32 of 512 bytes", 0x0800, Crc32Image, sizeof(Crc32Image), 0x0873, 203335, VerifyCrc32},
+        {"MemcpyMemset", "4K fill, copy and clear", 0x0800, MemcpyMemsetImage, sizeof(MemcpyMemsetImage), 0x0849,
+         176785, VerifyMemcpyMemset},
+        {"BubbleSort", "bubble sort of 128 bytes", 0x0800, BubbleSortImage, sizeof(BubbleSortImage), 0x0839, 344284,
+         VerifyBubbleSort},
+        {"BcdCounter", "decimal mode counters", 0x0800, BcdCounterImage, sizeof(BcdCounterImage), 0x0834, 440675,
+         VerifyBcdCounter},
+        {"RecursiveFib", "recursive fib(18)", 0x0800, RecursiveFibImage, sizeof(RecursiveFibImage), 0x080E, 246701,
+         VerifyRecursiveFib},
+    };
+    return All;
+}
+
+void cpu6502::Workload::Load(CPU &cpu, Mem &memory) const
+{
+    cpu.Reset(memory, LoadAddress);
+    memory.WriteBlock(LoadAddress, Image, ImageSize);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "main_6502.h"
+
+// Execution breakpoints and memory watchpoints for CPU::Debug. Both can be
+// made conditional with an expression such as
+//     A == $10 && [$0200] >= 3 || (P & $01)
+// which is compiled once into a small stack bytecode and evaluated on hit.
+// Operands: A X Y SP PC P, numbers ($hex, 0xhex, %binary, decimal) and
+// [address] for a byte of memory. Operators: ! + - & == != < <= > >= && ||
+
+namespace cpu6502
+{
+    struct Condition;
+    struct Breakpoints;
+}
+
+struct cpu6502::Condition
+{
+    enum class Op : Byte
+    {
+        Const, // push Operand
+        A,
+        X,
+        Y,
+        SP,
+        PC,
+        PS,
+        Load, // replace the address on top with the byte stored there
+        Not,
+        Add,
+        Sub,
+        BitAnd,
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        And,
+        Or
+    };
+
+    struct Step
+    {
+        Op Code;
+        Word Operand;
+    };
+
+    static constexpr u32 MAX_DEPTH = 16;
+
+    // Empty means always true
+    std::vector<Step> Code;
+
+    // Replaces Code. On failure Code is left empty and Error (if given) says why.
+    bool Compile(const std::string &Source, std::string *Error = nullptr);
+
+    bool Evaluate(const CPU &cpu, const Mem &memory) const;
+};
+
+struct cpu6502::Breakpoints : cpu6502::Debugger
+{
+    // What stopped execution last
+    struct Hit
+    {
+        Byte Kind;     // EXECUTE, READ or WRITE
+        Word PC;       // Instruction that hit it
+        Word Address;  // Breakpoint or accessed address
+        Byte Value;    // Value read / written
+    } LastHit = {};
+
+    Breakpoints();
+
+    void AddBreakpoint(Word Address, const Condition &When = {});
+    void RemoveBreakpoint(Word Address);
+
+    // Kinds is READ, WRITE or both, First..Last inclusive
+    void AddWatchpoint(Word First, Word Last, Byte Kinds, const Condition &When = {});
+    void RemoveWatchpoint(Word First, Word Last, Byte Kinds);
+
+    void Clear();
+
+    bool BreakAt(const CPU &cpu, const Mem &memory) override;
+    void OnRead(const CPU &cpu, const Mem &memory, Word Address, Byte Value) override;
+    void OnWrite(const CPU &cpu, const Mem &memory, Word Address, Byte Value) override;
+
+private:
+    std::vector<Byte> AddressFlags;
+    // Keyed by Kind << 16 | Address, only for conditional entries
+    std::unordered_map<u32, Condition> Conditions;
+
+    void Set(Word Address, Byte Kinds, const Condition &When);
+    void Unset(Word Address, Byte Kinds);
+    void UpdatePage(Byte Page);
+    bool Check(Byte Kind, const CPU &cpu, const Mem &memory, Word Address) const;
+};
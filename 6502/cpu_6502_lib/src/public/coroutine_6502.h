@@ -0,0 +1,196 @@
+#pragma once
+#if !defined(__cpp_impl_coroutine)
+#error "coroutine_6502.h needs C++20 coroutines"
+#endif
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "main_6502.h"
+#include "scheduler_6502.h"
+
+// Coroutine front end for Scheduler::RunUntil. RunCoroutine is a generator: every
+// resume runs the CPU up to the next point where the host may want to step
+// in - a scheduler event, a trap, a breakpoint or an access to a device
+// wrapped in SuspendingDevice - and yields the ExecuteResult that got it
+// there. The interpreter gets one Execute call per stretch between events
+// instead of a small fixed budget per resume: a resume costs about what an
+// Execute call does, but the host is only resumed when something is due.
+// With events further apart than the budget a host would otherwise poll
+// with, that is fewer and longer slices and more emulated MHz
+// (Interleave/ benches).
+//
+// Plain hosts call Next(), hosts that are coroutines themselves co_await
+// the generator and control goes back and forth by symmetric transfer:
+//
+//     CPURun Cpu = RunCoroutine(cpu, memory, events, Until);
+//     while (auto Result = co_await Cpu)
+//         if (Result->Reason == StopReason::HostCall) ...
+
+namespace cpu6502
+{
+    struct CPURun;
+    struct SuspendingDevice;
+
+    CPURun RunCoroutine(CPU &cpu, Mem &memory, Scheduler &events, u64 Until,
+                        std::vector<SuspendingDevice *> Suspending = {});
+}
+
+// Map this in place of Inner to get a DeviceAccess stop after every
+// instruction that reads or writes it. The access itself goes to Inner
+// as usual, the slice ends at the instruction boundary after it.
+struct cpu6502::SuspendingDevice : Device
+{
+    CPU &cpu;
+    Device &Inner;
+
+    bool Accessed = false; // cleared by RunCoroutine when it yields
+    Word LastAddress = 0;
+
+    SuspendingDevice(CPU &Cpu, Device &Wrapped) : cpu(Cpu), Inner(Wrapped) {}
+
+    Byte Read(Word Address, u64 Cycle) override
+    {
+        Suspend(Address, Cycle);
+        return Inner.Read(Address, Cycle);
+    }
+    void Write(Word Address, Byte Value, u64 Cycle) override
+    {
+        Suspend(Address, Cycle);
+        Inner.Write(Address, Value, Cycle);
+    }
+    void WriteBlock(Word Address, const Byte *Data, u32 Count, u64 Cycle) override
+    {
+        Suspend(Address, Cycle);
+        Inner.WriteBlock(Address, Data, Count, Cycle);
+    }
+
+private:
+    void Suspend(Word Address, u64 Cycle)
+    {
+        Accessed = true;
+        LastAddress = Address;
+        cpu.EndSliceAt(Cycle);
+    }
+};
+
+struct cpu6502::CPURun
+{
+    struct promise_type
+    {
+        ExecuteResult Current{};
+        std::coroutine_handle<> Continuation = std::noop_coroutine();
+
+        // Hands control straight back to whoever resumed us
+        struct Yield
+        {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> Self) noexcept
+            {
+                return Self.promise().Continuation;
+            }
+            void await_resume() noexcept {}
+        };
+
+        CPURun get_return_object() { return CPURun{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        Yield final_suspend() noexcept { return {}; }
+        Yield yield_value(const ExecuteResult &Result) noexcept
+        {
+            Current = Result;
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    CPURun(CPURun &&Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    CPURun &operator=(CPURun &&Other) noexcept
+    {
+        if (this != &Other)
+        {
+            if (Handle)
+                Handle.destroy();
+            Handle = std::exchange(Other.Handle, {});
+        }
+        return *this;
+    }
+    ~CPURun()
+    {
+        if (Handle)
+            Handle.destroy();
+    }
+
+    // Runs to the next stop, false once the run is over
+    bool Next()
+    {
+        if (Done())
+            return false;
+        Handle.promise().Continuation = std::noop_coroutine();
+        Handle.resume();
+        return !Handle.done();
+    }
+
+    bool Done() const { return !Handle || Handle.done(); }
+
+    // Result of the last stop
+    const ExecuteResult &Current() const { return Handle.promise().Current; }
+
+    // co_await gives the next stop, nothing once the run is over
+    struct Awaiter
+    {
+        std::coroutine_handle<promise_type> Handle;
+
+        bool await_ready() const noexcept { return !Handle || Handle.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> Caller) noexcept
+        {
+            Handle.promise().Continuation = Caller;
+            return Handle;
+        }
+        std::optional<ExecuteResult> await_resume() const
+        {
+            if (!Handle || Handle.done())
+                return std::nullopt;
+            return Handle.promise().Current;
+        }
+    };
+
+    Awaiter operator co_await() const noexcept { return Awaiter{Handle}; }
+
+private:
+    explicit CPURun(std::coroutine_handle<promise_type> Coroutine) : Handle(Coroutine) {}
+
+    std::coroutine_handle<promise_type> Handle;
+};
+
+// Yields with Reason BudgetExhausted just before due events fire (PC is the
+// next instruction), with DeviceAccess after an instruction that touched
+// one of Suspending, and with the stop reason on traps and breakpoints.
+// After a HostCall or a breakpoint the host does its part and resumes,
+// execution carries on from there. Finishes at Until, or after yielding a
+// JAM or an illegal opcode the CPU cannot get past.
+inline cpu6502::CPURun cpu6502::RunCoroutine(CPU &cpu, Mem &memory, Scheduler &events, u64 Until,
+                                             std::vector<SuspendingDevice *> Suspending)
+{
+    while (cpu.CycleCount < Until)
+    {
+        ExecuteResult Result = events.RunSlice(cpu, memory, Until);
+        if (Result.Reason == StopReason::Halted || Result.Reason == StopReason::IllegalOpcode)
+        {
+            co_yield Result;
+            co_return;
+        }
+        bool Accessed = false;
+        for (SuspendingDevice *Wrapped : Suspending)
+        {
+            Accessed |= Wrapped->Accessed;
+            Wrapped->Accessed = false;
+        }
+        if (Accessed && Result.Reason == StopReason::BudgetExhausted)
+            Result.Reason = StopReason::DeviceAccess;
+        if (Result.Reason != StopReason::BudgetExhausted || cpu.CycleCount >= events.NextEventCycle())
+            co_yield Result;
+        events.RunDue(cpu.CycleCount);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include "main_6502.h"
+
+// Hot-path counters: retired instructions per opcode, page-crossing
+// penalties per addressing mode, stack traffic and memory reads/writes per
+// page. Counters are plain per-instance integers (no atomics) - give each
+// emulator thread its own instance. That thread reads them with Snapshot();
+// other threads read the copy it last Publish()ed with ReadPublished().
+
+namespace cpu6502
+{
+    struct CounterSnapshot;
+    struct InstructionCounters;
+}
+
+struct cpu6502::CounterSnapshot
+{
+    static constexpr u32 NUM_PAGES = Mem::MAX_MEM / 256;
+    static constexpr u32 NUM_MODES = static_cast<u32>(AddressingMode::Count);
+
+    u64 Instructions = 0;
+    u64 PerOpcode[256] = {};
+    u64 PageCrossings[NUM_MODES] = {};
+    u64 StackPushes = 0; // bytes pushed
+    u64 StackPops = 0;   // bytes pulled
+    u64 ReadsPerPage[NUM_PAGES] = {};
+    u64 WritesPerPage[NUM_PAGES] = {};
+
+    // Retired instructions using a given addressing mode
+    u64 InstructionsWithMode(AddressingMode Mode) const;
+
+    // Reads / writes within [First, Last] rounded out to whole pages
+    u64 ReadsInRegion(Word First, Word Last) const;
+    u64 WritesInRegion(Word First, Word Last) const;
+};
+
+struct cpu6502::InstructionCounters : cpu6502::Observer
+{
+    CounterSnapshot Counts;
+
+    // Copy of the counters, safe to keep while execution goes on. Owning
+    // thread only, between Execute calls.
+    CounterSnapshot Snapshot() const { return Counts; }
+
+    // Owning thread, between Execute calls: makes the current counts what
+    // ReadPublished returns. A seqlock, the writer never waits.
+    void Publish();
+
+    // Any thread: the counts as of the last Publish, never torn
+    CounterSnapshot ReadPublished() const;
+
+    void Clear() { Counts = CounterSnapshot(); }
+
+    void OnInstruction(const CPU & /*cpu*/, Word /*PC*/, Byte Opcode, u64 /*Cycle*/) override
+    {
+        Counts.Instructions++;
+        Counts.PerOpcode[Opcode]++;
+    }
+
+    void OnRead(Word Address, Byte /*Value*/, u64 /*Cycle*/) override
+    {
+        Counts.ReadsPerPage[Address >> 8]++;
+    }
+
+    void OnWrite(Word Address, Byte /*Value*/, u64 /*Cycle*/) override
+    {
+        Counts.WritesPerPage[Address >> 8]++;
+    }
+
+    void OnPageCross(AddressingMode Mode) override
+    {
+        Counts.PageCrossings[static_cast<u32>(Mode)]++;
+    }
+
+    void OnStackPush() override { Counts.StackPushes++; }
+
+    void OnStackPop() override { Counts.StackPops++; }
+
+private:
+    static constexpr u32 WORDS = sizeof(CounterSnapshot) / sizeof(u64);
+
+    // Odd while Publish is writing
+    std::atomic<u32> Sequence{0};
+    std::atomic<u64> Published[WORDS] = {};
+};
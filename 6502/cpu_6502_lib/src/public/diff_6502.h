@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "main_6502.h"
+
+// Machine state comparison for differential testing and lockstep runs.
+// Memory is compared a page at a time with SSE2 / AVX2 (picked at run
+// time) into a bitmask of differing bytes, which is turned into ranges.
+// Given checkpoints (Mem::Checkpoint) taken while both sides were equal,
+// only pages either side has written since are looked at.
+
+namespace cpu6502
+{
+    struct MemRange;
+    struct StateDiff;
+
+    // Differing byte ranges of A and B in address order. SinceA / SinceB
+    // skip pages neither side wrote after those checkpoints, 0 compares all.
+    std::vector<MemRange> DiffMemory(const Mem &A, const Mem &B, u32 SinceA = 0, u32 SinceB = 0);
+
+    StateDiff CompareState(const CPU &CpuA, const Mem &MemA, const CPU &CpuB, const Mem &MemB, u32 SinceA = 0,
+                           u32 SinceB = 0);
+}
+
+struct cpu6502::MemRange
+{
+    Word Address;
+    u32 Length;
+
+    bool operator==(const MemRange &Other) const { return Address == Other.Address && Length == Other.Length; }
+};
+
+struct cpu6502::StateDiff
+{
+    // Registers bits
+    static constexpr u32 PC = 0x01, SP = 0x02, A = 0x04, X = 0x08, Y = 0x10, PS = 0x20, CYCLES = 0x40,
+                         INTERRUPTS = 0x80;
+
+    u32 Registers = 0;
+    std::vector<MemRange> Memory;
+
+    bool Equal() const { return Registers == 0 && Memory.empty(); }
+
+    // One line per difference, "PC $0203 / $0205", "$0300-$0302 3 bytes: 01 02 03 / 00 00 00"
+    std::string Describe(const CPU &CpuA, const Mem &MemA, const CPU &CpuB, const Mem &MemB) const;
+};
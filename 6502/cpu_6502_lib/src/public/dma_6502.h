@@ -0,0 +1,37 @@
+#pragma once
+#include "main_6502.h"
+
+// Sprite style DMA controller: writing a page number P to its register
+// copies the 256 bytes at $P00 to Target and halts the CPU for the
+// transfer, 513 cycles plus one when started on an odd cycle. The copy is
+// done in bulk - a memcpy for RAM, Device::WriteBlock for a mapped target -
+// and only falls back to byte reads for a source page owned by a device.
+// Observer / Debugger hooks do not see the transferred bytes.
+
+namespace cpu6502
+{
+    struct DMA;
+}
+
+struct cpu6502::DMA : cpu6502::Device
+{
+    static constexpr u32 PAGE_SIZE = 256;
+    static constexpr u32 STALL_CYCLES = 513;
+
+    DMA(CPU &Target, Mem &Memory, Word Destination) : cpu(Target), memory(Memory), Target(Destination) {}
+
+    u64 Transfers = 0;
+
+    // Copies page Page to Target and stalls the CPU, Cycle is when it starts
+    void Start(Byte Page, u64 Cycle);
+
+    // Write-only register
+    Byte Read(Word /*Address*/, u64 /*Cycle*/) override { return 0xFF; }
+    void Write(Word /*Address*/, Byte Value, u64 Cycle) override { Start(Value, Cycle); }
+    bool StableRead(Word /*Address*/) const override { return true; }
+
+private:
+    CPU &cpu;
+    Mem &memory;
+    Word Target;
+};
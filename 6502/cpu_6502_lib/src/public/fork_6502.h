@@ -0,0 +1,69 @@
+#pragma once
+#include <memory>
+#include "main_6502.h"
+
+// Cheap forks of a CPU + RAM for tree search over inputs. A Machine is the
+// registers plus a table of shared, immutable 256 byte pages, so Fork
+// copies the registers and 256 pointers and never touches page contents.
+// Children only own the pages they changed.
+//
+// Machines run in a ForkRunner, which owns a real Mem. Loading a Machine
+// copies just the pages that differ from the ones the runner last held,
+// and storing it back turns the pages written since (Mem write epochs)
+// into new private pages. Siblings run back to back in one runner
+// therefore cost a few page copies each.
+//
+// Only the CPU and RAM are forked: devices mapped into the runner's Mem
+// keep one state, and pokes through operator[] / Data are not stored back.
+
+namespace cpu6502
+{
+    struct Machine;
+    struct ForkRunner;
+}
+
+struct cpu6502::Machine
+{
+    struct Page
+    {
+        Byte Bytes[256];
+    };
+
+    CPU cpu;
+    // nullptr reads as zeros
+    std::shared_ptr<const Page> Pages[Mem::NUM_PAGES];
+
+    // Takes every page of memory, all-zero pages stay nullptr
+    static Machine Capture(const CPU &State, const Mem &memory);
+
+    Machine Fork() const { return *this; }
+
+    // Pages this machine does not share with Other
+    u32 PagesNotSharedWith(const Machine &Other) const;
+};
+
+struct cpu6502::ForkRunner
+{
+    // Big, allocate runners on the heap
+    Mem memory;
+
+    u64 PagesCopied = 0; // Into memory by Load, for checking the page reuse
+
+    ForkRunner();
+
+    // Makes memory hold Target's RAM
+    void Load(const Machine &Target);
+
+    // Writes the pages written since Load (or the last Store) into Target,
+    // which should be the Machine loaded
+    void Store(Machine &Target);
+
+    // Load, Execute Target.cpu, Store
+    ExecuteResult Run(Machine &Target, s32 Cycles);
+
+private:
+    // What memory holds, kept alive so a freed page's address can't be
+    // reused by another page and pass for it
+    std::shared_ptr<const Machine::Page> Loaded[Mem::NUM_PAGES];
+    u32 Since = 0;
+};
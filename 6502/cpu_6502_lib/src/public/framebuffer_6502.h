@@ -0,0 +1,83 @@
+#pragma once
+#include <stdio.h>
+#include <vector>
+#include "main_6502.h"
+#include "scheduler_6502.h"
+#include "spsc_6502.h"
+
+// Headless memory mapped framebuffer, one byte (a palette index) per pixel,
+// row major from Base. Map it with memory.Map(&fb, Base, Base + Width * Height - 1).
+//
+// Writes mark the 8x8 tile they land in dirty. Every FrameCycles a vertical
+// blank event hands the host a Frame: the screen hash and a copy of the
+// smallest rectangle holding every tile changed since the last frame.
+// Only dirty tiles are rehashed, so an idle screen costs a few bit tests
+// per frame. Frames go through a lock-free ring, a host thread can encode
+// them (WritePPM) while the emulator keeps running.
+
+namespace cpu6502
+{
+    struct Framebuffer;
+}
+
+struct cpu6502::Framebuffer : cpu6502::Device
+{
+    static constexpr u32 TILE = 8;
+    static constexpr u32 FRAME_QUEUE = 8;
+
+    struct Frame
+    {
+        u64 Number = 0;
+        u64 Cycle = 0;  // Vertical blank it was taken at
+        u64 Hash = 0;   // Whole screen
+        // Dirty rectangle in pixels, Width == 0 when nothing changed
+        u32 X = 0, Y = 0, Width = 0, Height = 0;
+        std::vector<Byte> Pixels; // Width * Height, row major
+    };
+
+    // Tiles on the right / bottom edge are cut short when Width / Height
+    // are not multiples of TILE. The first frame is taken at cycle
+    // FrameCycles and covers the whole screen.
+    Framebuffer(Scheduler &Clock, Word Start, u32 Columns, u32 Rows, u32 Period);
+    ~Framebuffer() override;
+
+    const Word Base;
+    const u32 Width, Height;
+    const u32 FrameCycles;
+
+    u64 Frames = 0;        // Vertical blanks so far
+    u64 DroppedFrames = 0; // Host fell behind, their dirty tiles carry over
+    u64 Hash = 0;          // As of the last vertical blank
+
+    // Host side: oldest frame not taken yet
+    bool NextFrame(Frame &Out) { return Output.Pop(Out); }
+
+    // Writes the dirty rectangle of Image as a binary PPM, Palette maps a
+    // pixel to 0xRRGGBB (grey ramp when null). False when there is nothing to write.
+    static bool WritePPM(FILE *File, const Frame &Image, const u32 *Palette = nullptr);
+
+    // Pixel at X, Y as the guest last wrote it
+    Byte Pixel(u32 X, u32 Y) const { return Pixels[Y * Width + X]; }
+
+    Byte Read(Word Address, u64 Cycle) override;
+    void Write(Word Address, Byte Value, u64 Cycle) override;
+    void WriteBlock(Word Address, const Byte *Data, u32 Count, u64 Cycle) override;
+    bool StableRead(Word /*Address*/) const override { return true; }
+
+private:
+    Scheduler &Events;
+    Scheduler::EventId Pending = 0;
+
+    const u32 TilesX, TilesY;
+    std::vector<Byte> Pixels;
+    // One bit per tile: changed since the last frame handed out / since
+    // the last rehash
+    std::vector<u64> Dirty, Rehash;
+    std::vector<u64> TileHashes;
+
+    SpscRing<Frame, FRAME_QUEUE> Output;
+
+    void Touch(u32 Offset);
+    void VBlank(u64 Cycle);
+    u64 HashTile(u32 Tile) const;
+};
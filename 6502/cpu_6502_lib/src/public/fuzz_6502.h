@@ -0,0 +1,82 @@
+#pragma once
+#include "main_6502.h"
+
+// Persistent mode fuzzing: the guest is booted once, Snapshot records the
+// CPU and RAM, and every Run puts the snapshot back, copies the fuzz input
+// into a guest buffer and executes under a cycle limit. Putting the
+// snapshot back only copies the pages written since the previous run (Mem
+// write epochs), a few hundred bytes for a typical parser, instead of a
+// Reset and reload of the whole image.
+//
+// Guest edges (branches, jumps, calls, returns, interrupts) are counted in
+// an AFL layout bitmap, see CPU::Coverage. It can be pointed at the
+// fuzzer's own map so AFL / libFuzzer see guest coverage directly.
+//
+// The guest ends a run with INS_HOST_CALL. JAM and illegal opcodes are
+// crashes, running out of cycles is a timeout. Devices mapped into memory
+// are not part of the snapshot and pokes through operator[] / Data after
+// Snapshot are not undone.
+
+namespace cpu6502
+{
+    struct FuzzTarget;
+}
+
+struct cpu6502::FuzzTarget
+{
+    static constexpr u32 NO_LENGTH = 0x10000;
+
+    enum class Outcome : Byte
+    {
+        Finished, // INS_HOST_CALL
+        Timeout,  // CycleLimit ran out
+        Crashed   // JAM or illegal opcode
+    };
+
+    struct Options
+    {
+        Word InputAddress = 0x0400;
+        u32 MaxInput = 0x0400;         // longer inputs are cut
+        u32 LengthAddress = NO_LENGTH; // the input length as a little endian word, or NO_LENGTH
+        s32 CycleLimit = 1000000;
+    };
+
+    // Big, allocate targets on the heap. Load the program into cpu and
+    // memory (run any boot code too), then Snapshot.
+    CPU cpu;
+    Mem memory;
+    Options Config;
+
+    // Where edges are counted: Bitmap unless pointed at the fuzzer's map,
+    // which must hold CPU::COVERAGE_SIZE counters, or nullptr for none.
+    // Runs only add to it.
+    Byte Bitmap[CPU::COVERAGE_SIZE] = {};
+    Byte *Map = Bitmap;
+
+    ExecuteResult Last = {};   // How the last run stopped
+    u64 Runs = 0;
+    u64 PagesRestored = 0;     // Copied back from the snapshot, for checking the restore cost
+
+    FuzzTarget() = default;
+    FuzzTarget(const FuzzTarget &) = delete;
+    FuzzTarget &operator=(const FuzzTarget &) = delete;
+
+    // Makes the current cpu and memory what every run starts from
+    void Snapshot();
+
+    // Restores the snapshot, writes Data, runs. memory and cpu are left as
+    // the run ended for inspection until the next Run.
+    Outcome Run(const Byte *Data, size_t Size);
+
+    void ClearCoverage();
+
+    // Non-zero counters in Map, 0 without one
+    u32 EdgesHit() const;
+
+private:
+    CPU Start;
+    Byte Pristine[Mem::MAX_MEM] = {};
+    u32 Since = 0;
+
+    void Restore();
+};
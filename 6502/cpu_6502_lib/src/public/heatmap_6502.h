@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include "main_6502.h"
+
+// Guest memory access heatmap. Counts reads, writes and instruction
+// executions per page, and optionally per byte, and exports them as a
+// 256x256 image (PPM) or grid (CSV). In the image row = high byte and
+// column = low byte of the address; red = writes, green = reads,
+// blue = executes, each on a log scale.
+
+namespace cpu6502
+{
+    enum class HeatmapKind : Byte
+    {
+        Reads,
+        Writes,
+        Executes,
+        All
+    };
+
+    struct MemoryHeatmap;
+}
+
+struct cpu6502::MemoryHeatmap : cpu6502::Observer
+{
+    static constexpr u32 NUM_PAGES = Mem::MAX_MEM / 256;
+    static constexpr u32 IMAGE_SIZE = 256;
+
+    // Per-byte counters cost 768 KB, per-page counters are always kept
+    explicit MemoryHeatmap(bool PerByte = false);
+
+    bool PerByte;
+
+    u64 PageReads[NUM_PAGES] = {};
+    u64 PageWrites[NUM_PAGES] = {};
+    u64 PageExecutes[NUM_PAGES] = {};
+
+    // Empty unless PerByte
+    std::vector<u32> ByteReads;
+    std::vector<u32> ByteWrites;
+    std::vector<u32> ByteExecutes;
+
+    void Clear();
+
+    // Count for one cell of the 256x256 grid. Without per-byte counters every
+    // page becomes a 16x16 block, pages laid out 16 per row.
+    u64 Cell(u32 Row, u32 Column, HeatmapKind Kind) const;
+
+    // Binary PPM (P6), returns false on I/O errors
+    bool WritePPM(const char *Path) const;
+
+    // 256 lines of 256 comma separated counts
+    bool WriteCSV(const char *Path, HeatmapKind Kind = HeatmapKind::All) const;
+
+    void OnInstruction(const CPU &cpu, Word PC, Byte Opcode, u64 Cycle) override;
+    void OnRead(Word Address, Byte Value, u64 Cycle) override;
+    void OnWrite(Word Address, Byte Value, u64 Cycle) override;
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "main_6502.h"
+
+// Program image loading without byte-at-a-time pokes. The file is mapped
+// into memory (read in one go where mmap is not available) and parsed into
+// segments that point straight into the mapping; only Intel HEX needs its
+// bytes decoded. Segments are then either copied into Mem with one memcpy
+// each, or served from the mapping by a RomDevice.
+//
+// Formats:
+//   Raw       the whole file at a given address
+//   Prg       Commodore style, a little endian load address then the bytes
+//   IntelHex  data, EOF, extended address and start address records
+//   O65       non-relocatable use of an o65 object: text and data at their
+//             assembled bases, bss zeroed. 32 bit objects are rejected.
+
+namespace cpu6502
+{
+    struct MappedFile;
+    struct ProgramImage;
+    struct RomDevice;
+
+    enum class ImageFormat : Byte
+    {
+        Detect, // o65 by its magic, then by extension: .hex / .ihx, .prg, else raw
+        Raw,
+        Prg,
+        IntelHex,
+        O65
+    };
+}
+
+struct cpu6502::MappedFile
+{
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&Other) noexcept;
+    MappedFile &operator=(MappedFile &&Other) noexcept;
+    ~MappedFile() { Close(); }
+
+    bool Open(const char *Path);
+    void Close();
+
+    const Byte *Data = nullptr;
+    size_t Size = 0;
+
+private:
+    bool Mapped = false; // else Data was allocated
+};
+
+struct cpu6502::ProgramImage
+{
+    struct Segment
+    {
+        Word Address;
+        u32 Size;
+        const Byte *Data; // nullptr for a zero filled segment (o65 bss)
+    };
+
+    std::vector<Segment> Segments;
+    bool HasStart = false;
+    Word Start = 0; // Entry point: load address, o65 text base or HEX start record
+
+    ProgramImage() = default;
+    ProgramImage(const ProgramImage &) = delete;
+    ProgramImage &operator=(const ProgramImage &) = delete;
+    ProgramImage(ProgramImage &&) = default;
+    ProgramImage &operator=(ProgramImage &&) = default;
+
+    // Maps Path and parses it. RawAddress is where a raw image goes.
+    // On failure Error (if given) says why.
+    bool Open(const char *Path, ImageFormat Format = ImageFormat::Detect, Word RawAddress = 0,
+              std::string *Error = nullptr);
+
+    // Parses an image already in memory, which must outlive this
+    bool Parse(const Byte *Data, size_t Size, ImageFormat Format, Word RawAddress = 0, std::string *Error = nullptr);
+
+    // Copies every segment into RAM, one memcpy each
+    void CopyTo(Mem &memory) const;
+
+    // Resets the CPU and memory to run from Start (or the CPU's default
+    // without one), then CopyTo
+    void Load(CPU &cpu, Mem &memory) const;
+
+private:
+    MappedFile File;
+    std::vector<Byte> Decoded; // Intel HEX payload, Segments point into it
+
+    bool ParsePrg(const Byte *Data, size_t Size, std::string &Error);
+    bool ParseIntelHex(const Byte *Data, size_t Size, std::string &Error);
+    bool ParseO65(const Byte *Data, size_t Size, std::string &Error);
+    bool Add(u32 Address, u32 Size, const Byte *Data, std::string &Error);
+};
+
+// Read only memory served straight from an image segment, for data the
+// guest reads with load instructions. Opcode fetches do not go through
+// devices, code has to be copied into Mem (ProgramImage::CopyTo).
+struct cpu6502::RomDevice : cpu6502::Device
+{
+    explicit RomDevice(const ProgramImage::Segment &Contents) : Contents(Contents) {}
+
+    // Maps the pages the segment covers, addresses outside it read $FF
+    void MapInto(Mem &memory) { memory.Map(this, Contents.Address, static_cast<Word>(Contents.Address + Contents.Size - 1)); }
+
+    Byte Read(Word Address, u64 /*Cycle*/) override
+    {
+        u32 Offset = static_cast<Word>(Address - Contents.Address);
+        if (Offset >= Contents.Size)
+            return 0xFF;
+        return Contents.Data ? Contents.Data[Offset] : 0;
+    }
+    void Write(Word /*Address*/, Byte /*Value*/, u64 /*Cycle*/) override {}
+    bool StableRead(Word /*Address*/) const override { return true; }
+
+private:
+    ProgramImage::Segment Contents;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -9,21 +10,122 @@
 namespace cpu6502
 {
     using Byte = unsigned char;  // 8 bits
+    using SByte = signed char;   // 8 bits - branch offsets
     using Word = unsigned short; // 16 bits
+    using s16 = signed short;    // 16 bits - PCM samples
 
     using u32 = unsigned int;
     using s32 = signed int;
+    using u64 = unsigned long long;
     struct Mem;
+    struct Device;
     struct CPU;
     struct ProcessorFlags;
+    struct Observer;
+    struct Debugger;
+    struct DecimalTables;
+    struct ExecuteResult;
+
+    enum class AddressingMode : Byte
+    {
+        Implied,
+        Accumulator,
+        Immediate,
+        ZeroPage,
+        ZeroPageX,
+        ZeroPageY,
+        Absolute,
+        AbsoluteX,
+        AbsoluteY,
+        Indirect,
+        IndirectX,
+        IndirectY,
+        Relative,
+        Count
+    };
+
+    // How Mem's bulk operations treat pages mapped to a device
+    enum class MemView : Byte
+    {
+        RAM, // what operator[] and opcode fetches see
+        Bus  // what the CPU sees: device pages go to the device
+    };
+
+    // Why Execute returned
+    enum class StopReason : Byte
+    {
+        BudgetExhausted, // ran at least the requested cycles
+        IllegalOpcode,   // undocumented opcode, nothing of it was executed
+        Breakpoint,
+        HostCall,        // INS_HOST_CALL, the call number follows the opcode
+        Halted,          // JAM opcode, the CPU is stuck on it
+        DeviceAccess     // a SuspendingDevice was accessed, only RunCoroutine stops for it
+    };
 }
 
+struct cpu6502::Device
+{
+    // Memory mapped I/O - see Mem::Map. Address is the full CPU address,
+    // Cycle the absolute cycle of the access.
+    virtual ~Device() = default;
+
+    virtual Byte Read(Word Address, u64 Cycle) = 0;
+
+    virtual void Write(Word Address, Byte Value, u64 Cycle) = 0;
+
+    // Bulk write from DMA, Count bytes from Address on, all within one page
+    virtual void WriteBlock(Word Address, const Byte *Data, u32 Count, u64 Cycle)
+    {
+        for (u32 i = 0; i < Count; i++)
+        {
+            Write(static_cast<Word>(Address + i), Data[i], Cycle);
+        }
+    }
+
+    // Reading Address has no side effects and its value only changes at
+    // scheduler events, so a guest loop polling it may be fast-forwarded
+    virtual bool StableRead(Word /*Address*/) const { return false; }
+};
+
 struct cpu6502::Mem
 {
 
     static constexpr u32 MAX_MEM = 1024 * 64;
+    static constexpr u32 NUM_PAGES = MAX_MEM / 256;
     Byte Data[MAX_MEM];
 
+    // Device owning each 256 byte page, if any. Only CPU data accesses
+    // (CPU::ReadByte / WriteByte) go to devices, operator[] and opcode
+    // fetches always see RAM. Mappings survive Init.
+    Device *IO[NUM_PAGES] = {};
+
+    void Map(Device *Target, Word First, Word Last)
+    {
+        // Whole pages from First's to Last's
+        for (u32 Page = First >> 8; Page <= u32(Last >> 8); Page++)
+        {
+            IO[Page] = Target;
+        }
+    }
+
+    void Unmap(Word First, Word Last)
+    {
+        Map(nullptr, First, Last);
+    }
+
+    // Dirty tracking: CPU writes to RAM and the bulk writes below stamp
+    // their page with the current Epoch. A page was written since
+    // checkpoint E when PageEpoch[Page] >= E, so any number of users can
+    // track changes independently. Pokes through operator[] or Data are
+    // not seen.
+    u32 Epoch = 1;
+    u32 PageEpoch[NUM_PAGES] = {};
+
+    // Starts a new epoch and returns it
+    u32 Checkpoint() { return ++Epoch; }
+
+    bool WrittenSince(u32 Page, u32 Since) const { return PageEpoch[Page] >= Since; }
+
     void Init()
     {
         //  cleans Data array;
@@ -31,8 +133,22 @@ struct cpu6502::Mem
         {
             Data[i] = 0;
         }
+        for (u32 &Page : PageEpoch)
+        {
+            Page = Epoch;
+        }
     }
 
+    // Bulk host access to Count bytes (up to MAX_MEM) from Address on,
+    // wrapping from $FFFF to $0000. In the Bus view device pages are read
+    // and written through the device at Cycle, reads may have side effects.
+    void ReadBlock(Word Address, Byte *Out, u32 Count, MemView View = MemView::RAM, u64 Cycle = 0) const;
+    void WriteBlock(Word Address, const Byte *Source, u32 Count, MemView View = MemView::RAM, u64 Cycle = 0);
+    void Fill(Word Address, Byte Value, u32 Count, MemView View = MemView::RAM, u64 Cycle = 0);
+
+    // Offset of the first RAM byte differing from Other, Count when they all match
+    u32 Compare(Word Address, const Byte *Other, u32 Count) const;
+
     Byte operator[](u32 Address) const
     {
         // Read one byte
@@ -61,6 +177,89 @@ struct cpu6502::ProcessorFlags
     Byte N : 1;
 };
 
+struct cpu6502::ExecuteResult
+{
+    s32 Cycles;        // Cycles used
+    StopReason Reason;
+    Word PC;           // Instruction that stopped execution (next one when the budget ran out)
+    Byte Opcode;       // Opcode at PC
+};
+
+struct cpu6502::DecimalTables
+{
+    // Decimal mode ADC / SBC results for every (A, operand, carry) so the
+    // CPU never runs the digit-by-digit adjustment. Each entry holds the new
+    // A in the low byte and the NMOS C, Z, V, N flags in the high byte.
+    static constexpr u32 ENTRIES = 2 * 256 * 256;
+    static constexpr Byte FLAGS = 0b11000011; // N V - - - - Z C
+
+    Word Add[ENTRIES];
+    Word Subtract[ENTRIES];
+
+    // Built on first use
+    static const DecimalTables &Get();
+
+    static u32 Index(Byte A, Byte Operand, Byte Carry)
+    {
+        return (Carry << 16) | (A << 8) | Operand;
+    }
+
+    // The digit-by-digit reference the tables are built from
+    static Word AddBranchy(Byte A, Byte Operand, Byte Carry);
+    static Word SubtractBranchy(Byte A, Byte Operand, Byte Carry);
+};
+
+struct cpu6502::Observer
+{
+    // Instrumentation interface - attach one to CPU::Hooks to be notified
+    // about every instruction and memory access. Nothing is called (and
+    // nothing is paid for beyond a null check) when no observer is attached.
+    virtual ~Observer() = default;
+
+    // Called before the opcode at PC is fetched
+    virtual void OnInstruction(const CPU & /*cpu*/, Word /*PC*/, Byte /*Opcode*/, u64 /*Cycle*/) {}
+
+    virtual void OnRead(Word /*Address*/, Byte /*Value*/, u64 /*Cycle*/) {}
+
+    virtual void OnWrite(Word /*Address*/, Byte /*Value*/, u64 /*Cycle*/) {}
+
+    // An indexed access crossed a page and paid the extra cycle
+    virtual void OnPageCross(AddressingMode /*Mode*/) {}
+
+    // One byte pushed to / pulled from the stack
+    virtual void OnStackPush() {}
+    virtual void OnStackPop() {}
+};
+
+struct cpu6502::Debugger
+{
+    // Breakpoint / watchpoint interface - attach one to CPU::Debug. The CPU
+    // only calls into it for pages whose flag is set, any other page costs a
+    // table lookup and a branch.
+    static constexpr Byte EXECUTE = 0b001, READ = 0b010, WRITE = 0b100;
+    static constexpr u32 NO_PC = 0x10000;
+
+    Byte PageFlags[256] = {};
+
+    // Set by OnRead / OnWrite to stop Execute before the next instruction
+    bool Triggered = false;
+
+    // Instruction being executed, valid inside OnRead / OnWrite
+    Word InstructionPC = 0;
+
+    // Breakpoint Execute last stopped on, skipped once when resuming there
+    u32 ResumePC = NO_PC;
+
+    virtual ~Debugger() = default;
+
+    // Should execution stop before the instruction at cpu.PC?
+    virtual bool BreakAt(const CPU & /*cpu*/, const Mem & /*memory*/) { return false; }
+
+    virtual void OnRead(const CPU & /*cpu*/, const Mem & /*memory*/, Word /*Address*/, Byte /*Value*/) {}
+
+    virtual void OnWrite(const CPU & /*cpu*/, const Mem & /*memory*/, Word /*Address*/, Byte /*Value*/) {}
+};
+
 struct cpu6502::CPU
 {
 
@@ -77,16 +276,98 @@ struct cpu6502::CPU
         ProcessorFlags flags;
     };
 
+    u64 CycleCount = 0;         // Cycles executed since Reset
+    u64 SliceEndCycle = 0;      // CycleCount at which the running Execute budget runs out
+    Observer *Hooks = nullptr;  // Optional instrumentation (trace, profilers...)
+    Debugger *Debug = nullptr;  // Optional breakpoints / watchpoints
+
+    // Fast-forward loops that wait for something that cannot happen before
+    // the budget runs out, see IsIdleLoop. Never with Hooks, Debug or
+    // Coverage attached, skipped trips would not be seen there.
+    bool SkipIdleLoops = true;
+    u64 IdleCyclesSkipped = 0;  // Cycles fast-forwarded since Reset
+    u64 VolatileReads = 0;      // Device reads that are not StableRead, a loop doing them is never idle
+
+    // AFL style edge coverage: every branch (taken or not), jump, call,
+    // return and interrupt bumps Coverage[Location ^ PreviousLocation], where
+    // Location is a hash of the PC it lands on. Off while Coverage is null,
+    // otherwise it must point at COVERAGE_SIZE counters.
+    static constexpr u32 COVERAGE_SIZE = 1u << 16;
+    Byte *Coverage = nullptr;
+    u32 PreviousLocation = 0;
+
+    // Interrupt inputs. IRQ is level triggered with one bit per source, NMI
+    // is an edge that stays pending until taken. Set them through SetIRQ /
+    // TriggerNMI from the emulation thread (devices, Scheduler events),
+    // other threads use PostIRQ / PostNMI.
+    u32 IRQLines = 0;
+    bool NMIPending = false;
+
+    // Lines driven by other threads: IRQ sources in the low 32 bits and
+    // HOST_NMI. Execute copies them in when it starts, so they are seen at
+    // the next slice (every Scheduler slice is one).
+    static constexpr u64 HOST_NMI = 1ull << 32;
+    struct HostInterrupts
+    {
+        std::atomic<u64> Lines{0};
+
+        HostInterrupts() = default;
+        HostInterrupts(const HostInterrupts &Other) : Lines(Other.Lines.load()) {}
+        HostInterrupts &operator=(const HostInterrupts &Other)
+        {
+            Lines = Other.Lines.load();
+            return *this;
+        }
+    } Host;
+    u32 HostIRQLines = 0; // Host IRQ sources as of the running Execute
+
+    // NMOS: CLI / PLP clearing I only lets an IRQ in after the next
+    // instruction, and then even if that one set I again
+    enum class IRQDelay : Byte
+    {
+        None,
+        AfterNext, // I was just cleared
+        Now        // the next instruction has run, take it
+    } PendingIRQDelay = IRQDelay::None;
+
+    // Budget parked by RequestInterruptCheck / given up by EndSliceAt while Execute is running
+    s32 *RunningCycles = nullptr;
+    s32 DeferredCycles = 0;
+    s32 ForfeitedCycles = 0;
+
+    // A Stall during Execute runs at most up to StallLimit (Scheduler::RunSlice
+    // sets it to the next event, EndSliceAt lowers it), the rest is owed and
+    // taken first by the next Execute, so events due while the CPU is
+    // halted still fire on their cycle
+    u64 StallLimit = ~0ull;
+    u64 StallOwed = 0;
+
     void Reset(Mem &memory, Word ResetVector = 0)
     {
         // Use 0xFFFC as default reset vector
         PC = (ResetVector) ? ResetVector : 0xFFFC;
         SP = 0xFF; // system stack ($0100-$01FF)
         A = X = Y = 0;
+        CycleCount = 0;
+        IdleCyclesSkipped = 0;
+        IRQLines = 0;
+        NMIPending = false;
+        Host.Lines = 0;
+        HostIRQLines = 0;
+        PendingIRQDelay = IRQDelay::None;
+        StallOwed = 0;
+        PreviousLocation = 0;
         flags.C = flags.Z = flags.I = flags.D = flags.B = flags.V = flags.N = 0;
         memory.Init();
     }
 
+    void RecordEdge()
+    {
+        u32 Location = (PC * 0x9E3779B1u) >> 16;
+        Coverage[Location ^ PreviousLocation]++;
+        PreviousLocation = Location >> 1;
+    }
+
     Byte Fetch_Byte(s32 &Cycles, Mem &memory)
     {
         Byte Data = memory[PC];
@@ -108,19 +389,49 @@ struct cpu6502::CPU
         return Data;
     }
 
+    u64 CurrentCycle(s32 Cycles) const
+    {
+        // Absolute cycle count while Execute is running
+        return SliceEndCycle - Cycles;
+    }
+
     Byte ReadByte(s32 &Cycles, Mem &memory, Word Address)
     {
-        Byte Data = memory[Address];
+        Device *IO = memory.IO[Address >> 8];
+        Byte Data = IO ? ReadDevice(Cycles, IO, Address) : memory[Address];
+        if (Hooks)
+            Hooks->OnRead(Address, Data, CurrentCycle(Cycles));
+        if (Debug && (Debug->PageFlags[Address >> 8] & Debugger::READ))
+            Debug->OnRead(*this, memory, Address, Data);
         Cycles--;
         return Data;
     }
 
     void WriteByte(Byte Value, u32 Address, s32 &Cycles, Mem &memory)
     {
-        memory[Address] = Value;
+        if (Device *IO = memory.IO[(Address >> 8) & 0xFF])
+        {
+            IO->Write(static_cast<Word>(Address), Value, CurrentCycle(Cycles));
+        }
+        else
+        {
+            memory[Address] = Value;
+            memory.PageEpoch[(Address >> 8) & 0xFF] = memory.Epoch;
+        }
+        if (Hooks)
+            Hooks->OnWrite(Address, Value, CurrentCycle(Cycles));
+        if (Debug && (Debug->PageFlags[(Address >> 8) & 0xFF] & Debugger::WRITE))
+            Debug->OnWrite(*this, memory, static_cast<Word>(Address), Value);
         Cycles--;
     }
 
+    Byte ReadDevice(s32 &Cycles, Device *IO, Word Address)
+    {
+        if (!IO->StableRead(Address))
+            VolatileReads++;
+        return IO->Read(Address, CurrentCycle(Cycles));
+    }
+
     Word ReadWord(s32 &Cycles, Mem &memory, Word Address)
     {
         Byte LowByte = ReadByte(Cycles, memory, Address);
@@ -131,9 +442,8 @@ struct cpu6502::CPU
     void WriteWord(Word Value, u32 Address, s32 &Cycles, Mem &memory)
     {
         // Write two bytes
-        memory[Address] = Value & 0xFF;     // get first byte
-        memory[Address + 1] = (Value >> 8); // get second byte
-        Cycles -= 2;                        // Cycles pass by value;
+        WriteByte(Value & 0xFF, Address, Cycles, memory);     // get first byte
+        WriteByte(Value >> 8, Address + 1, Cycles, memory);   // get second byte
     }
 
     Word SPTo16Address() const
@@ -144,6 +454,11 @@ struct cpu6502::CPU
 
     void PushWordToStack(s32 &Cycles, Mem &memory, Word Value)
     {
+        if (Hooks)
+        {
+            Hooks->OnStackPush();
+            Hooks->OnStackPush();
+        }
         // MSB
         WriteByte(Value >> 8, SPTo16Address(), Cycles, memory);
         SP--;
@@ -160,6 +475,11 @@ struct cpu6502::CPU
 
     Word PopWordFromStack(s32 &Cycles, Mem &memory)
     {
+        if (Hooks)
+        {
+            Hooks->OnStackPop();
+            Hooks->OnStackPop();
+        }
         Word Value = ReadWord(Cycles, memory, SPTo16Address() + 1);
         SP += 2;
         Cycles--;
@@ -168,12 +488,16 @@ struct cpu6502::CPU
 
     void PushByteToStack(s32 &Cycles, Mem &memory, Byte Value)
     {
+        if (Hooks)
+            Hooks->OnStackPush();
         WriteByte(Value, SPTo16Address(), Cycles, memory);
         SP--;
     }
 
     Byte PopByteFromStack(s32 &Cycles, Mem &memory)
     {
+        if (Hooks)
+            Hooks->OnStackPop();
         Byte Value = ReadByte(Cycles, memory, SPTo16Address() + 1);
         SP++;
         Cycles--;
@@ -192,6 +516,47 @@ struct cpu6502::CPU
         flags.V = (Value & 0b01000000) > 0;
     }
 
+    void AddWithCarry(Byte Operand)
+    {
+        if (flags.D)
+        {
+            SetDecimalResult(DecimalTables::Get().Add[DecimalTables::Index(A, Operand, flags.C)]);
+            return;
+        }
+        u32 Sum = A + Operand + flags.C;
+        flags.V = (~(A ^ Operand) & (A ^ Sum) & 0x80) > 0;
+        flags.C = Sum > 0xFF;
+        A = static_cast<Byte>(Sum);
+        Set_Zero_and_Negative_Flags(A);
+    }
+
+    void SubtractWithCarry(Byte Operand)
+    {
+        if (flags.D)
+        {
+            SetDecimalResult(DecimalTables::Get().Subtract[DecimalTables::Index(A, Operand, flags.C)]);
+            return;
+        }
+        u32 Difference = A - Operand - (1 - flags.C);
+        flags.V = ((A ^ Operand) & (A ^ Difference) & 0x80) > 0;
+        flags.C = Difference < 0x100;
+        A = static_cast<Byte>(Difference);
+        Set_Zero_and_Negative_Flags(A);
+    }
+
+    void SetDecimalResult(Word Result)
+    {
+        // Low byte is the new A, high byte holds C Z V N in their PS positions
+        A = Result & 0xFF;
+        PS = (PS & ~DecimalTables::FLAGS) | (Result >> 8);
+    }
+
+    void CompareRegister(Byte Register, Byte Operand)
+    {
+        flags.C = Register >= Operand;
+        Set_Zero_and_Negative_Flags(static_cast<Byte>(Register - Operand));
+    }
+
     // Op Codes
     static constexpr Byte
         // Load Register
@@ -298,9 +663,143 @@ struct cpu6502::CPU
         INS_INX = 0xE8, // Increment X Register
         INS_INY = 0xC8, // Increment Y Register
         INS_DEX = 0xCA, // Decrement X Register
-        INS_DEY = 0x88; // Decrement Y Register
-
-    s32 Execute(s32 Cycles, Mem &memory);
+        INS_DEY = 0x88, // Decrement Y Register
+
+        // Arithmetic
+        INS_ADC_IM = 0x69,      // Add with Carry Immediate Mode
+        INS_ADC_ZERO_P = 0x65,  // Add with Carry Zero Page Mode
+        INS_ADC_ZERO_PX = 0x75, // Add with Carry Zero Page X Mode
+        INS_ADC_ABS = 0x6D,     // Add with Carry Absolute Mode
+        INS_ADC_ABS_X = 0x7D,   // Add with Carry Absolute X Mode
+        INS_ADC_ABS_Y = 0x79,   // Add with Carry Absolute Y Mode
+        INS_ADC_IND_X = 0x61,   // Add with Carry Inderect X Mode
+        INS_ADC_IND_Y = 0x71,   // Add with Carry Inderect Y Mode
+
+        INS_SBC_IM = 0xE9,      // Subtract with Carry Immediate Mode
+        INS_SBC_ZERO_P = 0xE5,  // Subtract with Carry Zero Page Mode
+        INS_SBC_ZERO_PX = 0xF5, // Subtract with Carry Zero Page X Mode
+        INS_SBC_ABS = 0xED,     // Subtract with Carry Absolute Mode
+        INS_SBC_ABS_X = 0xFD,   // Subtract with Carry Absolute X Mode
+        INS_SBC_ABS_Y = 0xF9,   // Subtract with Carry Absolute Y Mode
+        INS_SBC_IND_X = 0xE1,   // Subtract with Carry Inderect X Mode
+        INS_SBC_IND_Y = 0xF1,   // Subtract with Carry Inderect Y Mode
+
+        INS_CMP_IM = 0xC9,      // Compare Accumulator Immediate Mode
+        INS_CMP_ZERO_P = 0xC5,  // Compare Accumulator Zero Page Mode
+        INS_CMP_ZERO_PX = 0xD5, // Compare Accumulator Zero Page X Mode
+        INS_CMP_ABS = 0xCD,     // Compare Accumulator Absolute Mode
+        INS_CMP_ABS_X = 0xDD,   // Compare Accumulator Absolute X Mode
+        INS_CMP_ABS_Y = 0xD9,   // Compare Accumulator Absolute Y Mode
+        INS_CMP_IND_X = 0xC1,   // Compare Accumulator Inderect X Mode
+        INS_CMP_IND_Y = 0xD1,   // Compare Accumulator Inderect Y Mode
+
+        INS_CPX_IM = 0xE0,     // Compare X Immediate Mode
+        INS_CPX_ZERO_P = 0xE4, // Compare X Zero Page Mode
+        INS_CPX_ABS = 0xEC,    // Compare X Absolute Mode
+
+        INS_CPY_IM = 0xC0,     // Compare Y Immediate Mode
+        INS_CPY_ZERO_P = 0xC4, // Compare Y Zero Page Mode
+        INS_CPY_ABS = 0xCC,    // Compare Y Absolute Mode
+
+        // Shifts
+        INS_ASL = 0x0A,         // Arithmetic Shift Left Accumulator
+        INS_ASL_ZERO_P = 0x06,  // Arithmetic Shift Left Zero Page Mode
+        INS_ASL_ZERO_PX = 0x16, // Arithmetic Shift Left Zero Page X Mode
+        INS_ASL_ABS = 0x0E,     // Arithmetic Shift Left Absolute Mode
+        INS_ASL_ABS_X = 0x1E,   // Arithmetic Shift Left Absolute X Mode
+
+        INS_LSR = 0x4A,         // Logical Shift Right Accumulator
+        INS_LSR_ZERO_P = 0x46,  // Logical Shift Right Zero Page Mode
+        INS_LSR_ZERO_PX = 0x56, // Logical Shift Right Zero Page X Mode
+        INS_LSR_ABS = 0x4E,     // Logical Shift Right Absolute Mode
+        INS_LSR_ABS_X = 0x5E,   // Logical Shift Right Absolute X Mode
+
+        INS_ROL = 0x2A,         // Rotate Left Accumulator
+        INS_ROL_ZERO_P = 0x26,  // Rotate Left Zero Page Mode
+        INS_ROL_ZERO_PX = 0x36, // Rotate Left Zero Page X Mode
+        INS_ROL_ABS = 0x2E,     // Rotate Left Absolute Mode
+        INS_ROL_ABS_X = 0x3E,   // Rotate Left Absolute X Mode
+
+        INS_ROR = 0x6A,         // Rotate Right Accumulator
+        INS_ROR_ZERO_P = 0x66,  // Rotate Right Zero Page Mode
+        INS_ROR_ZERO_PX = 0x76, // Rotate Right Zero Page X Mode
+        INS_ROR_ABS = 0x6E,     // Rotate Right Absolute Mode
+        INS_ROR_ABS_X = 0x7E,   // Rotate Right Absolute X Mode
+
+        // Branches
+        INS_BCC = 0x90, // Branch if carry flag clear
+        INS_BCS = 0xB0, // Branch if carry flag set
+        INS_BEQ = 0xF0, // Branch if zero flag set
+        INS_BMI = 0x30, // Branch if negative flag set
+        INS_BNE = 0xD0, // Branch if zero flag clear
+        INS_BPL = 0x10, // Branch if negative flag clear
+        INS_BVC = 0x50, // Branch if overflow flag clear
+        INS_BVS = 0x70, // Branch if overflow flag set
+
+        // Status Flag Changes
+        INS_CLC = 0x18, // Clear carry flag
+        INS_CLD = 0xD8, // Clear decimal mode flag
+        INS_CLI = 0x58, // Clear interrupt disable flag
+        INS_CLV = 0xB8, // Clear overflow flag
+        INS_SEC = 0x38, // Set carry flag
+        INS_SED = 0xF8, // Set decimal mode flag
+        INS_SEI = 0x78, // Set interrupt disable flag
+
+        // System Functions
+        INS_BRK = 0x00, // Force an interrupt
+        INS_NOP = 0xEA, // No Operation
+        INS_RTI = 0x40, // Return from Interrupt
+
+        // Emulator traps
+        INS_HOST_CALL = 0x42; // Stop with StopReason::HostCall, followed by a call number byte (a JAM on NMOS)
+
+    ExecuteResult Execute(s32 Cycles, Mem &memory);
+
+    // Runs until CycleCount reaches Cycle, the last instruction may overshoot it
+    ExecuteResult RunUntil(u64 Cycle, Mem &memory);
+
+    // Assert / release the IRQ line for the given source bits
+    void SetIRQ(u32 Sources, bool Asserted);
+
+    void TriggerNMI();
+
+    // From any thread: assert / release host IRQ sources, raise an NMI.
+    // Taken up when the next Execute starts.
+    void PostIRQ(u32 Sources, bool Asserted)
+    {
+        if (Asserted)
+            Host.Lines.fetch_or(Sources, std::memory_order_release);
+        else
+            Host.Lines.fetch_and(~u64(Sources), std::memory_order_release);
+    }
+    void PostNMI() { Host.Lines.fetch_or(HOST_NMI, std::memory_order_release); }
+
+    // Makes a running Execute look at the interrupt lines once the current
+    // instruction is done. Interrupts are otherwise only checked when
+    // Execute starts, after CLI / PLP / RTI and when a line goes up.
+    void RequestInterruptCheck();
+
+    // Charges cycles the CPU spends halted (DMA) to the running Execute
+    // budget up to StallLimit, or straight to CycleCount outside Execute
+    void Stall(u32 StallCycles);
+
+    // Makes a running Execute return at the first instruction boundary at or
+    // after Cycle, for events scheduled while it runs
+    void EndSliceAt(u64 Cycle);
+
+    // Enters the NMI or IRQ handler if one is due, 7 cycles
+    bool TakeInterrupt(s32 &Cycles, Mem &memory);
+    bool IRQAsserted() const { return IRQLines | HostIRQLines; }
+    void ClearedInterruptMask(bool WasSet);
+
+    // Addressing mode of any documented NMOS opcode (Implied for the rest)
+    static AddressingMode AddressingModeOf(Byte Opcode);
+
+    // True when the loop from Head to the branch / jump at Tail back to Head
+    // can neither write memory nor leave Head..Tail other than by Tail
+    // falling through. Two trips round it that start with the same registers
+    // then mean it will go round identically until something else changes.
+    static bool IsIdleLoop(const Mem &memory, Word Head, Word Tail);
 
     Byte ZeroPageWithOffset(s32 &Cycles, Mem &memory, Byte &OffSet);
 
@@ -0,0 +1,52 @@
+#pragma once
+#include <map>
+#include <vector>
+#include "main_6502.h"
+#include "symbols_6502.h"
+
+// Sampling PC profiler. Every SamplePeriod cycles the current PC and the
+// guest call stack (rebuilt from JSR/RTS as they execute) are recorded.
+// Attach with cpu.Hooks = &profiler; when detached it costs nothing.
+
+namespace cpu6502
+{
+    struct Profiler;
+}
+
+struct cpu6502::Profiler : cpu6502::Observer
+{
+    struct Frame
+    {
+        Word Entry;    // Subroutine entry address (JSR target)
+        Byte ReturnSP; // SP before the JSR, the frame is gone once SP is back here
+    };
+
+    explicit Profiler(u32 Period = 1000) : SamplePeriod(Period ? Period : 1) {}
+
+    // Cycles between two samples - larger is cheaper
+    u32 SamplePeriod;
+    u64 SampleCount = 0;
+
+    // Samples per PC
+    std::vector<u64> FlatSamples = std::vector<u64>(Mem::MAX_MEM, 0);
+    // Samples per call stack, outermost entry first
+    std::map<std::vector<Word>, u64> StackSamples;
+
+    std::vector<Frame> CallStack;
+
+    void Clear();
+
+    // "$C012 123 label+$2" lines, hottest first. Returns false on I/O errors.
+    bool WriteFlat(const char *Path, const SymbolTable *Symbols = nullptr) const;
+
+    // Folded stacks ("root;main;sub 123") for flamegraph.pl / speedscope / inferno
+    bool WriteFolded(const char *Path, const SymbolTable *Symbols = nullptr) const;
+
+    void OnInstruction(const CPU &cpu, Word PC, Byte Opcode, u64 Cycle) override;
+
+private:
+    u64 NextSampleCycle = 0;
+    Byte PreviousOpcode = 0;
+    Byte PreviousSP = 0;
+    std::vector<Word> StackKey;
+};
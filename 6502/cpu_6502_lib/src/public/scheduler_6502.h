@@ -0,0 +1,70 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "main_6502.h"
+
+// Cycle based event scheduler. Devices schedule callbacks at absolute
+// cycles (CPU::CycleCount) and Run hands the CPU whole slices that end at
+// the next event, so the interpreter never polls for them. Events fire at
+// the first instruction boundary at or after their cycle, events due on
+// the same cycle fire in the order they were scheduled.
+
+namespace cpu6502
+{
+    struct Scheduler;
+}
+
+struct cpu6502::Scheduler
+{
+    using EventId = u32;
+    using Callback = std::function<void(u64 Cycle)>;
+
+    static constexpr u64 NEVER = ~0ull;
+
+    // Callback gets the cycle it was scheduled for, it may schedule more.
+    // Scheduling from a device while the CPU runs ends its slice early if
+    // needed, so the event still fires on time.
+    EventId Schedule(u64 Cycle, Callback Event);
+
+    // False when the event already fired or was cancelled
+    bool Cancel(EventId Id);
+
+    // Cycle of the earliest pending event, NEVER when there is none
+    u64 NextEventCycle();
+
+    // Fires every event due at or before Now
+    void RunDue(u64 Now);
+
+    // One Execute call up to Until or the next event, whichever comes
+    // first. Fires nothing, see RunDue.
+    ExecuteResult RunSlice(CPU &cpu, Mem &memory, u64 Until);
+
+    // Runs the CPU until cycle Until firing events on the way. Stops early
+    // when Execute stops for any other reason than the budget running out;
+    // the result covers the whole run.
+    ExecuteResult RunUntil(CPU &cpu, Mem &memory, u64 Until);
+
+    bool Empty() const { return Live == 0; }
+    void Clear();
+
+private:
+    struct Entry
+    {
+        u64 Cycle;
+        u64 Sequence;
+        EventId Id;
+        Callback Event; // empty once cancelled
+    };
+
+    // Min-heap on (Cycle, Sequence). Cancelled entries stay in it until they
+    // reach the top, there are only ever a handful of pending events.
+    std::vector<Entry> Queue;
+    u32 Live = 0;
+    CPU *Running = nullptr; // Inside RunSlice
+    u64 NextSequence = 0;
+    EventId NextId = 1;
+
+    // std heap functions keep the largest element on top
+    static bool FiresLater(const Entry &a, const Entry &b);
+    void DropCancelled();
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include <functional>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include "main_6502.h"
+#include "scheduler_6502.h"
+#include "spsc_6502.h"
+
+// Three channel square wave sound chip. Channel c has three registers at
+// Base + c * 4:
+//     +PERIOD_LO, +PERIOD_HI  12 bit period, the wave flips every
+//                             Period * 8 cycles (0 silences the channel)
+//     +VOLUME                 0-15
+//
+// Nothing is synthesized while the guest runs. Register writes are only
+// appended, with their cycle, to a preallocated lock-free log, and every
+// BatchCycles a scheduler event appends a SYNC marker saying audio up to
+// that cycle is final. A SoundRenderer, on any thread, replays the log
+// into PCM. It works from cycle stamps alone, so the same guest run always
+// gives the same samples however the rendering is batched or scheduled.
+// Writes are never dropped and the emulator side never allocates: a batch
+// adds at most BatchEntries to the log, and the batch end event waits for
+// the renderer (WaitForRenderer) until the log has room for another one.
+
+namespace cpu6502
+{
+    struct SoundChip;
+    struct SoundRenderer;
+}
+
+struct cpu6502::SoundChip : cpu6502::Device
+{
+    static constexpr u32 CHANNELS = 3;
+    enum Register : Byte
+    {
+        PERIOD_LO,
+        PERIOD_HI,
+        VOLUME
+    };
+    static constexpr Byte SYNC = 0xFF;
+    static constexpr u32 LOG_SIZE = 16384;
+
+    // Most entries a batch can log: a write takes 2 cycles or more on
+    // average (DMA: 256 per 513 cycle stall), one DMA may land in full
+    // right at the end, and the SYNC
+    static constexpr u32 BatchEntries(u32 Batch) { return Batch / 2 + 256 + 1; }
+    static constexpr u32 MAX_BATCH = 2 * (LOG_SIZE - 256 - 1);
+
+    struct Event
+    {
+        u64 Cycle;
+        Byte Register; // Channel * 4 + Register, or SYNC
+        Byte Value;
+    };
+
+    // Batch is cut to MAX_BATCH
+    SoundChip(Scheduler &Clock, Word Start, u32 Batch);
+    ~SoundChip() override;
+
+    const Word Base;
+    const u32 BatchCycles;
+    u64 RendererWaits = 0; // Batch ends that found the renderer behind
+
+    // Called on the emulator thread until the renderer has made room. The
+    // default yields to a renderer on another thread, a single threaded
+    // host renders here instead. Host Write / Sync calls past a batch's
+    // worth wait in it too.
+    std::function<void()> WaitForRenderer = [] { std::this_thread::yield(); };
+
+    // Marks audio up to Cycle final without waiting for the next batch
+    void Sync(u64 Cycle) { Append({Cycle, SYNC, 0}); }
+
+    // Renderer side
+    bool Pop(Event &Out) { return Log.Pop(Out); }
+
+    Byte Read(Word Address, u64 Cycle) override;
+    void Write(Word Address, Byte Value, u64 Cycle) override;
+    bool StableRead(Word /*Address*/) const override { return true; }
+
+private:
+    Scheduler &Events;
+    Scheduler::EventId Pending = 0;
+    Byte Registers[CHANNELS * 4] = {};
+    SpscRing<Event, LOG_SIZE> Log;
+
+    void Append(const Event &Entry);
+    void EndBatch(u64 Cycle);
+};
+
+struct cpu6502::SoundRenderer
+{
+    // ClockHz is the CPU clock, sample n is taken on cycle n * ClockHz / SampleRate
+    SoundRenderer(u32 ClockHz, u32 SampleRate);
+
+    const u32 ClockHz, SampleRate;
+
+    // Takes everything logged so far and appends the samples up to the
+    // last entry to Out, returns how many
+    u32 Render(SoundChip &Chip, std::vector<s16> &Out);
+
+    // Plays one log entry, for rendering a saved log offline
+    void Apply(const SoundChip::Event &Entry, std::vector<s16> &Out);
+
+    // 16 bit mono PCM
+    static bool WriteWav(FILE *File, const s16 *Samples, u32 Count, u32 SampleRate);
+
+private:
+    struct Channel
+    {
+        u32 HalfPeriod = 0; // Cycles, 0 when silent
+        u32 Countdown = 0;  // Cycles to the next flip
+        Byte Volume = 0;
+        bool High = true;
+
+        void Advance(u64 Cycles);
+    } Channels[SoundChip::CHANNELS];
+
+    Byte Registers[SoundChip::CHANNELS * 4] = {};
+    u64 Cycle = 0;      // Channels are up to here
+    u64 NextSample = 0; // Index of the next sample
+
+    u64 SampleCycle(u64 Sample) const { return Sample * ClockHz / SampleRate; }
+    void RenderUntil(u64 Until, std::vector<s16> &Out);
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <atomic>
+#include <utility>
+#include "main_6502.h"
+
+// Lock-free single producer / single consumer ring buffer. One thread may
+// push and one other thread may pop at the same time without locks. Each
+// side keeps a copy of the other side's index and only reloads it (one
+// acquire load) when the ring looks full / empty, so the common case
+// touches no shared cache line but its own.
+
+namespace cpu6502
+{
+    template <typename T, u32 Capacity>
+    struct SpscRing;
+}
+
+template <typename T, cpu6502::u32 Capacity>
+struct cpu6502::SpscRing
+{
+    static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static constexpr u32 MASK = Capacity - 1;
+
+    // Producer side
+
+    bool CanPush()
+    {
+        u32 Tail = TailIndex.load(std::memory_order_relaxed);
+        if (Tail - ProducerHead != Capacity)
+            return true;
+        ProducerHead = HeadIndex.load(std::memory_order_acquire);
+        return Tail - ProducerHead != Capacity;
+    }
+
+    bool Push(T Item)
+    {
+        if (!CanPush())
+            return false;
+        u32 Tail = TailIndex.load(std::memory_order_relaxed);
+        Items[Tail & MASK] = std::move(Item);
+        TailIndex.store(Tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Room left, at least this many pushes will succeed
+    u32 Free()
+    {
+        ProducerHead = HeadIndex.load(std::memory_order_acquire);
+        return Capacity - (TailIndex.load(std::memory_order_relaxed) - ProducerHead);
+    }
+
+    // Pushes as many as fit, returns how many
+    u32 Push(const T *Source, u32 Count)
+    {
+        u32 Tail = TailIndex.load(std::memory_order_relaxed);
+        ProducerHead = HeadIndex.load(std::memory_order_acquire);
+        u32 Free = Capacity - (Tail - ProducerHead);
+        Count = Count < Free ? Count : Free;
+        for (u32 i = 0; i < Count; i++)
+        {
+            Items[(Tail + i) & MASK] = Source[i];
+        }
+        TailIndex.store(Tail + Count, std::memory_order_release);
+        return Count;
+    }
+
+    // Consumer side
+
+    bool CanPop()
+    {
+        u32 Head = HeadIndex.load(std::memory_order_relaxed);
+        if (ConsumerTail != Head)
+            return true;
+        ConsumerTail = TailIndex.load(std::memory_order_acquire);
+        return ConsumerTail != Head;
+    }
+
+    bool Pop(T &Item)
+    {
+        if (!CanPop())
+            return false;
+        u32 Head = HeadIndex.load(std::memory_order_relaxed);
+        Item = std::move(Items[Head & MASK]);
+        HeadIndex.store(Head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Hands everything queued to Sink(const T *, u32) in at most two
+    // contiguous runs straight out of the ring. Sink returns how many it
+    // took, a short run ends the drain and the rest stays queued. Returns
+    // how many were taken.
+    template <typename Function>
+    u32 Drain(Function Sink)
+    {
+        u32 Head = HeadIndex.load(std::memory_order_relaxed);
+        ConsumerTail = TailIndex.load(std::memory_order_acquire);
+        u32 Count = ConsumerTail - Head;
+        u32 First = Capacity - (Head & MASK);
+        First = Count < First ? Count : First;
+        u32 Taken = 0;
+        if (First)
+            Taken = Sink(&Items[Head & MASK], First);
+        if (Taken == First && Count > First)
+            Taken += Sink(&Items[0], Count - First);
+        HeadIndex.store(Head + Taken, std::memory_order_release);
+        return Taken;
+    }
+
+    // Pops up to Count, returns how many
+    u32 Pop(T *Destination, u32 Count)
+    {
+        u32 Head = HeadIndex.load(std::memory_order_relaxed);
+        ConsumerTail = TailIndex.load(std::memory_order_acquire);
+        u32 Available = ConsumerTail - Head;
+        Count = Count < Available ? Count : Available;
+        for (u32 i = 0; i < Count; i++)
+        {
+            Destination[i] = Items[(Head + i) & MASK];
+        }
+        HeadIndex.store(Head + Count, std::memory_order_release);
+        return Count;
+    }
+
+    // Either side, only a snapshot while the other side is running
+    u32 Size() const
+    {
+        return TailIndex.load(std::memory_order_acquire) - HeadIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    // Free running indices, consumer and producer state on separate cache lines
+    alignas(64) std::atomic<u32> HeadIndex{0};
+    u32 ConsumerTail = 0;
+    alignas(64) std::atomic<u32> TailIndex{0};
+    u32 ProducerHead = 0;
+    alignas(64) T Items[Capacity];
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "main_6502.h"
+
+// Whole machine state hashing for duplicate state detection. StateHasher
+// keeps a hash per memory page in a binary tree and only rehashes pages
+// written since its last call (see Mem::Checkpoint), so a hash costs
+// O(dirty pages) rather than O(64K). Memory poked through operator[] or
+// Data is not seen until Rebuild.
+//
+// The state is the registers (A X Y SP PC P), pending interrupts and
+// memory. Cycle counts are left out: the same state reached later is a
+// duplicate.
+//
+// StateSet remembers hashes across threads without locks.
+
+namespace cpu6502
+{
+    struct StateHasher;
+    struct StateSet;
+}
+
+struct cpu6502::StateHasher
+{
+    explicit StateHasher(Mem &Memory);
+
+    // Hash of cpu plus memory as of now
+    u64 Hash(const CPU &cpu);
+
+    // Rehashes every page, after memory changed behind Mem's back
+    void Rebuild();
+
+    u64 PagesHashed = 0; // Since construction, for checking the incremental path
+
+private:
+    static constexpr u32 LEAVES = Mem::NUM_PAGES;
+
+    Mem &memory;
+    u32 Since = 0;
+    // Heap layout, node i has children 2i+1 and 2i+2, page p is node LEAVES - 1 + p
+    u64 Tree[2 * LEAVES - 1] = {};
+
+    void Update();
+};
+
+struct cpu6502::StateSet
+{
+    enum class Result : Byte
+    {
+        Added,
+        Present,
+        Full
+    };
+
+    // Capacity is rounded up to a power of two, keep it well above the
+    // number of states expected, probing slows down as it fills
+    explicit StateSet(u32 Capacity);
+
+    // Any thread, any time
+    Result Insert(u64 Hash);
+    bool Contains(u64 Hash) const;
+
+    u32 Size() const { return Count.load(std::memory_order_relaxed); }
+
+private:
+    u32 Mask;
+    std::unique_ptr<std::atomic<u64>[]> Slots; // 0 is an empty slot
+    std::atomic<u32> Count{0};
+
+    static u64 Key(u64 Hash) { return Hash ? Hash : 1; }
+};
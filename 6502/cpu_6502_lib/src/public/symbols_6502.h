@@ -0,0 +1,34 @@
+#pragma once
+#include <map>
+#include <string>
+#include "main_6502.h"
+
+// Guest address -> label mapping used to make profiles and reports readable.
+
+namespace cpu6502
+{
+    struct SymbolTable;
+}
+
+struct cpu6502::SymbolTable
+{
+    std::map<Word, std::string> Labels;
+
+    // Reads a label file, one label per line. Accepted forms:
+    //   al C:c000 .main      (VICE monitor labels)
+    //   $C000 main / C000 main
+    //   main = $C000 / main := $C000
+    // Blank lines and lines starting with ';' or '#' are skipped.
+    // Returns false when the file can't be opened.
+    bool Load(const char *Path);
+
+    void Add(Word Address, const std::string &Name) { Labels[Address] = Name; }
+
+    bool Empty() const { return Labels.empty(); }
+
+    // Exact label for Address, or "$XXXX"
+    std::string NameOf(Word Address) const;
+
+    // Nearest label at or below Address as "label+$off", or "$XXXX"
+    std::string Describe(Word Address) const;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <vector>
+#include "main_6502.h"
+
+// Execution trace recording with a per-address access index, so questions
+// like "who last wrote $0200 before cycle N" are answered with a binary
+// search instead of a scan over the whole trace.
+
+namespace cpu6502
+{
+    enum class AccessKind : Byte
+    {
+        Read,
+        Write
+    };
+
+    struct TraceInstruction;
+    struct TraceAccess;
+    struct TraceRecorder;
+}
+
+struct cpu6502::TraceInstruction
+{
+    u64 Cycle; // Cycle at which the opcode fetch started
+    Word PC;
+    Byte Opcode;
+};
+
+struct cpu6502::TraceAccess
+{
+    u64 Cycle;    // Exact cycle of the bus access
+    Word PC;      // Address of the instruction doing the access
+    Word Address;
+    Byte Value;
+    AccessKind Kind;
+};
+
+struct cpu6502::TraceRecorder : cpu6502::Observer
+{
+    static constexpr u32 NUM_ADDRESSES = Mem::MAX_MEM;
+
+    std::vector<TraceInstruction> Instructions;
+    std::vector<TraceAccess> Accesses;
+
+    // Keep the per-address index up to date while recording. When false,
+    // call BuildIndex() once recording is done (offline pass).
+    bool IndexWhileRecording = true;
+
+    void Clear();
+
+    // Rebuilds the per-address index from Accesses
+    void BuildIndex();
+
+    // Most recent write to Address strictly before Cycle, or nullptr
+    const TraceAccess *LastWriteBefore(Word Address, u64 Cycle) const;
+
+    // First read of Address at or after Cycle, or nullptr
+    const TraceAccess *NextReadAfter(Word Address, u64 Cycle) const;
+
+    // All accesses of the given kind to Address within [FromCycle, ToCycle)
+    std::vector<const TraceAccess *> AccessesTo(Word Address, AccessKind Kind,
+                                                u64 FromCycle = 0, u64 ToCycle = ~0ull) const;
+
+    // Distinct instruction addresses (sorted) that accessed Address
+    std::vector<Word> ReadersOf(Word Address) const;
+    std::vector<Word> WritersOf(Word Address) const;
+
+    // Binary trace file, returns false on I/O or format errors
+    bool Save(const char *Path) const;
+    bool Load(const char *Path);
+
+    void OnInstruction(const CPU &cpu, Word PC, Byte Opcode, u64 Cycle) override;
+    void OnRead(Word Address, Byte Value, u64 Cycle) override;
+    void OnWrite(Word Address, Byte Value, u64 Cycle) override;
+
+private:
+    // Indices into Accesses, per address, in cycle order
+    std::vector<std::vector<u32>> ReadIndex;
+    std::vector<std::vector<u32>> WriteIndex;
+    Word CurrentPC = 0;
+
+    void Record(Word Address, Byte Value, u64 Cycle, AccessKind Kind);
+    void AddToIndex(u32 AccessIndex);
+    const std::vector<u32> &IndexFor(Word Address, AccessKind Kind) const;
+    std::vector<Word> DistinctPCs(Word Address, AccessKind Kind) const;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdio.h>
+#include "main_6502.h"
+#include "spsc_6502.h"
+
+// Memory mapped serial port. The guest sees two registers at Base:
+//     Base + DATA    read: next input byte (0 when there is none)
+//                    write: queue an output byte (dropped when TX_READY is clear)
+//     Base + STATUS  RX_READY when input is waiting, TX_READY when output has room
+// Map it with memory.Map(&uart, Base, Base + 1); the rest of the page reads $FF.
+//
+// The host side talks to it through lock-free rings, one host thread may
+// feed input while another (or the same one) drains output, all while the
+// emulator thread runs. Neither side ever blocks the other.
+
+namespace cpu6502
+{
+    struct Uart;
+}
+
+struct cpu6502::Uart : cpu6502::Device
+{
+    static constexpr Word DATA = 0, STATUS = 1;
+    static constexpr Byte RX_READY = 0x01, TX_READY = 0x02;
+    static constexpr u32 BUFFER_SIZE = 4096;
+
+    explicit Uart(Word BaseAddress) : Base(BaseAddress) {}
+
+    Word Base;
+    u64 DroppedOutput = 0; // Guest writes while TX_READY was clear
+
+    // Host side: queue input for the guest, returns how much fitted
+    u32 Send(const Byte *Data, u32 Count) { return Input.Push(Data, Count); }
+
+    // Host side: take up to Count bytes of guest output
+    u32 Receive(Byte *Data, u32 Count) { return Output.Pop(Data, Count); }
+
+    // Host side: write all pending output with at most two fwrite calls,
+    // returns how many bytes were written. After a short write (see
+    // ferror(File)) the unwritten bytes stay queued for the next flush.
+    u32 FlushTo(FILE *File);
+
+    Byte Read(Word Address, u64 Cycle) override;
+    void Write(Word Address, Byte Value, u64 Cycle) override;
+
+private:
+    SpscRing<Byte, BUFFER_SIZE> Input;  // host -> guest
+    SpscRing<Byte, BUFFER_SIZE> Output; // guest -> host
+};
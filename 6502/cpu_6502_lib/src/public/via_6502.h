@@ -0,0 +1,78 @@
+#pragma once
+#include "main_6502.h"
+#include "scheduler_6502.h"
+
+// MOS 6522 VIA: ports A / B with data direction registers, timers T1
+// (one-shot or free-running) and T2 (one-shot), and the interrupt flag /
+// enable registers driving one CPU IRQ source. Sixteen registers repeat
+// through the mapped pages.
+//
+// The timers are never ticked. Loading one records the cycle it started
+// on and a read works the counter out from that; the next underflow is a
+// single Scheduler event. Not modelled: the shift register, T2 pulse
+// counting, PB7 timer output and the CA / CB handshake lines.
+
+namespace cpu6502
+{
+    struct VIA;
+}
+
+struct cpu6502::VIA : cpu6502::Device
+{
+    enum Register : Byte
+    {
+        ORB, ORA, DDRB, DDRA,
+        T1CL, T1CH, T1LL, T1LH,
+        T2CL, T2CH,
+        SR, ACR, PCR, IFR, IER,
+        ORA_NH // ORA without handshake
+    };
+
+    static constexpr Byte IRQ_T2 = 0x20, IRQ_T1 = 0x40, IRQ_ANY = 0x80;
+    static constexpr Byte ACR_T1_CONTINUOUS = 0x40;
+
+    VIA(CPU &Target, Scheduler &Events, u32 IRQSource = 1);
+    ~VIA() override;
+
+    // Pins driven from outside, read back where DDR bits are 0
+    Byte InputA = 0xFF, InputB = 0xFF;
+
+    // What the port pins show: ORx where DDR is 1, the input elsewhere
+    Byte PortA() const { return (Regs[ORA] & Regs[DDRA]) | (InputA & ~Regs[DDRA]); }
+    Byte PortB() const { return (Regs[ORB] & Regs[DDRB]) | (InputB & ~Regs[DDRB]); }
+
+    Byte Read(Word Address, u64 Cycle) override;
+    void Write(Word Address, Byte Value, u64 Cycle) override;
+    bool StableRead(Word Address) const override;
+
+    // Timer values as the guest would read them at Cycle
+    Word Timer1(u64 Cycle);
+    Word Timer2(u64 Cycle);
+
+private:
+    CPU &cpu;
+    Scheduler &Events;
+    u32 IRQSource;
+
+    Byte Regs[16] = {};
+    Word T1Latch = 0, T2Latch = 0;
+
+    // A timer holds Period on cycle Start and counts down from there, it
+    // underflows (and flags its interrupt) on Start + Period + 1
+    struct Timer
+    {
+        u64 Start = 0;
+        Word Period = 0;
+        u64 Underflow = Scheduler::NEVER; // next interrupt, NEVER once a one-shot fired
+    } T1, T2;
+
+    Scheduler::EventId Pending = 0;
+    u64 PendingCycle = Scheduler::NEVER;
+
+    // Brings flags and reloads up to Cycle
+    void Update(u64 Cycle);
+    void Reschedule();
+    void SetFlags(Byte Flags);
+    void ClearFlags(Byte Flags);
+    static Word Count(const Timer &Counter, u64 Cycle);
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include "main_6502.h"
+
+// Built-in 6502 workloads used to compare engines and memory backends on
+// the same real programs. Each program starts at LoadAddress and must reach
+// the INS_HOST_CALL at DoneAddress in exactly ExpectedCycles, so running
+// ExpectedCycles leaves PC on DoneAddress and running longer stops on the
+// call (which takes HOST_CALL_CYCLES more). Verify() checks the program's
+// output in guest memory against a reference computed on the host.
+
+namespace cpu6502
+{
+    struct Workload;
+
+    const std::vector<Workload> &Workloads();
+}
+
+struct cpu6502::Workload
+{
+    static constexpr s32 HOST_CALL_CYCLES = 2;
+
+    const char *Name;
+    const char *Description;
+    Word LoadAddress; // also the entry point
+    const Byte *Image;
+    u32 ImageSize;
+    Word DoneAddress;
+    s32 ExpectedCycles;
+    bool (*Verify)(const Mem &memory);
+
+    // Resets the CPU and memory and copies the program in
+    void Load(CPU &cpu, Mem &memory) const;
+};
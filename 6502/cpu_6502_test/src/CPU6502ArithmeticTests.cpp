@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "main_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502ArithmeticTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem);
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502ArithmeticTests, ADCImmediateAddsWithCarry)
+{
+    // Given:
+    cpu.A = 0x10;
+    cpu.flags.C = 1;
+    mem[0xFFFC] = CPU::INS_ADC_IM;
+    mem[0xFFFD] = 0x20;
+    s32 CyclesExpected = 2;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x31);
+    EXPECT_FALSE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.Z);
+    EXPECT_FALSE(cpu.flags.N);
+    EXPECT_FALSE(cpu.flags.V);
+}
+
+TEST_F(CPU6502ArithmeticTests, ADCSetsCarryAndZeroOnWrapAround)
+{
+    // Given:
+    cpu.A = 0xFF;
+    mem[0xFFFC] = CPU::INS_ADC_ZERO_P;
+    mem[0xFFFD] = 0x42;
+    mem[0x0042] = 0x01;
+    s32 CyclesExpected = 3;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x00);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_TRUE(cpu.flags.Z);
+    EXPECT_FALSE(cpu.flags.V);
+}
+
+TEST_F(CPU6502ArithmeticTests, ADCSetsOverflowOnSignedOverflow)
+{
+    // Given:
+    cpu.A = 0x7F;
+    mem[0xFFFC] = CPU::INS_ADC_ABS;
+    mem[0xFFFD] = 0x80;
+    mem[0xFFFE] = 0x44;
+    mem[0x4480] = 0x01;
+    s32 CyclesExpected = 4;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x80);
+    EXPECT_TRUE(cpu.flags.V);
+    EXPECT_TRUE(cpu.flags.N);
+    EXPECT_FALSE(cpu.flags.C);
+}
+
+TEST_F(CPU6502ArithmeticTests, ADCAbsoluteXCrossingPageTakesExtraCycle)
+{
+    // Given:
+    cpu.A = 0x01;
+    cpu.X = 0x01;
+    mem[0xFFFC] = CPU::INS_ADC_ABS_X;
+    mem[0xFFFD] = 0xFF;
+    mem[0xFFFE] = 0x44;
+    // 0x44FF + 0x1 = 0x4500 -> Crosses page boundary
+    mem[0x4500] = 0x02;
+    s32 CyclesExpected = 5;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x03);
+}
+
+TEST_F(CPU6502ArithmeticTests, AbsoluteYEndingOnLastByteOfPageDoesNotCross)
+{
+    // Given:
+    cpu.Y = 0x0F;
+    mem[0xFFFC] = CPU::INS_ADC_ABS_Y;
+    mem[0xFFFD] = 0xF0;
+    mem[0xFFFE] = 0x44;
+    // 0x44F0 + 0x0F = 0x44FF -> same page
+    mem[0x44FF] = 0x02;
+    s32 CyclesExpected = 4;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x02);
+}
+
+TEST_F(CPU6502ArithmeticTests, ADCDecimalModeAddsBCD)
+{
+    // Given:
+    cpu.A = 0x58;
+    cpu.flags.D = 1;
+    cpu.flags.C = 1;
+    mem[0xFFFC] = CPU::INS_ADC_IM;
+    mem[0xFFFD] = 0x46;
+    s32 CyclesExpected = 2;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    // 58 + 46 + 1 = 105
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x05);
+    EXPECT_TRUE(cpu.flags.C);
+}
+
+TEST_F(CPU6502ArithmeticTests, SBCIndirectYSubtractsWithBorrow)
+{
+    // Given:
+    cpu.A = 0x50;
+    cpu.Y = 0x04;
+    cpu.flags.C = 0;
+    mem[0xFFFC] = CPU::INS_SBC_IND_Y;
+    mem[0xFFFD] = 0x02;
+    mem[0x0002] = 0x00;
+    mem[0x0003] = 0x80;
+    mem[0x8004] = 0x10;
+    s32 CyclesExpected = 5;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x3F);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.V);
+}
+
+TEST_F(CPU6502ArithmeticTests, SBCClearsCarryOnBorrowAndSetsOverflow)
+{
+    // Given:
+    cpu.A = 0x80;
+    cpu.flags.C = 1;
+    mem[0xFFFC] = CPU::INS_SBC_IM;
+    mem[0xFFFD] = 0x01;
+    // When:
+    cpu.Execute(2, mem);
+    // Then:
+    EXPECT_EQ(cpu.A, 0x7F);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_TRUE(cpu.flags.V);
+
+    // Given:
+    cpu.PC = 0xFFFC;
+    cpu.A = 0x00;
+    // When:
+    cpu.Execute(2, mem);
+    // Then:
+    EXPECT_EQ(cpu.A, 0xFF);
+    EXPECT_FALSE(cpu.flags.C);
+    EXPECT_TRUE(cpu.flags.N);
+}
+
+TEST_F(CPU6502ArithmeticTests, SBCDecimalModeSubtractsBCD)
+{
+    // Given:
+    cpu.A = 0x00;
+    cpu.flags.D = 1;
+    cpu.flags.C = 1;
+    mem[0xFFFC] = CPU::INS_SBC_IM;
+    mem[0xFFFD] = 0x01;
+    // When:
+    cpu.Execute(2, mem);
+    // Then:
+    // 00 - 01 = 99 with borrow
+    EXPECT_EQ(cpu.A, 0x99);
+    EXPECT_FALSE(cpu.flags.C);
+}
+
+TEST_F(CPU6502ArithmeticTests, CMPSetsFlagsWithoutChangingA)
+{
+    // Given:
+    cpu.A = 0x40;
+    mem[0xFFFC] = CPU::INS_CMP_IM;
+    mem[0xFFFD] = 0x40;
+    s32 CyclesExpected = 2;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x40);
+    EXPECT_TRUE(cpu.flags.Z);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.N);
+}
+
+TEST_F(CPU6502ArithmeticTests, CMPIndirectXLessThanClearsCarry)
+{
+    // Given:
+    cpu.A = 0x10;
+    cpu.X = 0x04;
+    mem[0xFFFC] = CPU::INS_CMP_IND_X;
+    mem[0xFFFD] = 0x02;
+    mem[0x0006] = 0x00;
+    mem[0x0007] = 0x80;
+    mem[0x8000] = 0x20;
+    s32 CyclesExpected = 6;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_FALSE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.Z);
+    EXPECT_TRUE(cpu.flags.N);
+}
+
+TEST_F(CPU6502ArithmeticTests, CPXAndCPYCompareIndexRegisters)
+{
+    // Given:
+    cpu.X = 0x30;
+    cpu.Y = 0x05;
+    mem[0xFFFC] = CPU::INS_CPX_ZERO_P;
+    mem[0xFFFD] = 0x42;
+    mem[0xFFFE] = CPU::INS_CPY_ABS;
+    mem[0xFFFF] = 0x42;
+    mem[0x0000] = 0x00;
+    mem[0x0042] = 0x20;
+    // When:
+    s32 CyclesUsed = cpu.Execute(3, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 3);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.Z);
+    // When:
+    CyclesUsed = cpu.Execute(4, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 4);
+    EXPECT_FALSE(cpu.flags.C);
+    EXPECT_TRUE(cpu.flags.N);
+}
+
+TEST_F(CPU6502ArithmeticTests, ADCDecimalModeKeepsNMOSFlags)
+{
+    // Given:
+    cpu.A = 0x99;
+    cpu.flags.D = 1;
+    mem[0xFFFC] = CPU::INS_ADC_IM;
+    mem[0xFFFD] = 0x01;
+    // When:
+    cpu.Execute(2, mem);
+    // Then:
+    // 99 + 01 = 00 carry 1, but Z follows the binary sum (0x9A) and N the
+    // unadjusted high digit
+    EXPECT_EQ(cpu.A, 0x00);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.Z);
+    EXPECT_TRUE(cpu.flags.N);
+    EXPECT_TRUE(cpu.flags.D);
+}
+
+TEST_F(CPU6502ArithmeticTests, DecimalTablesMatchBCDArithmetic)
+{
+    const DecimalTables &Tables = DecimalTables::Get();
+    for (u32 Carry = 0; Carry < 2; Carry++)
+    {
+        for (u32 a = 0; a < 100; a++)
+        {
+            for (u32 b = 0; b < 100; b++)
+            {
+                Byte A = Byte(((a / 10) << 4) | (a % 10));
+                Byte Operand = Byte(((b / 10) << 4) | (b % 10));
+                u32 i = DecimalTables::Index(A, Operand, Byte(Carry));
+
+                u32 Sum = a + b + Carry;
+                Word Add = Tables.Add[i];
+                ASSERT_EQ(Add & 0xFF, ((Sum % 100 / 10) << 4) | (Sum % 10)) << a << " + " << b;
+                ASSERT_EQ((Add >> 8) & 1, Sum > 99 ? 1u : 0u) << a << " + " << b;
+
+                s32 Difference = s32(a) - s32(b) - s32(1 - Carry);
+                u32 Wrapped = u32(Difference + 100) % 100;
+                Word Subtract = Tables.Subtract[i];
+                ASSERT_EQ(Subtract & 0xFF, ((Wrapped / 10) << 4) | (Wrapped % 10)) << a << " - " << b;
+                ASSERT_EQ((Subtract >> 8) & 1, Difference >= 0 ? 1u : 0u) << a << " - " << b;
+                ASSERT_EQ(Add, DecimalTables::AddBranchy(A, Operand, Byte(Carry)));
+            }
+        }
+    }
+}
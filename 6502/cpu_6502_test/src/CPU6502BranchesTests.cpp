@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "main_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502BranchesTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0xFF00);
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502BranchesTests, BranchNotTakenTakesTwoCycles)
+{
+    // Given:
+    cpu.flags.Z = 0;
+    mem[0xFF00] = CPU::INS_BEQ;
+    mem[0xFF01] = 0x10;
+    s32 CyclesExpected = 2;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.PC, 0xFF02);
+}
+
+TEST_F(CPU6502BranchesTests, BranchTakenTakesThreeCycles)
+{
+    // Given:
+    cpu.flags.Z = 1;
+    mem[0xFF00] = CPU::INS_BEQ;
+    mem[0xFF01] = 0x10;
+    s32 CyclesExpected = 3;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.PC, 0xFF12);
+}
+
+TEST_F(CPU6502BranchesTests, BranchBackwardsToAnotherPageTakesFourCycles)
+{
+    // Given:
+    cpu.flags.C = 0;
+    mem[0xFF00] = CPU::INS_BCC;
+    mem[0xFF01] = 0xFC; // -4
+    s32 CyclesExpected = 4;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.PC, 0xFEFE);
+}
+
+TEST_F(CPU6502BranchesTests, EveryBranchTestsItsFlag)
+{
+    struct
+    {
+        Byte Instruction;
+        Byte ProcessorStatus;
+    } const Taken[] = {
+        {CPU::INS_BCC, 0x00}, {CPU::INS_BCS, 0x01}, {CPU::INS_BNE, 0x00}, {CPU::INS_BEQ, 0x02},
+        {CPU::INS_BVC, 0x00}, {CPU::INS_BVS, 0x40}, {CPU::INS_BPL, 0x00}, {CPU::INS_BMI, 0x80},
+    };
+    for (const auto &Case : Taken)
+    {
+        // Given:
+        cpu.PC = 0xFF00;
+        cpu.PS = Case.ProcessorStatus;
+        mem[0xFF00] = Case.Instruction;
+        mem[0xFF01] = 0x02;
+        // When:
+        cpu.Execute(1, mem);
+        // Then:
+        EXPECT_EQ(cpu.PC, 0xFF04) << "opcode " << int(Case.Instruction);
+
+        // Given:
+        cpu.PC = 0xFF00;
+        cpu.PS = Case.ProcessorStatus ^ 0xC3;
+        // When:
+        cpu.Execute(1, mem);
+        // Then:
+        EXPECT_EQ(cpu.PC, 0xFF02) << "opcode " << int(Case.Instruction);
+    }
+}
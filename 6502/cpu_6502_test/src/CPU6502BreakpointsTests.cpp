@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "main_6502.h"
+#include "breakpoints_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502BreakpointsTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::Breakpoints debug;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        // 0x0200: loop: INX / STX $10 / LDA $0300,X / JMP loop
+        mem[0x0200] = CPU::INS_INX;
+        mem[0x0201] = CPU::INS_STX_ZEROP;
+        mem[0x0202] = 0x10;
+        mem[0x0203] = CPU::INS_LDA_ABS_X;
+        mem[0x0204] = 0x00;
+        mem[0x0205] = 0x03;
+        mem[0x0206] = CPU::INS_JMP_ABS;
+        mem[0x0207] = 0x00;
+        mem[0x0208] = 0x02;
+        cpu.Debug = &debug;
+    }
+
+    virtual void TearDown()
+    {
+        cpu.Debug = nullptr;
+    }
+};
+
+TEST_F(CPU6502BreakpointsTests, StopsBeforeBreakpointAndResumesPastIt)
+{
+    // Given:
+    debug.AddBreakpoint(0x0203);
+    // When:
+    ExecuteResult Result = cpu.Execute(1000, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::Breakpoint);
+    EXPECT_EQ(Result.PC, 0x0203);
+    EXPECT_EQ(Result.Cycles, 2 + 3);
+    EXPECT_EQ(cpu.PC, 0x0203);
+    EXPECT_EQ(debug.LastHit.Kind, Debugger::EXECUTE);
+    // When:
+    Result = cpu.Execute(1000, mem);
+    // Then:
+    // one full loop later
+    EXPECT_EQ(Result.Reason, StopReason::Breakpoint);
+    EXPECT_EQ(Result.Cycles, 4 + 3 + 2 + 3);
+    EXPECT_EQ(cpu.X, 2);
+}
+
+TEST_F(CPU6502BreakpointsTests, ConditionalBreakpointChecksRegisters)
+{
+    // Given:
+    Condition When;
+    ASSERT_TRUE(When.Compile("X == 5 && [$10] >= 5"));
+    debug.AddBreakpoint(0x0203, When);
+    // When:
+    ExecuteResult Result = cpu.Execute(1000, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::Breakpoint);
+    EXPECT_EQ(cpu.X, 5);
+}
+
+TEST_F(CPU6502BreakpointsTests, WriteWatchpointStopsAfterTheInstruction)
+{
+    // Given:
+    debug.AddWatchpoint(0x0010, 0x0010, Debugger::WRITE);
+    // When:
+    ExecuteResult Result = cpu.Execute(1000, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::Breakpoint);
+    EXPECT_EQ(Result.PC, 0x0203);
+    EXPECT_EQ(debug.LastHit.Kind, Debugger::WRITE);
+    EXPECT_EQ(debug.LastHit.PC, 0x0201);
+    EXPECT_EQ(debug.LastHit.Address, 0x0010);
+    EXPECT_EQ(debug.LastHit.Value, 1);
+}
+
+TEST_F(CPU6502BreakpointsTests, ReadWatchpointOnRangeWithCondition)
+{
+    // Given:
+    Condition When;
+    ASSERT_TRUE(When.Compile("x > 2"));
+    debug.AddWatchpoint(0x0300, 0x03FF, Debugger::READ, When);
+    // When:
+    ExecuteResult Result = cpu.Execute(1000, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::Breakpoint);
+    EXPECT_EQ(debug.LastHit.Kind, Debugger::READ);
+    EXPECT_EQ(debug.LastHit.Address, 0x0303);
+}
+
+TEST_F(CPU6502BreakpointsTests, OnlyPagesWithBreakpointsAreFlagged)
+{
+    // Given:
+    debug.AddBreakpoint(0x1234);
+    debug.AddWatchpoint(0x20FF, 0x2100, Debugger::READ | Debugger::WRITE);
+    // Then:
+    EXPECT_EQ(debug.PageFlags[0x12], Debugger::EXECUTE);
+    EXPECT_EQ(debug.PageFlags[0x20], Debugger::READ | Debugger::WRITE);
+    EXPECT_EQ(debug.PageFlags[0x21], Debugger::READ | Debugger::WRITE);
+    EXPECT_EQ(debug.PageFlags[0x02], 0);
+    // When:
+    debug.RemoveBreakpoint(0x1234);
+    debug.RemoveWatchpoint(0x20FF, 0x2100, Debugger::WRITE);
+    // Then:
+    EXPECT_EQ(debug.PageFlags[0x12], 0);
+    EXPECT_EQ(debug.PageFlags[0x21], Debugger::READ);
+    // When:
+    ExecuteResult Result = cpu.Execute(100, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::BudgetExhausted);
+}
+
+TEST_F(CPU6502BreakpointsTests, ConditionsCompileToBytecode)
+{
+    Condition When;
+    cpu.A = 0x10;
+    cpu.PS = 0x01;
+    mem[0x0042] = 0x07;
+    ASSERT_TRUE(When.Compile("((A == $10)) && !(P & %10) || [0x40 + 2] < 3"));
+    EXPECT_TRUE(When.Evaluate(cpu, mem));
+    ASSERT_TRUE(When.Compile("[$42] - 7 != 0 || a <= 15"));
+    EXPECT_FALSE(When.Evaluate(cpu, mem));
+
+    std::string Error;
+    EXPECT_FALSE(When.Compile("A == Q", &Error));
+    EXPECT_EQ(Error, "unknown register");
+    EXPECT_TRUE(When.Code.empty());
+    EXPECT_FALSE(When.Compile("(A == 1", &Error));
+    EXPECT_EQ(Error, "missing ')'");
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "main_6502.h"
+#include "coroutine_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502CoroutineTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::Scheduler events;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        // loop: INC $10 / HOST_CALL 7 / JMP loop - 10 cycles a trip
+        mem[0x0200] = CPU::INS_INC_ZERO_P;
+        mem[0x0201] = 0x10;
+        mem[0x0202] = CPU::INS_HOST_CALL;
+        mem[0x0203] = 0x07;
+        mem[0x0204] = CPU::INS_JMP_ABS;
+        mem[0x0205] = 0x00;
+        mem[0x0206] = 0x02;
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+namespace
+{
+    // Two plain registers
+    struct Latch : Device
+    {
+        Byte Value[2] = {};
+
+        Byte Read(Word Address, u64 /*Cycle*/) override { return Value[Address & 1]; }
+        void Write(Word Address, Byte Data, u64 /*Cycle*/) override { Value[Address & 1] = Data; }
+    };
+
+    // Minimal eagerly started coroutine to play the host's event loop
+    struct HostTask
+    {
+        struct promise_type
+        {
+            HostTask get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    HostTask CountHostCalls(CPURun &Cpu, int &HostCalls, int &EventStops)
+    {
+        while (auto Result = co_await Cpu)
+        {
+            if (Result->Reason == StopReason::HostCall)
+                HostCalls++;
+            else
+                EventStops++;
+        }
+    }
+}
+
+TEST_F(CPU6502CoroutineTests, YieldsOnTrapsAndEventsUntilDone)
+{
+    // Given:
+    std::vector<u64> Fired;
+    events.Schedule(40, [&](u64 Cycle) { Fired.push_back(Cycle); });
+    CPURun Cpu = RunCoroutine(cpu, mem, events, 100);
+    std::vector<StopReason> Stops;
+    std::vector<u64> StopCycles;
+    // When:
+    while (Cpu.Next())
+    {
+        Stops.push_back(Cpu.Current().Reason);
+        StopCycles.push_back(cpu.CycleCount);
+    }
+    // Then:
+    // host calls end at 7, 17... the event at 40 stops it after the JMP
+    EXPECT_EQ(StopCycles, (std::vector<u64>{7, 17, 27, 37, 40, 47, 57, 67, 77, 87, 97}));
+    EXPECT_EQ(Stops[3], StopReason::HostCall);
+    EXPECT_EQ(Stops[4], StopReason::BudgetExhausted);
+    EXPECT_EQ(Fired, (std::vector<u64>{40}));
+    EXPECT_GE(cpu.CycleCount, 100u);
+    EXPECT_TRUE(Cpu.Done());
+    EXPECT_FALSE(Cpu.Next());
+}
+
+TEST_F(CPU6502CoroutineTests, HostCoroutinesCanAwaitTheCPU)
+{
+    // Given:
+    events.Schedule(1000, [](u64) {});
+    CPURun Cpu = RunCoroutine(cpu, mem, events, 1500);
+    int HostCalls = 0;
+    int EventStops = 0;
+    // When:
+    CountHostCalls(Cpu, HostCalls, EventStops);
+    // Then:
+    EXPECT_EQ(HostCalls, 150);
+    EXPECT_EQ(EventStops, 1);
+    EXPECT_TRUE(Cpu.Done());
+    EXPECT_EQ(mem[0x10], 150);
+}
+
+TEST_F(CPU6502CoroutineTests, FinishesAfterAJAM)
+{
+    // Given:
+    mem[0x0202] = 0x02;
+    CPURun Cpu = RunCoroutine(cpu, mem, events, 1000);
+    // When:
+    ASSERT_TRUE(Cpu.Next());
+    // Then:
+    EXPECT_EQ(Cpu.Current().Reason, StopReason::Halted);
+    EXPECT_EQ(Cpu.Current().PC, 0x0202);
+    EXPECT_FALSE(Cpu.Next());
+}
+
+TEST_F(CPU6502CoroutineTests, StopsAfterEachDeviceAccess)
+{
+    // Given: loop: LDA $4000 / NOP / STA $4001 / JMP loop
+    Latch Registers;
+    Registers.Value[0] = 0x5A;
+    SuspendingDevice Watched{cpu, Registers};
+    mem.Map(&Watched, 0x4000, 0x4001);
+    const Byte Program[] = {0xAD, 0x00, 0x40, 0xEA, 0x8D, 0x01, 0x40, 0x4C, 0x00, 0x03};
+    mem.WriteBlock(0x0300, Program, sizeof(Program));
+    cpu.PC = 0x0300;
+    CPURun Cpu = RunCoroutine(cpu, mem, events, 20, {&Watched});
+    std::vector<u64> StopCycles;
+    std::vector<Word> StopPCs;
+    // When:
+    while (Cpu.Next())
+    {
+        EXPECT_EQ(Cpu.Current().Reason, StopReason::DeviceAccess);
+        StopCycles.push_back(cpu.CycleCount);
+        StopPCs.push_back(Cpu.Current().PC);
+    }
+    // Then: each stop is at the end of the accessing instruction
+    EXPECT_EQ(StopCycles, (std::vector<u64>{4, 10, 17, 23}));
+    EXPECT_EQ(StopPCs, (std::vector<Word>{0x0303, 0x0307, 0x0303, 0x0307}));
+    EXPECT_EQ(Watched.LastAddress, 0x4001);
+    EXPECT_EQ(Registers.Value[1], 0x5A);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "main_6502.h"
+#include "counters_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502CountersTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::InstructionCounters counters;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0xFF00);
+        cpu.Hooks = &counters;
+    }
+
+    virtual void TearDown()
+    {
+        cpu.Hooks = nullptr;
+    }
+};
+
+TEST_F(CPU6502CountersTests, CountsOpcodesPageCrossingsAndStackTraffic)
+{
+    // Given:
+    cpu.X = 0x01;
+    cpu.Y = 0xFF;
+    mem[0xFF00] = CPU::INS_LDA_ABS_X; // $44FF + 1 -> crosses page
+    mem[0xFF01] = 0xFF;
+    mem[0xFF02] = 0x44;
+    mem[0xFF03] = CPU::INS_LDA_IND_Y; // ($02),Y = $8002 + $FF -> crosses page
+    mem[0xFF04] = 0x02;
+    mem[0x0002] = 0x02;
+    mem[0x0003] = 0x80;
+    mem[0xFF05] = CPU::INS_PHA;
+    mem[0xFF06] = CPU::INS_PLA;
+    mem[0xFF07] = CPU::INS_STA_ABS;
+    mem[0xFF08] = 0x00;
+    mem[0xFF09] = 0x02;
+    // When:
+    s32 CyclesUsed = cpu.Execute(5 + 6 + 3 + 4 + 4, mem).Cycles;
+    CounterSnapshot Counts = counters.Snapshot();
+    // Then:
+    EXPECT_EQ(CyclesUsed, 22);
+    EXPECT_EQ(Counts.Instructions, 5u);
+    EXPECT_EQ(Counts.PerOpcode[CPU::INS_LDA_ABS_X], 1u);
+    EXPECT_EQ(Counts.PerOpcode[CPU::INS_PHA], 1u);
+    EXPECT_EQ(Counts.PageCrossings[static_cast<u32>(AddressingMode::AbsoluteX)], 1u);
+    EXPECT_EQ(Counts.PageCrossings[static_cast<u32>(AddressingMode::AbsoluteY)], 0u);
+    EXPECT_EQ(Counts.PageCrossings[static_cast<u32>(AddressingMode::IndirectY)], 1u);
+    EXPECT_EQ(Counts.StackPushes, 1u);
+    EXPECT_EQ(Counts.StackPops, 1u);
+    EXPECT_EQ(Counts.InstructionsWithMode(AddressingMode::Implied), 2u);
+    EXPECT_EQ(Counts.InstructionsWithMode(AddressingMode::Absolute), 1u);
+}
+
+TEST_F(CPU6502CountersTests, CountsReadsAndWritesPerRegion)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_JSR;
+    mem[0xFF01] = 0x00;
+    mem[0xFF02] = 0x20;
+    mem[0x2000] = CPU::INS_LDA_ZEROP;
+    mem[0x2001] = 0x10;
+    mem[0x2002] = CPU::INS_STA_ABS;
+    mem[0x2003] = 0x00;
+    mem[0x2004] = 0x30;
+    // When:
+    cpu.Execute(6 + 3 + 4, mem);
+    CounterSnapshot Counts = counters.Snapshot();
+    // Then:
+    EXPECT_EQ(Counts.ReadsPerPage[0x00], 1u);
+    EXPECT_EQ(Counts.WritesPerPage[0x01], 2u); // JSR return address
+    EXPECT_EQ(Counts.WritesPerPage[0x30], 1u);
+    EXPECT_EQ(Counts.WritesInRegion(0x0000, 0x01FF), 2u);
+    EXPECT_EQ(Counts.WritesInRegion(0x0200, 0xFFFF), 1u);
+    EXPECT_EQ(Counts.StackPushes, 2u);
+}
+
+TEST_F(CPU6502CountersTests, SnapshotIsIndependentOfLaterExecution)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_INX;
+    mem[0xFF01] = CPU::INS_INX;
+    cpu.Execute(2, mem);
+    CounterSnapshot Before = counters.Snapshot();
+    // When:
+    cpu.Execute(2, mem);
+    // Then:
+    EXPECT_EQ(Before.PerOpcode[CPU::INS_INX], 1u);
+    EXPECT_EQ(counters.Snapshot().PerOpcode[CPU::INS_INX], 2u);
+}
+
+TEST_F(CPU6502CountersTests, PublishedCountsAreConsistentAcrossThreads)
+{
+    // Given: a loop of INX / JMP, so instructions == INX + JMP always
+    mem[0xFF00] = CPU::INS_INX;
+    mem[0xFF01] = CPU::INS_JMP_ABS;
+    mem[0xFF02] = 0x00;
+    mem[0xFF03] = 0xFF;
+    EXPECT_EQ(counters.ReadPublished().Instructions, 0u);
+    std::atomic<bool> Done{false};
+    u64 Reads = 0, Torn = 0, Last = 0, Backwards = 0;
+    std::thread Reader([&] {
+        do
+        {
+            CounterSnapshot Counts = counters.ReadPublished();
+            Torn += Counts.Instructions != Counts.PerOpcode[CPU::INS_INX] + Counts.PerOpcode[CPU::INS_JMP_ABS];
+            Backwards += Counts.Instructions < Last;
+            Last = Counts.Instructions;
+            Reads++;
+        } while (!Done.load());
+    });
+    // When:
+    for (u32 Slice = 0; Slice < 2000; Slice++)
+    {
+        cpu.Execute(50, mem);
+        counters.Publish();
+    }
+    Done = true;
+    Reader.join();
+    // Then:
+    EXPECT_GT(Reads, 0u);
+    EXPECT_EQ(Torn, 0u);
+    EXPECT_EQ(Backwards, 0u);
+    EXPECT_EQ(counters.ReadPublished().Instructions, counters.Snapshot().Instructions);
+}
+
+TEST(CPU6502AddressingModeTests, OpcodeTableMatchesInstructionConstants)
+{
+    EXPECT_EQ(CPU::AddressingModeOf(CPU::INS_LDA_IM), AddressingMode::Immediate);
+    EXPECT_EQ(CPU::AddressingModeOf(CPU::INS_LDX_ZEROP_Y), AddressingMode::ZeroPageY);
+    EXPECT_EQ(CPU::AddressingModeOf(CPU::INS_STA_IND_Y), AddressingMode::IndirectY);
+    EXPECT_EQ(CPU::AddressingModeOf(CPU::INS_AND_IND_X), AddressingMode::IndirectX);
+    EXPECT_EQ(CPU::AddressingModeOf(CPU::INS_JMP_IND), AddressingMode::Indirect);
+    EXPECT_EQ(CPU::AddressingModeOf(CPU::INS_INC_ABS_X), AddressingMode::AbsoluteX);
+    EXPECT_EQ(CPU::AddressingModeOf(CPU::INS_TSX), AddressingMode::Implied);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include "main_6502.h"
+#include "diff_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502DiffTests : public testing::Test
+{
+public:
+    std::unique_ptr<cpu6502::Mem> mem = std::make_unique<cpu6502::Mem>();
+    std::unique_ptr<cpu6502::Mem> other = std::make_unique<cpu6502::Mem>();
+    cpu6502::CPU cpu;
+    cpu6502::CPU cpuOther;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(*mem, 0x0200);
+        cpuOther.Reset(*other, 0x0200);
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Byte at a time reference
+    std::vector<MemRange> SlowDiff() const
+    {
+        std::vector<MemRange> Ranges;
+        for (u32 Address = 0; Address < Mem::MAX_MEM; Address++)
+        {
+            if ((*mem)[Address] == (*other)[Address])
+                continue;
+            if (!Ranges.empty() && Ranges.back().Address + Ranges.back().Length == Address)
+                Ranges.back().Length++;
+            else
+                Ranges.push_back({static_cast<Word>(Address), 1});
+        }
+        return Ranges;
+    }
+};
+
+TEST_F(CPU6502DiffTests, RangesAcrossPagesAndAtTheEdges)
+{
+    // Given:
+    (*other)[0x0000] = 1;
+    for (u32 Address = 0x10F0; Address < 0x1210; Address++)
+        (*other)[Address] = 2;
+    (*other)[0x2040] = 3;
+    (*other)[0x2042] = 3;
+    (*other)[0xFFFF] = 4;
+    // When:
+    std::vector<MemRange> Ranges = DiffMemory(*mem, *other);
+    // Then:
+    std::vector<MemRange> Expected = {{0x0000, 1}, {0x10F0, 0x120}, {0x2040, 1}, {0x2042, 1}, {0xFFFF, 1}};
+    EXPECT_EQ(Ranges, Expected);
+}
+
+TEST_F(CPU6502DiffTests, MatchesByteAtATimeOnRandomChanges)
+{
+    // Given:
+    std::mt19937 Random(6502);
+    for (u32 i = 0; i < 3000; i++)
+    {
+        u32 Address = Random() % Mem::MAX_MEM;
+        u32 Run = 1 + Random() % 80;
+        for (u32 j = 0; j < Run && Address + j < Mem::MAX_MEM; j++)
+            (*other)[Address + j] = static_cast<Byte>(Random());
+    }
+    // Then:
+    EXPECT_EQ(DiffMemory(*mem, *other), SlowDiff());
+}
+
+TEST_F(CPU6502DiffTests, OnlyPagesWrittenSinceTheCheckpoints)
+{
+    // Given: both sides equal at their checkpoints
+    const u32 SinceA = mem->Checkpoint();
+    const u32 SinceB = other->Checkpoint();
+    const Byte Data[] = {9, 9};
+    other->WriteBlock(0x3000, Data, 2);
+    mem->Fill(0x4000, 7, 1);
+    (*other)[0x5000] = 1; // untracked poke, not looked at
+    // When:
+    std::vector<MemRange> Ranges = DiffMemory(*mem, *other, SinceA, SinceB);
+    // Then:
+    std::vector<MemRange> Expected = {{0x3000, 2}, {0x4000, 1}};
+    EXPECT_EQ(Ranges, Expected);
+    EXPECT_EQ(DiffMemory(*mem, *other).size(), 3u);
+}
+
+TEST_F(CPU6502DiffTests, CompareStateReportsRegistersAndMemory)
+{
+    // Given:
+    cpuOther.A = 0x42;
+    cpuOther.PC = 0x0205;
+    cpuOther.flags.NotUsedBit = !cpu.flags.NotUsedBit;
+    cpuOther.SetIRQ(1, true);
+    (*other)[0x0300] = 0x11;
+    (*other)[0x0301] = 0x22;
+    // When:
+    StateDiff Diff = CompareState(cpu, *mem, cpuOther, *other);
+    // Then:
+    EXPECT_FALSE(Diff.Equal());
+    EXPECT_EQ(Diff.Registers, StateDiff::A | StateDiff::PC | StateDiff::INTERRUPTS);
+    EXPECT_EQ(Diff.Describe(cpu, *mem, cpuOther, *other),
+              "PC $0200 / $0205\n"
+              "A $00 / $42\n"
+              "IRQ lines $0 / $1\n"
+              "$0300-$0301 2 bytes: 00 00 / 11 22\n");
+    EXPECT_TRUE(CompareState(cpu, *mem, cpu, *mem).Equal());
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include "main_6502.h"
+#include "dma_6502.h"
+#include "scheduler_6502.h"
+
+using namespace cpu6502;
+
+namespace
+{
+    // Sprite attribute memory that only takes bulk writes
+    struct SpriteMemory : Device
+    {
+        Byte OAM[256] = {};
+        u32 BlockWrites = 0;
+        u32 ByteWrites = 0;
+
+        Byte Read(Word Address, u64 /*Cycle*/) override { return OAM[Address & 0xFF]; }
+        void Write(Word Address, Byte Value, u64 /*Cycle*/) override
+        {
+            ByteWrites++;
+            OAM[Address & 0xFF] = Value;
+        }
+        void WriteBlock(Word Address, const Byte *Data, u32 Count, u64 /*Cycle*/) override
+        {
+            BlockWrites++;
+            memcpy(&OAM[Address & 0xFF], Data, Count);
+        }
+    };
+
+    // Source page owned by a device, each byte reads as its low address byte
+    struct CountingROM : Device
+    {
+        Byte Read(Word Address, u64 /*Cycle*/) override { return Address & 0xFF; }
+        void Write(Word /*Address*/, Byte /*Value*/, u64 /*Cycle*/) override {}
+    };
+}
+
+class CPU6502DmaTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    SpriteMemory Sprites;
+    cpu6502::DMA SpriteDMA{cpu, mem, 0x2000};
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        mem.Map(&Sprites, 0x2000, 0x20FF);
+        mem.Map(&SpriteDMA, 0x4000, 0x40FF);
+        // LDA #$03 / STA $4014
+        mem[0x0200] = CPU::INS_LDA_IM;
+        mem[0x0201] = 0x03;
+        mem[0x0202] = CPU::INS_STA_ABS;
+        mem[0x0203] = 0x14;
+        mem[0x0204] = 0x40;
+        mem[0x0205] = CPU::INS_NOP;
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502DmaTests, CopiesAPageInOneBlockWrite)
+{
+    // Given:
+    for (u32 i = 0; i < 256; i++)
+        mem[0x0300 + i] = static_cast<Byte>(i ^ 0x5A);
+    // When:
+    cpu.Execute(6, mem);
+    // Then:
+    EXPECT_EQ(SpriteDMA.Transfers, 1u);
+    EXPECT_EQ(Sprites.BlockWrites, 1u);
+    EXPECT_EQ(Sprites.ByteWrites, 0u);
+    for (u32 i = 0; i < 256; i++)
+        EXPECT_EQ(Sprites.OAM[i], static_cast<Byte>(i ^ 0x5A));
+}
+
+TEST_F(CPU6502DmaTests, StallIsChargedToTheBudget)
+{
+    // Given:
+    const u64 Start = cpu.CycleCount;
+    // When:
+    ExecuteResult Result = cpu.Execute(6, mem);
+    // Then: the write lands on an odd cycle, one more for alignment
+    EXPECT_EQ(Result.Cycles, 6 + 514);
+    EXPECT_EQ(Result.Reason, StopReason::BudgetExhausted);
+    EXPECT_EQ(cpu.CycleCount - Start, 6u + 514u);
+    EXPECT_EQ(cpu.PC, 0x0205);
+}
+
+TEST_F(CPU6502DmaTests, StallAlignsToEvenCycles)
+{
+    // Given: a 3 cycle zero page load first moves the write to an even cycle
+    mem[0x0200] = CPU::INS_LDA_ZEROP;
+    mem[0x0201] = 0x10;
+    mem[0x0202] = CPU::INS_LDA_IM;
+    mem[0x0203] = 0x03;
+    mem[0x0204] = CPU::INS_STA_ABS;
+    mem[0x0205] = 0x14;
+    mem[0x0206] = 0x40;
+    // When:
+    ExecuteResult Result = cpu.Execute(9, mem);
+    // Then:
+    EXPECT_EQ(Result.Cycles, 9 + 513);
+}
+
+TEST_F(CPU6502DmaTests, StallOutsideExecuteAddsToCycleCount)
+{
+    // Given:
+    const u64 Start = cpu.CycleCount;
+    // When:
+    SpriteDMA.Write(0x4014, 0x03, cpu.CycleCount);
+    // Then:
+    EXPECT_EQ(cpu.CycleCount - Start, u64(DMA::STALL_CYCLES + (Start & 1)));
+}
+
+TEST_F(CPU6502DmaTests, EventsDueDuringTheStallFireOnTime)
+{
+    // Given: the same 1000 cycles without and with an event due 100 cycles
+    // into the 514 cycle stall
+    auto Run = [&](bool WithEvent, u64 &SeenAt)
+    {
+        SetUp();
+        mem[0x0206] = CPU::INS_JMP_ABS;
+        mem[0x0207] = 0x06;
+        mem[0x0208] = 0x02;
+        Scheduler Events;
+        if (WithEvent)
+            Events.Schedule(cpu.CycleCount + 100, [&](u64) { SeenAt = cpu.CycleCount; });
+        Events.RunUntil(cpu, mem, cpu.CycleCount + 1000);
+    };
+    u64 Unused = 0, SeenAt = 0;
+    Run(false, Unused);
+    const u64 PlainEnd = cpu.CycleCount;
+    const Word PlainPC = cpu.PC;
+    // When:
+    Run(true, SeenAt);
+    // Then: the event sees the cycle it was due on, one later as the write
+    // that started the stall ends after it, and the rest of the stall follows
+    EXPECT_GE(SeenAt, 100u);
+    EXPECT_LE(SeenAt, 101u);
+    EXPECT_EQ(cpu.StallOwed, 0u);
+    EXPECT_EQ(cpu.CycleCount, PlainEnd);
+    EXPECT_EQ(cpu.PC, PlainPC);
+}
+
+TEST_F(CPU6502DmaTests, RAMTargetAndDeviceSource)
+{
+    // Given: unaligned target in plain RAM, source page owned by a device
+    CountingROM ROM;
+    mem.Map(&ROM, 0x0300, 0x03FF);
+    DMA Copier{cpu, mem, 0x0480};
+    // When:
+    Copier.Start(0x03, 0);
+    // Then:
+    for (u32 i = 0; i < 256; i++)
+        EXPECT_EQ(mem[0x0480 + i], static_cast<Byte>(i));
+    EXPECT_EQ(mem[0x047F], 0x00);
+    EXPECT_EQ(mem[0x0580], 0x00);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "main_6502.h"
+#include "diff_6502.h"
+#include "fork_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502ForkTests : public testing::Test
+{
+public:
+    std::unique_ptr<cpu6502::Mem> mem = std::make_unique<cpu6502::Mem>();
+    std::unique_ptr<cpu6502::ForkRunner> runner = std::make_unique<cpu6502::ForkRunner>();
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(*mem, 0x0200);
+        // Doubles the input at $0300 into $0400, then spins
+        const Byte Program[] = {
+            0xAD, 0x00, 0x03, //       LDA $0300
+            0x0A,             //       ASL
+            0x8D, 0x00, 0x04, //       STA $0400
+            0x4C, 0x07, 0x02, // spin: JMP spin
+        };
+        mem->WriteBlock(0x0200, Program, sizeof(Program));
+        mem->Fill(0x8000, 0xEA, 0x1000); // more pages to share
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502ForkTests, ForkSharesEveryPage)
+{
+    // Given:
+    Machine Parent = Machine::Capture(cpu, *mem);
+    // When:
+    Machine Child = Parent.Fork();
+    // Then:
+    EXPECT_EQ(Child.PagesNotSharedWith(Parent), 0u);
+    EXPECT_EQ(Child.cpu.PC, 0x0200);
+    EXPECT_NE(Parent.Pages[0x02], nullptr);
+    EXPECT_EQ(Parent.Pages[0x05], nullptr); // all zero
+    EXPECT_EQ(Parent.Pages[0x80].use_count(), 2);
+}
+
+TEST_F(CPU6502ForkTests, ChildrenRunDifferentInputs)
+{
+    // Given:
+    Machine Parent = Machine::Capture(cpu, *mem);
+    std::vector<Machine> Children;
+    for (u32 Input = 0; Input < 16; Input++)
+        Children.push_back(Parent.Fork());
+    // When: each child gets its own input
+    for (u32 Input = 0; Input < 16; Input++)
+    {
+        runner->Load(Children[Input]);
+        runner->memory.Fill(0x0300, static_cast<Byte>(Input + 1), 1);
+        Children[Input].cpu.Execute(13, runner->memory);
+        runner->Store(Children[Input]);
+    }
+    // Then: only the input and output pages are their own
+    for (u32 Input = 0; Input < 16; Input++)
+    {
+        EXPECT_EQ(Children[Input].PagesNotSharedWith(Parent), 2u);
+        EXPECT_EQ(Children[Input].Pages[0x04]->Bytes[0], (Input + 1) * 2);
+        EXPECT_EQ(Children[Input].cpu.PC, 0x0207);
+    }
+    EXPECT_EQ(Parent.cpu.PC, 0x0200);
+    EXPECT_EQ(Parent.Pages[0x04], nullptr);
+}
+
+TEST_F(CPU6502ForkTests, LoadOnlyCopiesPagesThatDiffer)
+{
+    // Given: the first load copies every page that is not all zeros
+    Machine Parent = Machine::Capture(cpu, *mem);
+    runner->Load(Parent);
+    const u64 First = runner->PagesCopied;
+    Machine A = Parent.Fork(), B = Parent.Fork();
+    // When: run A, then switch to B
+    runner->Run(A, 13);
+    const u64 BeforeB = runner->PagesCopied;
+    runner->Load(B);
+    // Then: B only needs the page A wrote back
+    EXPECT_EQ(First, 17u); // $02xx, $80xx-$8Fxx
+    EXPECT_EQ(BeforeB, First);
+    EXPECT_EQ(runner->PagesCopied - BeforeB, 1u);
+    EXPECT_EQ(runner->memory[0x0400], 0);
+}
+
+TEST_F(CPU6502ForkTests, RunningAForkMatchesRunningTheOriginal)
+{
+    // Given:
+    (*mem)[0x0300] = 0x21;
+    Machine Fork = Machine::Capture(cpu, *mem);
+    // When:
+    cpu.Execute(100, *mem);
+    runner->Run(Fork, 100);
+    // Then:
+    StateDiff Diff = CompareState(cpu, *mem, Fork.cpu, runner->memory);
+    EXPECT_TRUE(Diff.Equal()) << Diff.Describe(cpu, *mem, Fork.cpu, runner->memory);
+    EXPECT_EQ(runner->memory[0x0400], 0x42);
+}
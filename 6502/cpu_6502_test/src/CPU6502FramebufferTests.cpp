@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "main_6502.h"
+#include "dma_6502.h"
+#include "framebuffer_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502FramebufferTests : public testing::Test
+{
+public:
+    static constexpr u32 FRAME = 1000;
+
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::Scheduler events;
+    // 32x16, four tiles by two
+    cpu6502::Framebuffer fb{events, 0x3000, 32, 16, FRAME};
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        mem.Map(&fb, 0x3000, 0x31FF);
+        // loop: JMP loop
+        mem[0x0200] = CPU::INS_JMP_ABS;
+        mem[0x0201] = 0x00;
+        mem[0x0202] = 0x02;
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    Framebuffer::Frame RunFrame()
+    {
+        events.RunUntil(cpu, mem, fb.Frames * FRAME + FRAME + 1);
+        Framebuffer::Frame Image;
+        EXPECT_TRUE(fb.NextFrame(Image));
+        return Image;
+    }
+};
+
+TEST_F(CPU6502FramebufferTests, FirstFrameCoversTheScreen)
+{
+    // When:
+    Framebuffer::Frame Image = RunFrame();
+    // Then:
+    EXPECT_EQ(Image.Number, 1u);
+    EXPECT_EQ(Image.Cycle, FRAME);
+    EXPECT_EQ(Image.X, 0u);
+    EXPECT_EQ(Image.Y, 0u);
+    EXPECT_EQ(Image.Width, 32u);
+    EXPECT_EQ(Image.Height, 16u);
+    EXPECT_EQ(Image.Pixels.size(), 32u * 16u);
+    EXPECT_EQ(Image.Hash, fb.Hash);
+}
+
+TEST_F(CPU6502FramebufferTests, GuestWriteOnlyShipsItsTile)
+{
+    // Given: STA to pixel (19, 10), in tile column 2, row 1
+    RunFrame();
+    mem[0x0200] = CPU::INS_LDA_IM;
+    mem[0x0201] = 0x2A;
+    mem[0x0202] = CPU::INS_STA_ABS;
+    mem[0x0203] = (10 * 32 + 19) & 0xFF;
+    mem[0x0204] = 0x30 + ((10 * 32 + 19) >> 8);
+    mem[0x0205] = CPU::INS_JMP_ABS;
+    mem[0x0206] = 0x05;
+    mem[0x0207] = 0x02;
+    const u64 Before = fb.Hash;
+    // When:
+    Framebuffer::Frame Image = RunFrame();
+    // Then:
+    EXPECT_EQ(fb.Pixel(19, 10), 0x2A);
+    EXPECT_EQ(Image.X, 16u);
+    EXPECT_EQ(Image.Y, 8u);
+    EXPECT_EQ(Image.Width, 8u);
+    EXPECT_EQ(Image.Height, 8u);
+    EXPECT_EQ(Image.Pixels[2 * 8 + 3], 0x2A);
+    EXPECT_NE(Image.Hash, Before);
+
+    // When: nothing changes
+    Image = RunFrame();
+    // Then:
+    EXPECT_EQ(Image.Width, 0u);
+    EXPECT_TRUE(Image.Pixels.empty());
+    EXPECT_EQ(Image.Hash, fb.Hash);
+}
+
+TEST_F(CPU6502FramebufferTests, EdgeTilesAreCutShort)
+{
+    // Given: 100x100, the last tile row and column are 4 pixels
+    Scheduler OtherEvents;
+    Framebuffer Odd{OtherEvents, 0x4000, 100, 100, FRAME};
+    OtherEvents.RunUntil(cpu, mem, FRAME + 1);
+    Framebuffer::Frame Image;
+    ASSERT_TRUE(Odd.NextFrame(Image));
+    EXPECT_EQ(Image.Width, 100u);
+    EXPECT_EQ(Image.Height, 100u);
+    const u64 Before = Odd.Hash;
+    // When: the very last pixel
+    Odd.Write(0x4000 + 9999, 0x2A, 0);
+    OtherEvents.RunUntil(cpu, mem, 2 * FRAME + 1);
+    // Then:
+    ASSERT_TRUE(Odd.NextFrame(Image));
+    EXPECT_EQ(Image.X, 96u);
+    EXPECT_EQ(Image.Y, 96u);
+    EXPECT_EQ(Image.Width, 4u);
+    EXPECT_EQ(Image.Height, 4u);
+    EXPECT_EQ(Image.Pixels[15], 0x2A);
+    EXPECT_NE(Image.Hash, Before);
+}
+
+TEST_F(CPU6502FramebufferTests, BlockWritesMarkTilesByColumn)
+{
+    // Given: 100x100, row 1 starts 4 pixels into a tile
+    Scheduler BlockEvents, ByteEvents;
+    Framebuffer Block{BlockEvents, 0x4000, 100, 100, FRAME};
+    Framebuffer Bytes{ByteEvents, 0x4000, 100, 100, FRAME};
+    BlockEvents.RunDue(FRAME);
+    ByteEvents.RunDue(FRAME);
+    Framebuffer::Frame Image;
+    ASSERT_TRUE(Block.NextFrame(Image));
+    ASSERT_TRUE(Bytes.NextFrame(Image));
+    Byte Row[10];
+    for (u32 i = 0; i < 10; i++)
+        Row[i] = static_cast<Byte>(i + 1);
+    // When: columns 90-99 of row 1, tiles 11 and 12
+    Block.WriteBlock(0x4000 + 190, Row, 10, 0);
+    for (u32 i = 0; i < 10; i++)
+        Bytes.Write(static_cast<Word>(0x4000 + 190 + i), Row[i], 0);
+    BlockEvents.RunDue(2 * FRAME);
+    ByteEvents.RunDue(2 * FRAME);
+    // Then:
+    ASSERT_TRUE(Block.NextFrame(Image));
+    EXPECT_EQ(Image.X, 88u);
+    EXPECT_EQ(Image.Y, 0u);
+    EXPECT_EQ(Image.Width, 12u);
+    EXPECT_EQ(Image.Height, 8u);
+    EXPECT_EQ(Image.Pixels[12 + 11], 10);
+    EXPECT_EQ(Block.Hash, Bytes.Hash);
+}
+
+TEST_F(CPU6502FramebufferTests, DMAAtAnOddWidthMatchesByteWrites)
+{
+    // Given: a page from row 7 column 90 to row 10 column 45, only its
+    // first 10 bytes are in the top row of tiles
+    Scheduler ByteEvents;
+    Framebuffer Block{events, 0x4000, 100, 100, FRAME};
+    Framebuffer Bytes{ByteEvents, 0x4000, 100, 100, FRAME};
+    mem.Map(&Block, 0x4000, 0x4000 + 9999);
+    RunFrame();
+    Framebuffer::Frame Image;
+    ASSERT_TRUE(Block.NextFrame(Image));
+    for (u32 i = 0; i < 256; i++)
+        mem[0x0400 + i] = static_cast<Byte>(i | 1);
+    DMA Blitter{cpu, mem, 0x4000 + 790};
+    // When:
+    Blitter.Start(0x04, cpu.CycleCount);
+    for (u32 i = 0; i < 256; i++)
+        Bytes.Write(static_cast<Word>(0x4000 + 790 + i), static_cast<Byte>(i | 1), 0);
+    events.RunUntil(cpu, mem, 2 * FRAME + 1);
+    ByteEvents.RunDue(2 * FRAME);
+    // Then: both rows of tiles, right edge included
+    ASSERT_TRUE(Block.NextFrame(Image));
+    EXPECT_EQ(Image.X, 0u);
+    EXPECT_EQ(Image.Y, 0u);
+    EXPECT_EQ(Image.Width, 100u);
+    EXPECT_EQ(Image.Height, 16u);
+    EXPECT_EQ(Block.Hash, Bytes.Hash);
+}
+
+TEST_F(CPU6502FramebufferTests, HashDependsOnlyOnTheScreen)
+{
+    // Given: the same picture drawn in a different order, with detours
+    Scheduler OtherEvents;
+    Framebuffer Other{OtherEvents, 0x3000, 32, 16, FRAME};
+    fb.Write(0x3000, 1, 0);
+    fb.Write(0x3123, 2, 0);
+    RunFrame();
+    Other.Write(0x3123, 7, 0);
+    Other.Write(0x3123, 2, 0);
+    Other.Write(0x3000, 1, 0);
+    Other.Write(0x3010, 5, 0);
+    Other.Write(0x3010, 0, 0);
+    // When:
+    OtherEvents.RunDue(FRAME);
+    // Then:
+    EXPECT_EQ(Other.Hash, fb.Hash);
+    // When: moving a pixel to another tile
+    Other.Write(0x3000, 0, 0);
+    Other.Write(0x3008, 1, 0);
+    OtherEvents.RunDue(2 * FRAME);
+    // Then:
+    EXPECT_NE(Other.Hash, fb.Hash);
+}
+
+TEST_F(CPU6502FramebufferTests, DroppedFramesCarryTheirTilesOver)
+{
+    // Given: the host takes no frames
+    events.RunUntil(cpu, mem, FRAME * Framebuffer::FRAME_QUEUE + 1);
+    fb.Write(0x3000, 9, 0);
+    events.RunUntil(cpu, mem, FRAME * (Framebuffer::FRAME_QUEUE + 1) + 1);
+    fb.Write(0x31FF, 9, 0);
+    events.RunUntil(cpu, mem, FRAME * (Framebuffer::FRAME_QUEUE + 2) + 1);
+    // When:
+    Framebuffer::Frame Image;
+    for (u32 i = 0; i < Framebuffer::FRAME_QUEUE; i++)
+        ASSERT_TRUE(fb.NextFrame(Image));
+    fb.Write(0x3100, 3, 0);
+    Image = RunFrame();
+    // Then: both corners dropped earlier plus the new write
+    EXPECT_EQ(fb.DroppedFrames, 2u);
+    EXPECT_EQ(Image.Width, 32u);
+    EXPECT_EQ(Image.Height, 16u);
+    EXPECT_EQ(Image.Pixels[0], 9);
+    EXPECT_EQ(Image.Pixels[32 * 16 - 1], 9);
+    EXPECT_EQ(Image.Pixels[32 * 8], 3);
+}
+
+TEST_F(CPU6502FramebufferTests, DMAIntoTheScreenAndWritePPM)
+{
+    // Given: a 256 byte block lands on rows 0-7
+    RunFrame();
+    for (u32 i = 0; i < 256; i++)
+        mem[0x0400 + i] = static_cast<Byte>(i);
+    DMA Blitter{cpu, mem, 0x3000};
+    Blitter.Start(0x04, 0);
+    // When:
+    Framebuffer::Frame Image = RunFrame();
+    FILE *File = tmpfile();
+    ASSERT_NE(File, nullptr);
+    const u32 Palette[256] = {0x123456};
+    bool Written = Framebuffer::WritePPM(File, Image, Palette);
+    // Then:
+    EXPECT_EQ(Image.Width, 32u);
+    EXPECT_EQ(Image.Height, 8u);
+    EXPECT_EQ(Image.Pixels[255], 255);
+    ASSERT_TRUE(Written);
+    rewind(File);
+    char Header[16] = {};
+    ASSERT_EQ(fread(Header, 1, 11, File), 11u);
+    EXPECT_STREQ(Header, "P6\n32 8\n255");
+    Byte RGB[3];
+    ASSERT_EQ(fread(RGB, 1, 1, File), 1u);
+    ASSERT_EQ(fread(RGB, 1, 3, File), 3u);
+    EXPECT_EQ(RGB[0], 0x12);
+    EXPECT_EQ(RGB[2], 0x56);
+    fclose(File);
+}
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string.h>
+#include "main_6502.h"
+#include "fuzz_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502FuzzTests : public testing::Test
+{
+public:
+    std::unique_ptr<cpu6502::FuzzTarget> target = std::make_unique<cpu6502::FuzzTarget>();
+
+    virtual void SetUp()
+    {
+        target->cpu.Reset(target->memory, 0x0200);
+        // Input at $0400, length at $FE. Jams on "FU", else copies the
+        // input to $0300 and stops with a host call.
+        const Byte Program[] = {
+            0xAD, 0x00, 0x04, //       LDA $0400
+            0xC9, 0x46,       //       CMP #'F'
+            0xD0, 0x0A,       //       BNE copy
+            0xAD, 0x01, 0x04, //       LDA $0401
+            0xC9, 0x55,       //       CMP #'U'
+            0xD0, 0x03,       //       BNE copy
+            0x02,             //       JAM
+            0xEA, 0xEA,       //       NOP NOP
+            0xA0, 0x00,       // copy: LDY #0
+            0xC4, 0xFE,       // loop: CPY $FE
+            0xF0, 0x0A,       //       BEQ done
+            0xB9, 0x00, 0x04, //       LDA $0400,Y
+            0x99, 0x00, 0x03, //       STA $0300,Y
+            0xC8,             //       INY
+            0x4C, 0x13, 0x02, //       JMP loop
+            0x42, 0x00,       // done: HOST_CALL 0
+        };
+        target->memory.WriteBlock(0x0200, Program, sizeof(Program));
+        target->Config.LengthAddress = 0x00FE;
+        target->Config.MaxInput = 0xFF;
+        target->Snapshot();
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    FuzzTarget::Outcome Run(const char *Input)
+    {
+        return target->Run(reinterpret_cast<const Byte *>(Input), strlen(Input));
+    }
+};
+
+TEST_F(CPU6502FuzzTests, RunsInputToTheHostCall)
+{
+    // When:
+    FuzzTarget::Outcome Result = Run("abc");
+    // Then:
+    EXPECT_EQ(Result, FuzzTarget::Outcome::Finished);
+    EXPECT_EQ(target->Last.PC, 0x0221);
+    EXPECT_EQ(target->memory[0x00FE], 3);
+    EXPECT_EQ(target->memory[0x0300], 'a');
+    EXPECT_EQ(target->memory[0x0302], 'c');
+    EXPECT_EQ(target->Runs, 1u);
+}
+
+TEST_F(CPU6502FuzzTests, JamIsACrash)
+{
+    // When:
+    FuzzTarget::Outcome Result = Run("FUZZ");
+    // Then:
+    EXPECT_EQ(Result, FuzzTarget::Outcome::Crashed);
+    EXPECT_EQ(target->Last.Reason, StopReason::Halted);
+    EXPECT_EQ(target->Last.PC, 0x020E);
+}
+
+TEST_F(CPU6502FuzzTests, CycleLimitIsATimeout)
+{
+    // Given:
+    target->Config.CycleLimit = 50;
+    // When:
+    FuzzTarget::Outcome Result = Run("a long enough input to run past the limit");
+    // Then:
+    EXPECT_EQ(Result, FuzzTarget::Outcome::Timeout);
+}
+
+TEST_F(CPU6502FuzzTests, RunsStartFromTheSnapshot)
+{
+    // Given: a long run writes more of $0300 than a short one
+    Run("abcdefgh");
+    // When:
+    FuzzTarget::Outcome Result = Run("xy");
+    // Then: nothing of the first run is left behind
+    EXPECT_EQ(Result, FuzzTarget::Outcome::Finished);
+    EXPECT_EQ(target->memory[0x0300], 'x');
+    EXPECT_EQ(target->memory[0x0302], 0);
+    EXPECT_EQ(target->memory[0x0402], 0);
+    EXPECT_EQ(target->memory[0x00FE], 2);
+}
+
+TEST_F(CPU6502FuzzTests, RestoreOnlyCopiesWrittenPages)
+{
+    // Given:
+    Run("abc");
+    u64 Before = target->PagesRestored;
+    // When:
+    Run("abc");
+    // Then: zero page, input and output
+    EXPECT_EQ(target->PagesRestored - Before, 3u);
+}
+
+TEST_F(CPU6502FuzzTests, LongInputsAreCut)
+{
+    // Given:
+    target->Config.MaxInput = 4;
+    // When:
+    Run("abcdefgh");
+    // Then:
+    EXPECT_EQ(target->memory[0x00FE], 4);
+    EXPECT_EQ(target->memory[0x0403], 'd');
+    EXPECT_EQ(target->memory[0x0404], 0);
+}
+
+TEST_F(CPU6502FuzzTests, CoverageSeesNewPaths)
+{
+    // Given:
+    Run("abc");
+    u32 Copy = target->EdgesHit();
+    // When:
+    Run("Fx");
+    u32 AfterF = target->EdgesHit();
+    Run("FUZZ");
+    u32 AfterFU = target->EdgesHit();
+    // Then: every new branch outcome adds an edge
+    EXPECT_GT(Copy, 0u);
+    EXPECT_GT(AfterF, Copy);
+    EXPECT_GT(AfterFU, AfterF);
+}
+
+TEST_F(CPU6502FuzzTests, CoverageIsDeterministic)
+{
+    // Given:
+    Run("hello");
+    std::unique_ptr<Byte[]> First(new Byte[CPU::COVERAGE_SIZE]);
+    memcpy(First.get(), target->Map, CPU::COVERAGE_SIZE);
+    target->ClearCoverage();
+    EXPECT_EQ(target->EdgesHit(), 0u);
+    // When:
+    Run("world");
+    // Then: same length, same path, same counts
+    EXPECT_EQ(memcmp(First.get(), target->Map, CPU::COVERAGE_SIZE), 0);
+}
+
+TEST_F(CPU6502FuzzTests, CoverageGoesToTheGivenMap)
+{
+    // Given:
+    std::unique_ptr<Byte[]> External(new Byte[CPU::COVERAGE_SIZE]());
+    target->Map = External.get();
+    // When:
+    Run("abc");
+    // Then:
+    EXPECT_GT(target->EdgesHit(), 0u);
+    target->Map = target->Bitmap;
+    EXPECT_EQ(target->EdgesHit(), 0u);
+}
+
+TEST_F(CPU6502FuzzTests, RunsWithoutAMap)
+{
+    // Given:
+    target->Map = nullptr;
+    // When:
+    FuzzTarget::Outcome Result = Run("abc");
+    target->ClearCoverage();
+    // Then:
+    EXPECT_EQ(Result, FuzzTarget::Outcome::Finished);
+    EXPECT_EQ(target->EdgesHit(), 0u);
+    EXPECT_EQ(target->cpu.Coverage, nullptr);
+    target->Map = target->Bitmap;
+    EXPECT_EQ(target->EdgesHit(), 0u);
+}
+
+TEST_F(CPU6502FuzzTests, LoopCountsEdgeHits)
+{
+    // Given:
+    target->cpu.Reset(target->memory, 0x0200);
+    CPU &cpu = target->cpu;
+    std::unique_ptr<Byte[]> Map(new Byte[CPU::COVERAGE_SIZE]());
+    cpu.Coverage = Map.get();
+    target->memory[0x0200] = CPU::INS_DEX;
+    target->memory[0x0201] = CPU::INS_BNE;
+    target->memory[0x0202] = 0xFD;
+    cpu.X = 4;
+    // When:
+    cpu.Execute(19, target->memory);
+    // Then: 3 taken and 1 not taken, the taken edge repeats
+    u32 Edges = 0, Hits = 0, Most = 0;
+    for (u32 i = 0; i < CPU::COVERAGE_SIZE; i++)
+    {
+        u32 Count = Map[i];
+        Edges += Count != 0;
+        Hits += Count;
+        Most = Count > Most ? Count : Most;
+    }
+    EXPECT_EQ(Hits, 4u);
+    EXPECT_EQ(Most, 2u);
+    EXPECT_EQ(Edges, 3u);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "main_6502.h"
+#include "heatmap_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502HeatmapTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0xFF00);
+        // 0xFF00: LDA $1234 / STA $0210 / STA $0211
+        mem[0xFF00] = CPU::INS_LDA_ABS;
+        mem[0xFF01] = 0x34;
+        mem[0xFF02] = 0x12;
+        mem[0xFF03] = CPU::INS_STA_ABS;
+        mem[0xFF04] = 0x10;
+        mem[0xFF05] = 0x02;
+        mem[0xFF06] = CPU::INS_STA_ABS;
+        mem[0xFF07] = 0x11;
+        mem[0xFF08] = 0x02;
+    }
+
+    virtual void TearDown()
+    {
+        cpu.Hooks = nullptr;
+    }
+};
+
+TEST_F(CPU6502HeatmapTests, CountsAccessesPerPage)
+{
+    // Given:
+    MemoryHeatmap heatmap;
+    cpu.Hooks = &heatmap;
+    // When:
+    cpu.Execute(12, mem);
+    // Then:
+    EXPECT_EQ(heatmap.PageReads[0x12], 1u);
+    EXPECT_EQ(heatmap.PageWrites[0x02], 2u);
+    EXPECT_EQ(heatmap.PageExecutes[0xFF], 3u);
+    EXPECT_TRUE(heatmap.ByteReads.empty());
+    // page 0x02 -> 16x16 block at row 0, column 32
+    EXPECT_EQ(heatmap.Cell(5, 35, HeatmapKind::Writes), 2u);
+    EXPECT_EQ(heatmap.Cell(255, 255, HeatmapKind::Executes), 3u);
+}
+
+TEST_F(CPU6502HeatmapTests, CountsAccessesPerByte)
+{
+    // Given:
+    MemoryHeatmap heatmap(true);
+    cpu.Hooks = &heatmap;
+    // When:
+    cpu.Execute(12, mem);
+    // Then:
+    EXPECT_EQ(heatmap.ByteReads[0x1234], 1u);
+    EXPECT_EQ(heatmap.ByteWrites[0x0210], 1u);
+    EXPECT_EQ(heatmap.ByteWrites[0x0211], 1u);
+    EXPECT_EQ(heatmap.ByteExecutes[0xFF03], 1u);
+    EXPECT_EQ(heatmap.ByteExecutes[0xFF04], 0u);
+    EXPECT_EQ(heatmap.Cell(0x02, 0x11, HeatmapKind::Writes), 1u);
+    EXPECT_EQ(heatmap.Cell(0x12, 0x34, HeatmapKind::All), 1u);
+}
+
+TEST_F(CPU6502HeatmapTests, ExportsPPMAndCSV)
+{
+    // Given:
+    MemoryHeatmap heatmap(true);
+    cpu.Hooks = &heatmap;
+    cpu.Execute(12, mem);
+    const char *PPMPath = "CPU6502HeatmapTests.ppm";
+    const char *CSVPath = "CPU6502HeatmapTests.csv";
+    // When:
+    ASSERT_TRUE(heatmap.WritePPM(PPMPath));
+    ASSERT_TRUE(heatmap.WriteCSV(CSVPath, HeatmapKind::Writes));
+    std::ifstream PPM(PPMPath, std::ios::binary);
+    std::stringstream Image;
+    Image << PPM.rdbuf();
+    std::ifstream CSV(CSVPath);
+    std::vector<std::string> Lines;
+    for (std::string Line; std::getline(CSV, Line);)
+        Lines.push_back(Line);
+    std::remove(PPMPath);
+    std::remove(CSVPath);
+    // Then:
+    std::string Header = "P6\n256 256\n255\n";
+    ASSERT_EQ(Image.str().size(), Header.size() + 256 * 256 * 3);
+    EXPECT_EQ(Image.str().substr(0, Header.size()), Header);
+    // red channel saturates on the most written byte
+    EXPECT_EQ(Byte(Image.str()[Header.size() + (0x0210 * 3)]), 255);
+    ASSERT_EQ(Lines.size(), 256u);
+    std::vector<std::string> Cells;
+    std::stringstream Row(Lines[0x02]);
+    for (std::string Cell; std::getline(Row, Cell, ',');)
+        Cells.push_back(Cell);
+    ASSERT_EQ(Cells.size(), 256u);
+    EXPECT_EQ(Cells[0x0F], "0");
+    EXPECT_EQ(Cells[0x10], "1");
+    EXPECT_EQ(Cells[0x11], "1");
+}
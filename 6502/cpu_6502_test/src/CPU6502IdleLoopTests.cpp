@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "main_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502IdleLoopTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Runs the same program with and without skipping, both must end in
+    // exactly the same state
+    void ExpectSameAsInterpreted(s32 Cycles)
+    {
+        Mem memCopy = mem;
+        CPU cpuCopy = cpu;
+        cpuCopy.SkipIdleLoops = false;
+        u64 SkippedBefore = cpuCopy.IdleCyclesSkipped;
+
+        ExecuteResult Result = cpu.Execute(Cycles, mem);
+        ExecuteResult Expected = cpuCopy.Execute(Cycles, memCopy);
+
+        EXPECT_EQ(Result.Cycles, Expected.Cycles);
+        EXPECT_EQ(Result.Reason, Expected.Reason);
+        EXPECT_EQ(cpu.PC, cpuCopy.PC);
+        EXPECT_EQ(cpu.A, cpuCopy.A);
+        EXPECT_EQ(cpu.X, cpuCopy.X);
+        EXPECT_EQ(cpu.Y, cpuCopy.Y);
+        EXPECT_EQ(cpu.SP, cpuCopy.SP);
+        EXPECT_EQ(cpu.PS, cpuCopy.PS);
+        EXPECT_EQ(cpu.CycleCount, cpuCopy.CycleCount);
+        EXPECT_EQ(cpuCopy.IdleCyclesSkipped, SkippedBefore);
+    }
+};
+
+TEST_F(CPU6502IdleLoopTests, JumpToSelfIsFastForwarded)
+{
+    // Given:
+    mem[0x0200] = CPU::INS_JMP_ABS;
+    mem[0x0201] = 0x00;
+    mem[0x0202] = 0x02;
+    // When:
+    ExpectSameAsInterpreted(100001);
+    // Then:
+    EXPECT_GT(cpu.IdleCyclesSkipped, 99000u);
+}
+
+TEST_F(CPU6502IdleLoopTests, PollingLoopIsFastForwardedExactly)
+{
+    // Given:
+    // wait: LDA $0300 / AND #$80 / BEQ wait
+    mem[0x0200] = CPU::INS_LDA_ABS;
+    mem[0x0201] = 0x00;
+    mem[0x0202] = 0x03;
+    mem[0x0203] = CPU::INS_AND_IM;
+    mem[0x0204] = 0x80;
+    mem[0x0205] = CPU::INS_BEQ;
+    mem[0x0206] = static_cast<Byte>(-7);
+    // When:
+    for (s32 Cycles : {1, 8, 9, 17, 18, 1000, 12345})
+    {
+        ExpectSameAsInterpreted(Cycles);
+    }
+    // Then:
+    EXPECT_GT(cpu.IdleCyclesSkipped, 12000u);
+}
+
+TEST_F(CPU6502IdleLoopTests, LoopsThatChangeStateAreInterpreted)
+{
+    // Given:
+    // count: DEX / BNE count / INC $10 / JMP count
+    mem[0x0200] = CPU::INS_DEX;
+    mem[0x0201] = CPU::INS_BNE;
+    mem[0x0202] = static_cast<Byte>(-3);
+    mem[0x0203] = CPU::INS_INC_ZERO_P;
+    mem[0x0204] = 0x10;
+    mem[0x0205] = CPU::INS_JMP_ABS;
+    mem[0x0206] = 0x00;
+    mem[0x0207] = 0x02;
+    // When:
+    ExpectSameAsInterpreted(50000);
+    // Then:
+    EXPECT_EQ(cpu.IdleCyclesSkipped, 0u);
+    EXPECT_GT(mem[0x10], 0);
+}
+
+TEST_F(CPU6502IdleLoopTests, NotSkippedWhileDebuggerIsAttached)
+{
+    // Given:
+    Debugger debug;
+    cpu.Debug = &debug;
+    mem[0x0200] = CPU::INS_JMP_ABS;
+    mem[0x0201] = 0x00;
+    mem[0x0202] = 0x02;
+    // When:
+    s32 CyclesUsed = cpu.Execute(3000, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 3000);
+    EXPECT_EQ(cpu.IdleCyclesSkipped, 0u);
+    cpu.Debug = nullptr;
+}
+
+TEST_F(CPU6502IdleLoopTests, NotSkippedWhileCountingCoverage)
+{
+    // Given: the polling loop, 9 cycles a trip, 200 trips
+    mem[0x0200] = CPU::INS_LDA_ABS;
+    mem[0x0201] = 0x00;
+    mem[0x0202] = 0x03;
+    mem[0x0203] = CPU::INS_AND_IM;
+    mem[0x0204] = 0x80;
+    mem[0x0205] = CPU::INS_BEQ;
+    mem[0x0206] = static_cast<Byte>(-7);
+    std::vector<Byte> Map(CPU::COVERAGE_SIZE), Expected(CPU::COVERAGE_SIZE);
+    Mem memCopy = mem;
+    CPU cpuCopy = cpu;
+    cpuCopy.SkipIdleLoops = false;
+    cpuCopy.Coverage = Expected.data();
+    cpu.Coverage = Map.data();
+    // When:
+    cpu.Execute(1800, mem);
+    cpuCopy.Execute(1800, memCopy);
+    // Then: every trip counted, as without skipping
+    EXPECT_EQ(cpu.IdleCyclesSkipped, 0u);
+    EXPECT_EQ(Map, Expected);
+    u32 Hits = 0;
+    for (Byte Count : Map)
+        Hits += Count;
+    EXPECT_EQ(Hits, 200u);
+    cpu.Coverage = nullptr;
+}
+
+TEST_F(CPU6502IdleLoopTests, OnlyPureLoopsAreIdle)
+{
+    // Given:
+    mem[0x0200] = CPU::INS_LDA_ZEROP;
+    mem[0x0201] = 0x10;
+    mem[0x0202] = CPU::INS_BNE;
+    mem[0x0203] = static_cast<Byte>(-4);
+    // Then:
+    EXPECT_TRUE(CPU::IsIdleLoop(mem, 0x0200, 0x0202));
+    // an instruction must not straddle the tail
+    EXPECT_FALSE(CPU::IsIdleLoop(mem, 0x0201, 0x0202));
+
+    // Given:
+    mem[0x0200] = CPU::INS_STA_ZEROP;
+    // Then:
+    EXPECT_FALSE(CPU::IsIdleLoop(mem, 0x0200, 0x0202));
+
+    // Given:
+    // branch out of the loop from the middle
+    mem[0x0200] = CPU::INS_BCS;
+    mem[0x0201] = 0x10;
+    // Then:
+    EXPECT_FALSE(CPU::IsIdleLoop(mem, 0x0200, 0x0202));
+}
@@ -44,7 +44,7 @@ void CPU6502IncrementsAndDecrementsTests::MemoryOperationZeroPageMode(Byte Instr
     mem[0x0022] = Value;
     s32 CyclesExpected = 5;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     ChangeValue(Operation, Value);
     EXPECT_EQ(mem[0x0022], Value);
@@ -62,7 +62,7 @@ void CPU6502IncrementsAndDecrementsTests::MemoryOperationZeroPageXMode(Byte Inst
     mem[0x0072] = Value;
     s32 CyclesExpected = 6;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     ChangeValue(Operation, Value);
     EXPECT_EQ(mem[0x0072], Value);
@@ -79,7 +79,7 @@ void CPU6502IncrementsAndDecrementsTests::MemoryOperationAbsoluteMode(Byte Instr
     mem[0x4480] = Value;
     s32 CyclesExpected = 6;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     ChangeValue(Operation, Value);
     EXPECT_EQ(mem[0x4480], Value);
@@ -98,7 +98,7 @@ void CPU6502IncrementsAndDecrementsTests::MemoryOperationAbsoluteXMode(Byte Inst
     mem[0x2092] = Value;
     s32 CyclesExpected = 7;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     ChangeValue(Operation, Value);
     EXPECT_EQ(mem[0x2092], Value);
@@ -113,7 +113,7 @@ void CPU6502IncrementsAndDecrementsTests::RegisterOperation(Byte Instruction, ch
     mem[0xFFFC] = Instruction;
     s32 CyclesExpected = 2;
     // When
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then
     ChangeValue(Operation, Value);
     EXPECT_EQ(cpu.*Register, Value);
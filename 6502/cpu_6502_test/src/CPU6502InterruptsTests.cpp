@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "main_6502.h"
+#include "scheduler_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502InterruptsTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        for (u32 i = 0x0200; i < 0x0300; i++)
+        {
+            mem[i] = CPU::INS_NOP;
+        }
+        // IRQ handler at $8000, NMI handler at $9000, both just RTI
+        mem[0xFFFE] = 0x00;
+        mem[0xFFFF] = 0x80;
+        mem[0xFFFA] = 0x00;
+        mem[0xFFFB] = 0x90;
+        mem[0x8000] = CPU::INS_RTI;
+        mem[0x9000] = CPU::INS_RTI;
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+// Stands in for a device that raises its IRQ when written to
+struct IRQOnWrite : Observer
+{
+    CPU *cpu;
+    Word Register;
+    std::vector<u64> Instructions;
+
+    IRQOnWrite(CPU *Target, Word Address) : cpu(Target), Register(Address) {}
+
+    void OnInstruction(const CPU & /*cpu*/, Word /*PC*/, Byte /*Opcode*/, u64 Cycle) override
+    {
+        Instructions.push_back(Cycle);
+    }
+
+    void OnWrite(Word Address, Byte Value, u64 /*Cycle*/) override
+    {
+        if (Address == Register)
+            cpu->SetIRQ(1, Value != 0);
+    }
+};
+
+TEST_F(CPU6502InterruptsTests, PendingIRQIsTakenWhenExecuteStarts)
+{
+    // Given:
+    cpu.flags.C = 1;
+    cpu.SetIRQ(1, true);
+    // When:
+    s32 CyclesUsed = cpu.Execute(7, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 7);
+    EXPECT_EQ(cpu.PC, 0x8000);
+    EXPECT_TRUE(cpu.flags.I);
+    EXPECT_EQ(cpu.SP, 0xFC);
+    EXPECT_EQ(mem[0x01FF], 0x02);
+    EXPECT_EQ(mem[0x01FE], 0x00);
+    // B clear, unused bit set
+    EXPECT_EQ(mem[0x01FD], 0x21);
+}
+
+TEST_F(CPU6502InterruptsTests, MaskedIRQWaitsForCLI)
+{
+    // Given:
+    cpu.flags.I = 1;
+    cpu.SetIRQ(1, true);
+    mem[0x0201] = CPU::INS_CLI;
+    // When:
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 4);
+    EXPECT_EQ(cpu.PC, 0x0202);
+    // When:
+    CyclesUsed = cpu.Execute(7, mem).Cycles;
+    // Then: one more instruction first, as on an NMOS 6502
+    EXPECT_EQ(CyclesUsed, 2 + 7);
+    EXPECT_EQ(cpu.PC, 0x8000);
+    EXPECT_EQ(mem[0x01FE], 0x03);
+}
+
+TEST_F(CPU6502InterruptsTests, CLIInsideABudgetTakesTheIRQAfterIt)
+{
+    // Given:
+    cpu.flags.I = 1;
+    cpu.SetIRQ(1, true);
+    mem[0x0201] = CPU::INS_CLI;
+    // When:
+    s32 CyclesUsed = cpu.Execute(20, mem).Cycles;
+    // Then:
+    // NOP, CLI, NOP, IRQ, RTI, IRQ again (still asserted, RTI lets it
+    // straight back in)
+    EXPECT_EQ(CyclesUsed, 2 + 2 + 2 + 7 + 6 + 7);
+    EXPECT_EQ(cpu.PC, 0x8000);
+    EXPECT_EQ(cpu.CycleCount, 26u);
+    // When:
+    cpu.SetIRQ(1, false);
+    cpu.Execute(6 + 2, mem);
+    // Then:
+    EXPECT_EQ(cpu.PC, 0x0204);
+    EXPECT_FALSE(cpu.flags.I);
+}
+
+TEST_F(CPU6502InterruptsTests, SEIRightAfterCLIStillLetsTheIRQIn)
+{
+    // Given:
+    cpu.flags.I = 1;
+    cpu.SetIRQ(1, true);
+    mem[0x0200] = CPU::INS_CLI;
+    mem[0x0201] = CPU::INS_SEI;
+    // When:
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
+    // Then: taken after the SEI, the pushed status has I set
+    EXPECT_EQ(CyclesUsed, 2 + 2 + 7);
+    EXPECT_EQ(cpu.PC, 0x8000);
+    EXPECT_EQ(mem[0x01FE], 0x02);
+    EXPECT_EQ(mem[0x01FD], 0x24);
+}
+
+TEST_F(CPU6502InterruptsTests, PLPClearingIWaitsOneInstruction)
+{
+    // Given: P with I clear on the stack
+    cpu.flags.I = 1;
+    cpu.SetIRQ(1, true);
+    cpu.SP = 0xFE;
+    mem[0x01FF] = 0x00;
+    mem[0x0200] = CPU::INS_PLP;
+    // When:
+    s32 CyclesUsed = cpu.Execute(6, mem).Cycles;
+    // Then: PLP, NOP, IRQ
+    EXPECT_EQ(CyclesUsed, 4 + 2 + 7);
+    EXPECT_EQ(cpu.PC, 0x8000);
+    EXPECT_EQ(mem[0x01FE], 0x02);
+    EXPECT_EQ(mem[0x01FF], 0x02);
+}
+
+TEST_F(CPU6502InterruptsTests, OtherThreadsCanRaiseIRQAndNMI)
+{
+    // Given: main loop CLI / JMP *, the IRQ handler counts and stays masked
+    mem[0x0200] = CPU::INS_CLI;
+    mem[0x0201] = CPU::INS_JMP_ABS;
+    mem[0x0202] = 0x01;
+    mem[0x0203] = 0x02;
+    mem[0x8000] = CPU::INS_INC_ZERO_P;
+    mem[0x8001] = 0x11;
+    mem[0x8002] = CPU::INS_JMP_ABS;
+    mem[0x8003] = 0x02;
+    mem[0x8004] = 0x80;
+    mem[0x9000] = CPU::INS_INC_ZERO_P;
+    mem[0x9001] = 0x10;
+    mem[0x9002] = CPU::INS_RTI;
+    cpu.Execute(100, mem);
+    std::atomic<bool> Posted{false};
+    // When:
+    std::thread Host([&] {
+        cpu.PostNMI();
+        cpu.PostIRQ(2, true);
+        Posted = true;
+    });
+    u32 Slices = 0;
+    while (mem[0x11] == 0 && Slices < 10000000)
+    {
+        cpu.Execute(100, mem);
+        Slices++;
+    }
+    Host.join();
+    EXPECT_TRUE(Posted.load());
+    // Then: both taken once, the IRQ line stays up
+    EXPECT_EQ(mem[0x10], 1);
+    EXPECT_EQ(mem[0x11], 1);
+    EXPECT_FALSE(cpu.NMIPending);
+    EXPECT_EQ(cpu.HostIRQLines, 2u);
+    EXPECT_EQ(cpu.IRQLines, 0u);
+    // When:
+    cpu.PostIRQ(2, false);
+    cpu.Execute(100, mem);
+    // Then:
+    EXPECT_EQ(cpu.HostIRQLines, 0u);
+}
+
+TEST_F(CPU6502InterruptsTests, IRQRaisedMidInstructionIsTakenAfterIt)
+{
+    // Given:
+    IRQOnWrite Device(&cpu, 0x4000);
+    cpu.Hooks = &Device;
+    mem[0x0202] = CPU::INS_STA_ABS;
+    mem[0x0203] = 0x00;
+    mem[0x0204] = 0x40;
+    cpu.A = 1;
+    // the handler acknowledges the device
+    mem[0x8000] = CPU::INS_LDA_IM;
+    mem[0x8001] = 0x00;
+    mem[0x8002] = CPU::INS_STA_ABS;
+    mem[0x8003] = 0x00;
+    mem[0x8004] = 0x40;
+    mem[0x8005] = CPU::INS_RTI;
+    // When:
+    s32 CyclesUsed = cpu.Execute(30, mem).Cycles;
+    // Then:
+    // NOP, NOP, STA, IRQ, LDA, STA, RTI, NOP, NOP
+    EXPECT_EQ(CyclesUsed, 31);
+    EXPECT_EQ(cpu.CycleCount, 31u);
+    EXPECT_EQ(cpu.PC, 0x0207);
+    EXPECT_EQ(mem[0x01FE], 0x05);
+    EXPECT_EQ(Device.Instructions, (std::vector<u64>{0, 2, 4, 15, 17, 21, 27, 29}));
+    cpu.Hooks = nullptr;
+}
+
+TEST_F(CPU6502InterruptsTests, NMIFromSchedulerIsTakenEvenWhenMasked)
+{
+    // Given:
+    Scheduler events;
+    cpu.flags.I = 1;
+    // JMP * - the idle loop is skipped up to the event
+    mem[0x0200] = CPU::INS_JMP_ABS;
+    mem[0x0201] = 0x00;
+    mem[0x0202] = 0x02;
+    mem[0x9000] = CPU::INS_JMP_ABS;
+    mem[0x9001] = 0x00;
+    mem[0x9002] = 0x90;
+    events.Schedule(1000, [&](u64) { cpu.TriggerNMI(); });
+    // When:
+    events.RunUntil(cpu, mem, 2000);
+    // Then:
+    EXPECT_EQ(cpu.PC, 0x9000);
+    EXPECT_FALSE(cpu.NMIPending);
+    EXPECT_EQ(mem[0x01FF], 0x02);
+    EXPECT_EQ(mem[0x01FE], 0x00);
+    EXPECT_EQ(mem[0x01FD], 0x24);
+    EXPECT_GT(cpu.IdleCyclesSkipped, 0u);
+}
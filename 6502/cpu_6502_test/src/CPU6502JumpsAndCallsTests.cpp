@@ -44,7 +44,7 @@ TEST_F(CPU6502JumpsAndCallsTests, JumpToSubroutineAndJumpBack)
     s32 CyclesExpected = 6 + 6 + 2;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.A, 0x50);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -62,7 +62,7 @@ TEST_F(CPU6502JumpsAndCallsTests, JSRDoesntAffectProcessorStatus)
     s32 CyclesExpected = 6;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.PS, cpuCopy.PS);
     EXPECT_NE(cpu.SP, cpuCopy.SP);
@@ -80,7 +80,7 @@ TEST_F(CPU6502JumpsAndCallsTests, RTSDoesntAffectProcessorStatus)
     s32 CyclesExpected = 6 + 6;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.PS, cpuCopy.PS);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -98,7 +98,7 @@ TEST_F(CPU6502JumpsAndCallsTests, JumpToLocationAbsolute)
     s32 CyclesExpected = 3 + 2;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.A, 0x50);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -119,7 +119,7 @@ TEST_F(CPU6502JumpsAndCallsTests, JumpToLocationAIndirect)
     s32 CyclesExpected = 5 + 2;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.A, 0x50);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
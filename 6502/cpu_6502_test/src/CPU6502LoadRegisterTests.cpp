@@ -45,7 +45,7 @@ void CPU6502LoadRegisterTests::LoadRegisterImmediateValue(Byte Instruction, Byte
     mem[0xFFFD] = 0x84;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(2, mem);
+    s32 CyclesUsed = cpu.Execute(2, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, 2);
@@ -61,7 +61,7 @@ void CPU6502LoadRegisterTests::LoadRegisterZeroPage(Byte Instruction, Byte CPU::
     mem[0x0022] = 0x84;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(3, mem);
+    s32 CyclesUsed = cpu.Execute(3, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, 3);
@@ -79,7 +79,7 @@ void CPU6502LoadRegisterTests::LoadRegisterZeroPageX(Byte Instruction, Byte CPU:
     mem[0x0072] = 0x84;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(4, mem);
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, 4);
@@ -97,7 +97,7 @@ void CPU6502LoadRegisterTests::LoadRegisterAbsolute(Byte Instruction, Byte CPU::
 
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(4, mem);
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, 4);
@@ -117,7 +117,7 @@ void CPU6502LoadRegisterTests::LoadRegisterAbsoluteX(Byte Instruction, Byte CPU:
 
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(4, mem);
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, 4);
@@ -137,7 +137,7 @@ void CPU6502LoadRegisterTests::LoadRegisterAbsoluteXCrossingPage(Byte Instructio
     CPU cpuCopy = cpu;
     s32 CyclesExpected = 5;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -157,7 +157,7 @@ void CPU6502LoadRegisterTests::LoadRegisterAbsoluteY(Byte Instruction, Byte CPU:
 
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(4, mem);
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, 4);
@@ -177,7 +177,7 @@ void CPU6502LoadRegisterTests::LoadRegisterAbsoluteYCrossingPage(Byte Instructio
     CPU cpuCopy = cpu;
     s32 CyclesExpected = 5;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, 0x84);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -192,7 +192,7 @@ TEST_F(CPU6502LoadRegisterTests, CPUDoesCompleteInstructionWithLessCycles)
     mem[0xFFFD] = 0x84;
     constexpr s32 NUM_OF_CYCLES = 1;
     // When:
-    s32 CyclesUsed = cpu.Execute(NUM_OF_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(NUM_OF_CYCLES, mem).Cycles;
     // Then:
     // INS_LDA_IM requires 2 cycles
     EXPECT_EQ(CyclesUsed, 2);
@@ -247,7 +247,7 @@ TEST_F(CPU6502LoadRegisterTests, LDAZeroPageXLoadValueWhenWraps)
     mem[0x007F] = 0x84;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(4, mem);
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.A, 0x84);
     EXPECT_EQ(CyclesUsed, 4);
@@ -265,7 +265,7 @@ TEST_F(CPU6502LoadRegisterTests, LDXZeroPageYLoadValue)
     mem[0x0072] = 0x84;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(4, mem);
+    s32 CyclesUsed = cpu.Execute(4, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.X, 0x84);
     EXPECT_EQ(CyclesUsed, 4);
@@ -347,7 +347,7 @@ TEST_F(CPU6502LoadRegisterTests, LDAIndirectXLoadAValue)
     CPU CPUCopy = cpu;
 
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
 
     //then:
     EXPECT_EQ(cpu.A, 0x37);
@@ -370,7 +370,7 @@ TEST_F(CPU6502LoadRegisterTests, LDAIndirectYLoadAValue)
     CPU CPUCopy = cpu;
 
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
 
     //then:
     EXPECT_EQ(cpu.A, 0x37);
@@ -393,7 +393,7 @@ TEST_F(CPU6502LoadRegisterTests, LDAIndirectYLoadAValueCrossingPage)
     CPU CPUCopy = cpu;
 
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
 
     //then:
     EXPECT_EQ(cpu.A, 0x37);
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "main_6502.h"
+#include "loader_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502LoaderTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+    }
+
+    virtual void TearDown()
+    {
+        for (const std::string &Path : Files)
+            remove(Path.c_str());
+    }
+
+    std::vector<std::string> Files;
+
+    std::string WriteFile(const char *Name, const std::vector<Byte> &Contents)
+    {
+        std::string Path = testing::TempDir() + Name;
+        FILE *File = fopen(Path.c_str(), "wb");
+        EXPECT_NE(File, nullptr);
+        fwrite(Contents.data(), 1, Contents.size(), File);
+        fclose(File);
+        Files.push_back(Path);
+        return Path;
+    }
+
+    // One Intel HEX record line with its checksum
+    static std::string Record(Word Address, Byte Type, const std::vector<Byte> &Bytes)
+    {
+        char Text[16];
+        Byte Sum = static_cast<Byte>(Bytes.size() + (Address >> 8) + (Address & 0xFF) + Type);
+        snprintf(Text, sizeof(Text), ":%02X%04X%02X", unsigned(Bytes.size()), Address, Type);
+        std::string Line = Text;
+        for (Byte Value : Bytes)
+        {
+            snprintf(Text, sizeof(Text), "%02X", Value);
+            Line += Text;
+            Sum += Value;
+        }
+        snprintf(Text, sizeof(Text), "%02X\r\n", Byte(-Sum));
+        return Line + Text;
+    }
+};
+
+TEST_F(CPU6502LoaderTests, PrgLoadsAtItsAddressAndRuns)
+{
+    // Given: LDA #$42 / STA $10 at $0400
+    std::string Path = WriteFile("loader.prg", {0x00, 0x04, CPU::INS_LDA_IM, 0x42, 0x85, 0x10});
+    ProgramImage Image;
+    // When:
+    ASSERT_TRUE(Image.Open(Path.c_str()));
+    Image.Load(cpu, mem);
+    cpu.Execute(5, mem);
+    // Then:
+    ASSERT_EQ(Image.Segments.size(), 1u);
+    EXPECT_EQ(Image.Segments[0].Address, 0x0400);
+    EXPECT_EQ(Image.Segments[0].Size, 4u);
+    EXPECT_TRUE(Image.HasStart);
+    EXPECT_EQ(Image.Start, 0x0400);
+    EXPECT_EQ(mem[0x0010], 0x42);
+}
+
+TEST_F(CPU6502LoaderTests, IntelHexMergesContiguousRecords)
+{
+    // Given:
+    std::string Text = Record(0x1000, 0x00, {1, 2, 3, 4}) + Record(0x1004, 0x00, {5, 6}) +
+                       Record(0x2000, 0x00, {7}) + Record(0x0000, 0x05, {0, 0, 0x10, 0x00}) +
+                       Record(0x0000, 0x01, {}) + Record(0x3000, 0x00, {9});
+    std::string Path = WriteFile("loader.hex", std::vector<Byte>(Text.begin(), Text.end()));
+    ProgramImage Image;
+    // When:
+    std::string Error;
+    ASSERT_TRUE(Image.Open(Path.c_str(), ImageFormat::Detect, 0, &Error)) << Error;
+    Image.CopyTo(mem);
+    // Then: nothing after the EOF record
+    ASSERT_EQ(Image.Segments.size(), 2u);
+    EXPECT_EQ(Image.Segments[0].Address, 0x1000);
+    EXPECT_EQ(Image.Segments[0].Size, 6u);
+    EXPECT_EQ(Image.Segments[1].Address, 0x2000);
+    EXPECT_EQ(Image.Start, 0x1000);
+    EXPECT_EQ(mem[0x1005], 6);
+    EXPECT_EQ(mem[0x2000], 7);
+    EXPECT_EQ(mem[0x3000], 0);
+}
+
+TEST_F(CPU6502LoaderTests, IntelHexErrorsAreReported)
+{
+    // Given: the last digit of the checksum changed
+    std::string Text = Record(0x1000, 0x00, {1, 2});
+    Text[Text.size() - 3] ^= 1;
+    ProgramImage Image;
+    std::string Error;
+    // When:
+    bool Ok = Image.Parse(reinterpret_cast<const Byte *>(Text.data()), Text.size(), ImageFormat::IntelHex, 0, &Error);
+    // Then:
+    EXPECT_FALSE(Ok);
+    EXPECT_EQ(Error, "checksum mismatch on line 1");
+    EXPECT_TRUE(Image.Segments.empty());
+
+    // When: data past $FFFF
+    Text = Record(0xFFFF, 0x00, {1, 2});
+    Ok = Image.Parse(reinterpret_cast<const Byte *>(Text.data()), Text.size(), ImageFormat::IntelHex, 0, &Error);
+    // Then:
+    EXPECT_FALSE(Ok);
+    EXPECT_EQ(Error, "segment runs past $FFFF");
+}
+
+TEST_F(CPU6502LoaderTests, O65TextDataAndBss)
+{
+    // Given: text $0600 (3 bytes), data $0700 (2 bytes), bss $0800 (4 bytes), one header option
+    std::vector<Byte> Object = {0x01, 0x00, 'o', '6', '5', 0x00, 0x00, 0x00,
+                                0x00, 0x06, 0x03, 0x00,  // tbase tlen
+                                0x00, 0x07, 0x02, 0x00,  // dbase dlen
+                                0x00, 0x08, 0x04, 0x00,  // bbase blen
+                                0x00, 0x00, 0x00, 0x00,  // zbase zlen
+                                0x00, 0x00,              // stack
+                                0x04, 0x00, 'x', 0x00,   // filename option
+                                0x00,                    // end of options
+                                0xEA, 0xEA, 0x02,        // text
+                                0x11, 0x22,              // data
+                                0x00, 0x00, 0x00, 0x00}; // no relocations or exports
+    std::string Path = WriteFile("loader.bin", Object);
+    for (u32 i = 0; i < 4; i++)
+        mem[0x0800 + i] = 0x55;
+    ProgramImage Image;
+    // When:
+    std::string Error;
+    ASSERT_TRUE(Image.Open(Path.c_str(), ImageFormat::Detect, 0, &Error)) << Error;
+    Image.CopyTo(mem);
+    // Then:
+    ASSERT_EQ(Image.Segments.size(), 3u);
+    EXPECT_EQ(Image.Start, 0x0600);
+    EXPECT_EQ(mem[0x0602], 0x02);
+    EXPECT_EQ(mem[0x0701], 0x22);
+    EXPECT_EQ(mem[0x0803], 0x00);
+}
+
+TEST_F(CPU6502LoaderTests, RawImageServedAsROM)
+{
+    // Given: a table the guest reads through a device, never copied into RAM
+    std::string Path = WriteFile("loader.rom", {0x10, 0x20, 0x30});
+    ProgramImage Image;
+    ASSERT_TRUE(Image.Open(Path.c_str(), ImageFormat::Detect, 0x8000));
+    RomDevice Rom(Image.Segments[0]);
+    Rom.MapInto(mem);
+    mem[0x0200] = CPU::INS_LDA_ABS;
+    mem[0x0201] = 0x02;
+    mem[0x0202] = 0x80;
+    mem[0x0203] = CPU::INS_STA_ABS;
+    mem[0x0204] = 0x01;
+    mem[0x0205] = 0x80;
+    // When:
+    cpu.Execute(8, mem);
+    // Then:
+    EXPECT_EQ(cpu.A, 0x30);
+    EXPECT_EQ(mem[0x8002], 0x00);
+    EXPECT_EQ(Rom.Read(0x8001, 0), 0x20);
+    EXPECT_EQ(Rom.Read(0x8003, 0), 0xFF);
+}
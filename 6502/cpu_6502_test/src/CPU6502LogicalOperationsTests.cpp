@@ -69,7 +69,7 @@ void CPU6502LogicalOperationsTests::LogicOpImmediateMode(Byte Instruction, char
     s32 CyclesExpected = 2;
     // CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     Byte Result = GetLogicOpValue(Operator);
     EXPECT_EQ(cpu.A, Result);
@@ -87,7 +87,7 @@ void CPU6502LogicalOperationsTests::LogicOpZeroPageMode(Byte Instruction, char O
     CPU cpuCopy = cpu;
     constexpr s32 CyclesExpected = 3;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     Byte Result = GetLogicOpValue(Operator);
     EXPECT_EQ(cpu.A, Result);
@@ -107,7 +107,7 @@ void CPU6502LogicalOperationsTests::LogicOpZeroPageXMode(Byte Instruction, char
     CPU cpuCopy = cpu;
     constexpr s32 CyclesExpected = 4;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     Byte Result = GetLogicOpValue(Operator);
     EXPECT_EQ(cpu.A, Result);
@@ -126,7 +126,7 @@ void CPU6502LogicalOperationsTests::LogicOpAbsoluteMode(Byte Instruction, char O
     constexpr s32 CyclesExpected = 4;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     Byte Result = GetLogicOpValue(Operator);
     EXPECT_EQ(cpu.A, Result);
@@ -147,7 +147,7 @@ void CPU6502LogicalOperationsTests::LogicOpAbsoluteOffsetMode(Byte Instruction,
     constexpr s32 CyclesExpected = 4;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     Byte Result = GetLogicOpValue(Operator);
     EXPECT_EQ(cpu.A, Result);
@@ -167,7 +167,7 @@ void CPU6502LogicalOperationsTests::LogicOpIndirectXMode(Byte Instruction, char
     mem[0x8000] = B;
     constexpr s32 EXPECTED_CYCLES = 6;
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
     //then:
     Byte Result = GetLogicOpValue(Operator);
     EXPECT_EQ(cpu.A, Result);
@@ -188,7 +188,7 @@ void CPU6502LogicalOperationsTests::LogicOpIndirectYMode(Byte Instruction, char
     constexpr s32 EXPECTED_CYCLES = 5;
     CPU cpuCopy = cpu;
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
     //then:
     Byte Result = GetLogicOpValue(Operator);
     EXPECT_EQ(cpu.A, Result);
@@ -329,7 +329,7 @@ TEST_F(CPU6502LogicalOperationsTests, BITZeroPageMode)
     CPU cpuCopy = cpu;
     constexpr s32 CyclesExpected = 3;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.flags.Z, false);
     EXPECT_EQ(cpu.flags.V, true);
@@ -353,7 +353,7 @@ TEST_F(CPU6502LogicalOperationsTests, BITAbsoluteMode)
     constexpr s32 CyclesExpected = 4;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.flags.Z, true);
     EXPECT_EQ(cpu.flags.V, false);
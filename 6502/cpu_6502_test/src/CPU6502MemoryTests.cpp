@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "main_6502.h"
+
+using namespace cpu6502;
+
+namespace
+{
+    // Page that logs block writes and reads back the low address byte
+    struct Recorder : Device
+    {
+        std::vector<std::pair<Word, u32>> Blocks;
+
+        Byte Read(Word Address, u64 /*Cycle*/) override { return Address & 0xFF; }
+        void Write(Word /*Address*/, Byte /*Value*/, u64 /*Cycle*/) override {}
+        void WriteBlock(Word Address, const Byte * /*Data*/, u32 Count, u64 /*Cycle*/) override
+        {
+            Blocks.push_back({Address, Count});
+        }
+    };
+}
+
+class CPU6502MemoryTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502MemoryTests, BlocksWrapAroundAtTheTop)
+{
+    // Given:
+    const Byte Data[] = {1, 2, 3, 4};
+    // When:
+    mem.WriteBlock(0xFFFE, Data, 4);
+    Byte Back[4] = {};
+    mem.ReadBlock(0xFFFE, Back, 4);
+    // Then:
+    EXPECT_EQ(mem[0xFFFE], 1);
+    EXPECT_EQ(mem[0xFFFF], 2);
+    EXPECT_EQ(mem[0x0000], 3);
+    EXPECT_EQ(mem[0x0001], 4);
+    EXPECT_EQ(mem.Compare(0xFFFE, Back, 4), 4u);
+}
+
+TEST_F(CPU6502MemoryTests, FillAndCompare)
+{
+    // Given:
+    std::vector<Byte> Expected(Mem::MAX_MEM, 0xAB);
+    mem.Fill(0x8000, 0xAB, Mem::MAX_MEM);
+    // Then: the whole space, starting anywhere
+    EXPECT_EQ(mem.Compare(0x8000, Expected.data(), Mem::MAX_MEM), Mem::MAX_MEM);
+    // When:
+    mem[0x8000 + 1000] = 0x00;
+    mem[0x0010] = 0x00;
+    // Then: first difference after the wrap is found as well
+    EXPECT_EQ(mem.Compare(0x8000, Expected.data(), Mem::MAX_MEM), 1000u);
+    EXPECT_EQ(mem.Compare(0x8400, Expected.data(), 0x8000 + 0x20), 0x8000u - 0x400u + 0x10u);
+}
+
+TEST_F(CPU6502MemoryTests, BusViewGoesThroughDevices)
+{
+    // Given:
+    Recorder IO;
+    mem.Map(&IO, 0x1200, 0x13FF);
+    std::vector<Byte> Data(0x300, 0x77);
+    // When: $11F0-$14EF, RAM / device for two pages / RAM
+    mem.WriteBlock(0x11F0, Data.data(), 0x300, MemView::Bus);
+    // Then:
+    ASSERT_EQ(IO.Blocks.size(), 2u);
+    EXPECT_EQ(IO.Blocks[0], std::make_pair(Word(0x1200), 256u));
+    EXPECT_EQ(IO.Blocks[1], std::make_pair(Word(0x1300), 256u));
+    EXPECT_EQ(mem[0x11FF], 0x77);
+    EXPECT_EQ(mem[0x1200], 0x00);
+    EXPECT_EQ(mem[0x1400], 0x77);
+    EXPECT_EQ(mem[0x14EF], 0x77);
+
+    // When:
+    Byte Back[4] = {};
+    mem.ReadBlock(0x11FE, Back, 4, MemView::Bus);
+    // Then:
+    EXPECT_EQ(Back[1], 0x77);
+    EXPECT_EQ(Back[2], 0x00);
+    EXPECT_EQ(Back[3], 0x01);
+    // When: the RAM view ignores the mapping
+    mem.ReadBlock(0x11FE, Back, 4);
+    // Then:
+    EXPECT_EQ(Back[3], 0x00);
+}
+
+TEST_F(CPU6502MemoryTests, WritesStampTheirPage)
+{
+    // Given:
+    Recorder IO;
+    mem.Map(&IO, 0xD000, 0xD0FF);
+    const u32 Since = mem.Checkpoint();
+    mem[0x0200] = CPU::INS_STA_ABS;
+    mem[0x0201] = 0x05;
+    mem[0x0202] = 0x03;
+    mem[0x0203] = CPU::INS_STA_ABS;
+    mem[0x0204] = 0x00;
+    mem[0x0205] = 0xD0;
+    mem[0x0206] = CPU::INS_PHA;
+    // When:
+    cpu.Execute(11, mem);
+    mem.Fill(0x40F0, 0xFF, 0x20);
+    // Then:
+    for (u32 Page = 0; Page < Mem::NUM_PAGES; Page++)
+    {
+        bool Expected = Page == 0x01 || Page == 0x03 || Page == 0x40 || Page == 0x41;
+        EXPECT_EQ(mem.WrittenSince(Page, Since), Expected) << Page;
+    }
+    // When: a later checkpoint
+    const u32 Later = mem.Checkpoint();
+    // Then:
+    EXPECT_FALSE(mem.WrittenSince(0x03, Later));
+    EXPECT_TRUE(mem.WrittenSince(0x03, Since));
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "main_6502.h"
+#include "profiler_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502ProfilerTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0xFF00);
+        // 0xFF00: JSR $2000 / LDA #$01
+        mem[0xFF00] = CPU::INS_JSR;
+        mem[0xFF01] = 0x00;
+        mem[0xFF02] = 0x20;
+        mem[0xFF03] = CPU::INS_LDA_IM;
+        mem[0xFF04] = 0x01;
+        // 0x2000: JSR $3000 / RTS
+        mem[0x2000] = CPU::INS_JSR;
+        mem[0x2001] = 0x00;
+        mem[0x2002] = 0x30;
+        mem[0x2003] = CPU::INS_RTS;
+        // 0x3000: LDA #$05 / RTS
+        mem[0x3000] = CPU::INS_LDA_IM;
+        mem[0x3001] = 0x05;
+        mem[0x3002] = CPU::INS_RTS;
+    }
+
+    virtual void TearDown()
+    {
+        cpu.Hooks = nullptr;
+    }
+
+    static std::string ReadFile(const char *Path)
+    {
+        std::ifstream File(Path);
+        std::stringstream Contents;
+        Contents << File.rdbuf();
+        return Contents.str();
+    }
+};
+
+TEST_F(CPU6502ProfilerTests, RebuildsCallStacksFromJSRAndRTS)
+{
+    // Given:
+    Profiler profiler(1);
+    cpu.Hooks = &profiler;
+    // When:
+    s32 CyclesUsed = cpu.Execute(6 + 6 + 2 + 6 + 6 + 2, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 28);
+    EXPECT_EQ(profiler.SampleCount, 6u);
+    EXPECT_EQ(profiler.StackSamples[(std::vector<Word>{})], 2u);
+    EXPECT_EQ(profiler.StackSamples[(std::vector<Word>{0x2000})], 2u);
+    EXPECT_EQ(profiler.StackSamples[(std::vector<Word>{0x2000, 0x3000})], 2u);
+    EXPECT_TRUE(profiler.CallStack.empty());
+}
+
+TEST_F(CPU6502ProfilerTests, SamplesEveryPeriodCycles)
+{
+    // Given:
+    Profiler profiler(6);
+    cpu.Hooks = &profiler;
+    // When:
+    cpu.Execute(28, mem);
+    // Then:
+    // instructions start at cycles 0, 6, 12, 14, 20, 26
+    EXPECT_EQ(profiler.SampleCount, 5u);
+    EXPECT_EQ(profiler.FlatSamples[0xFF00], 1u);
+    EXPECT_EQ(profiler.FlatSamples[0x2000], 1u);
+    EXPECT_EQ(profiler.FlatSamples[0x3000], 1u);
+    EXPECT_EQ(profiler.FlatSamples[0x3002], 0u);
+    EXPECT_EQ(profiler.FlatSamples[0xFF03], 1u);
+}
+
+TEST_F(CPU6502ProfilerTests, WritesFoldedStacksWithSymbols)
+{
+    // Given:
+    Profiler profiler(1);
+    cpu.Hooks = &profiler;
+    SymbolTable Symbols;
+    Symbols.Add(0x2000, "outer");
+    Symbols.Add(0x3000, "inner");
+    const char *Path = "CPU6502ProfilerTests.folded";
+    // When:
+    cpu.Execute(28, mem);
+    ASSERT_TRUE(profiler.WriteFolded(Path, &Symbols));
+    std::string Folded = ReadFile(Path);
+    std::remove(Path);
+    // Then:
+    EXPECT_EQ(Folded, "root 2\nroot;outer 2\nroot;outer;inner 2\n");
+}
+
+TEST_F(CPU6502ProfilerTests, WritesFlatHistogramHottestFirst)
+{
+    // Given:
+    Profiler profiler(1);
+    cpu.Hooks = &profiler;
+    mem[0x3000] = CPU::INS_JMP_ABS; // spin in place at 0x3000
+    mem[0x3001] = 0x00;
+    mem[0x3002] = 0x30;
+    SymbolTable Symbols;
+    Symbols.Add(0x2000, "outer");
+    Symbols.Add(0xFF00, "reset");
+    const char *Path = "CPU6502ProfilerTests.flat";
+    // When:
+    cpu.Execute(6 + 6 + 3 * 10, mem);
+    ASSERT_TRUE(profiler.WriteFlat(Path, &Symbols));
+    std::string Flat = ReadFile(Path);
+    std::remove(Path);
+    // Then:
+    EXPECT_EQ(Flat, "$3000 10 outer+$1000\n$2000 1 outer\n$FF00 1 reset\n");
+}
+
+TEST(CPU6502SymbolTableTests, LoadsCommonLabelFormats)
+{
+    // Given:
+    const char *Path = "CPU6502SymbolTableTests.lbl";
+    FILE *File = fopen(Path, "w");
+    ASSERT_NE(File, nullptr);
+    fputs("; comment\nal C:c000 .main\n$C100 loop\nirq = $C200\n", File);
+    fclose(File);
+    SymbolTable Symbols;
+    // When:
+    ASSERT_TRUE(Symbols.Load(Path));
+    std::remove(Path);
+    // Then:
+    EXPECT_EQ(Symbols.NameOf(0xC000), "main");
+    EXPECT_EQ(Symbols.NameOf(0xC100), "loop");
+    EXPECT_EQ(Symbols.NameOf(0xC200), "irq");
+    EXPECT_EQ(Symbols.Describe(0xC105), "loop+$5");
+    EXPECT_EQ(Symbols.NameOf(0x1234), "$1234");
+}
@@ -41,7 +41,7 @@ void CPU6502RegisterTransferTests::TransferAccumulatorToRegister(Byte Instructio
     constexpr s32 EXPECTED_CYCLES = 2;
     CPU CPUCopy = cpu;
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
     //then:
     EXPECT_EQ(cpu.A, 0x20);
     EXPECT_EQ(cpu.*Register, 0x20);
@@ -57,7 +57,7 @@ void CPU6502RegisterTransferTests::TransferRegisterToAccumulator(Byte Instructio
     constexpr s32 EXPECTED_CYCLES = 2;
     CPU CPUCopy = cpu;
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
     //then:
     EXPECT_EQ(cpu.A, 0x40);
     EXPECT_EQ(cpu.*Register, 0x40);
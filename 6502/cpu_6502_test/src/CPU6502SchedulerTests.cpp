@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "main_6502.h"
+#include "scheduler_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502SchedulerTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::Scheduler events;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        // loop: INC $10 / JMP loop - 8 cycles a trip
+        mem[0x0200] = CPU::INS_INC_ZERO_P;
+        mem[0x0201] = 0x10;
+        mem[0x0202] = CPU::INS_JMP_ABS;
+        mem[0x0203] = 0x00;
+        mem[0x0204] = 0x02;
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502SchedulerTests, EventsFireInCycleOrderAtInstructionBoundaries)
+{
+    // Given:
+    std::vector<u64> Fired;
+    std::vector<u64> FiredAt;
+    for (u64 Cycle : {300, 100, 100, 201})
+    {
+        events.Schedule(Cycle, [&, Cycle](u64 Due) {
+            EXPECT_EQ(Due, Cycle);
+            Fired.push_back(Due);
+            FiredAt.push_back(cpu.CycleCount);
+        });
+    }
+    // When:
+    ExecuteResult Result = events.RunUntil(cpu, mem, 1000);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::BudgetExhausted);
+    EXPECT_EQ(Result.Cycles, 1000);
+    EXPECT_EQ(cpu.CycleCount, 1000u);
+    EXPECT_EQ(Fired, (std::vector<u64>{100, 100, 201, 300}));
+    // a trip is INC (5) + JMP (3), events wait for the instruction in flight
+    EXPECT_EQ(FiredAt, (std::vector<u64>{101, 101, 205, 301}));
+    EXPECT_TRUE(events.Empty());
+}
+
+TEST_F(CPU6502SchedulerTests, EventsCanRescheduleThemselves)
+{
+    // Given:
+    int Ticks = 0;
+    std::function<void(u64)> Tick = [&](u64 Due) {
+        Ticks++;
+        events.Schedule(Due + 64, Tick);
+    };
+    events.Schedule(64, Tick);
+    // When:
+    events.RunUntil(cpu, mem, 64 * 10);
+    // Then:
+    EXPECT_EQ(Ticks, 10);
+    EXPECT_EQ(events.NextEventCycle(), 64u * 11);
+}
+
+TEST_F(CPU6502SchedulerTests, CancelledEventsNeverFire)
+{
+    // Given:
+    bool Fired = false;
+    Scheduler::EventId Id = events.Schedule(50, [&](u64) { Fired = true; });
+    // When:
+    EXPECT_TRUE(events.Cancel(Id));
+    EXPECT_FALSE(events.Cancel(Id));
+    events.RunUntil(cpu, mem, 200);
+    // Then:
+    EXPECT_FALSE(Fired);
+    EXPECT_EQ(events.NextEventCycle(), Scheduler::NEVER);
+}
+
+TEST_F(CPU6502SchedulerTests, RunUntilStopsEarlyOnTraps)
+{
+    // Given:
+    mem[0x0202] = CPU::INS_HOST_CALL;
+    mem[0x0203] = 0x01;
+    bool Fired = false;
+    events.Schedule(500, [&](u64) { Fired = true; });
+    // When:
+    ExecuteResult Result = events.RunUntil(cpu, mem, 1000);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::HostCall);
+    EXPECT_EQ(Result.Cycles, 7);
+    EXPECT_EQ(cpu.CycleCount, 7u);
+    EXPECT_FALSE(Fired);
+}
+
+TEST_F(CPU6502SchedulerTests, IdleLoopsSkipToTheNextEvent)
+{
+    // Given:
+    // wait: LDA $10 / BEQ wait / JAM
+    mem[0x0200] = CPU::INS_LDA_ZEROP;
+    mem[0x0201] = 0x10;
+    mem[0x0202] = CPU::INS_BEQ;
+    mem[0x0203] = static_cast<Byte>(-4);
+    mem[0x0204] = 0x02;
+    u64 FiredAt = 0;
+    events.Schedule(100000, [&](u64) {
+        FiredAt = cpu.CycleCount;
+        mem[0x10] = 1;
+    });
+    // When:
+    ExecuteResult Result = events.RunUntil(cpu, mem, 200000);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::Halted);
+    // a trip is LDA (3) + BEQ (3)
+    EXPECT_EQ(FiredAt, 100002u);
+    // LDA, BEQ not taken and fetching the JAM
+    EXPECT_EQ(cpu.CycleCount, 100002u + 3 + 2 + 1);
+    EXPECT_GT(cpu.IdleCyclesSkipped, 99000u);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "main_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502ShiftsTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem);
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502ShiftsTests, ASLAccumulatorShiftsBit7IntoCarry)
+{
+    // Given:
+    cpu.A = 0x81;
+    mem[0xFFFC] = CPU::INS_ASL;
+    s32 CyclesExpected = 2;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(cpu.A, 0x02);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.N);
+}
+
+TEST_F(CPU6502ShiftsTests, LSRZeroPageShiftsBit0IntoCarry)
+{
+    // Given:
+    mem[0xFFFC] = CPU::INS_LSR_ZERO_P;
+    mem[0xFFFD] = 0x42;
+    mem[0x0042] = 0x01;
+    s32 CyclesExpected = 5;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(mem[0x0042], 0x00);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_TRUE(cpu.flags.Z);
+}
+
+TEST_F(CPU6502ShiftsTests, ROLZeroPageXRotatesCarryIn)
+{
+    // Given:
+    cpu.flags.C = 1;
+    cpu.X = 0x10;
+    mem[0xFFFC] = CPU::INS_ROL_ZERO_PX;
+    mem[0xFFFD] = 0x42;
+    mem[0x0052] = 0x40;
+    s32 CyclesExpected = 6;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(mem[0x0052], 0x81);
+    EXPECT_FALSE(cpu.flags.C);
+    EXPECT_TRUE(cpu.flags.N);
+}
+
+TEST_F(CPU6502ShiftsTests, RORAbsoluteRotatesCarryIntoBit7)
+{
+    // Given:
+    cpu.flags.C = 1;
+    mem[0xFFFC] = CPU::INS_ROR_ABS;
+    mem[0xFFFD] = 0x80;
+    mem[0xFFFE] = 0x44;
+    mem[0x4480] = 0x03;
+    s32 CyclesExpected = 6;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(mem[0x4480], 0x81);
+    EXPECT_TRUE(cpu.flags.C);
+}
+
+TEST_F(CPU6502ShiftsTests, AbsoluteXShiftsAlwaysTakeSevenCycles)
+{
+    // Given:
+    cpu.X = 0x01;
+    mem[0xFFFC] = CPU::INS_ASL_ABS_X;
+    mem[0xFFFD] = 0x80;
+    mem[0xFFFE] = 0x44;
+    mem[0x4481] = 0x21;
+    s32 CyclesExpected = 7;
+    // When:
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, CyclesExpected);
+    EXPECT_EQ(mem[0x4481], 0x42);
+    EXPECT_FALSE(cpu.flags.C);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "main_6502.h"
+#include "sound_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502SoundTests : public testing::Test
+{
+public:
+    static constexpr u32 BATCH = 20000;
+
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::Scheduler events;
+    cpu6502::SoundChip chip{events, 0xD400, BATCH};
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        mem.Map(&chip, 0xD400, 0xD40F);
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void LoadSweep()
+    {
+        static const Byte Sweep[] = {
+            0xA2, 0x00,       //       LDX #0
+            0xE8,             // loop: INX
+            0x8E, 0x00, 0xD4, //       STX PERIOD_LO
+            0xA9, 0x0F,       //       LDA #15
+            0x8D, 0x02, 0xD4, //       STA VOLUME
+            0xA0, 0x40,       //       LDY #$40
+            0x88,             // wait: DEY
+            0xD0, 0xFD,       //       BNE wait
+            0x4C, 0x02, 0x02, //       JMP loop
+        };
+        for (u32 i = 0; i < sizeof(Sweep); i++)
+            mem[0x0200 + i] = Sweep[i];
+    }
+};
+
+TEST_F(CPU6502SoundTests, SquareWaveFromRegisterWrites)
+{
+    // Given: one cycle per sample, the wave flips every 8 cycles
+    SoundRenderer Renderer{44100, 44100};
+    chip.Write(0xD400 + SoundChip::PERIOD_LO, 1, 0);
+    chip.Write(0xD400 + SoundChip::VOLUME, 15, 0);
+    chip.Sync(32);
+    std::vector<s16> Samples;
+    // When:
+    u32 Count = Renderer.Render(chip, Samples);
+    // Then:
+    ASSERT_EQ(Count, 32u);
+    for (u32 i = 0; i < 32; i++)
+        EXPECT_EQ(Samples[i], (i / 8) % 2 == 0 ? 15 * 512 : -15 * 512) << i;
+    EXPECT_EQ(chip.Read(0xD400 + SoundChip::VOLUME, 0), 15);
+}
+
+TEST_F(CPU6502SoundTests, WriteTakesEffectOnItsCycle)
+{
+    // Given:
+    SoundRenderer Renderer{44100, 44100};
+    chip.Write(0xD404 + SoundChip::PERIOD_LO, 1, 0);
+    chip.Write(0xD404 + SoundChip::VOLUME, 15, 0);
+    chip.Write(0xD404 + SoundChip::VOLUME, 5, 20);
+    chip.Sync(24);
+    std::vector<s16> Samples;
+    // When:
+    Renderer.Render(chip, Samples);
+    // Then:
+    ASSERT_EQ(Samples.size(), 24u);
+    EXPECT_EQ(Samples[19], 15 * 512);
+    EXPECT_EQ(Samples[20], 5 * 512);
+}
+
+TEST_F(CPU6502SoundTests, GuestRunRendersTheSameOnAnotherThread)
+{
+    // Given: a reference rendered after every batch on this thread
+    LoadSweep();
+    CPU Start = cpu;
+    std::vector<s16> Reference;
+    {
+        SoundRenderer Renderer{1000000, 44100};
+        events.RunUntil(cpu, mem, 10 * BATCH + 1);
+        Renderer.Render(chip, Reference);
+    }
+    Scheduler OtherEvents;
+    SoundChip OtherChip{OtherEvents, 0xD400, BATCH};
+    mem.Map(&OtherChip, 0xD400, 0xD40F);
+    cpu = Start;
+    // When: rendering while the guest runs
+    std::vector<s16> Samples;
+    std::atomic<bool> Done{false};
+    std::thread Render([&] {
+        SoundRenderer Renderer{1000000, 44100};
+        while (!Done.load())
+        {
+            if (!Renderer.Render(OtherChip, Samples))
+                std::this_thread::yield();
+        }
+        Renderer.Render(OtherChip, Samples);
+    });
+    for (u32 Batch = 1; Batch <= 10; Batch++)
+        OtherEvents.RunUntil(cpu, mem, Batch * BATCH + 1);
+    Done = true;
+    Render.join();
+    // Then:
+    EXPECT_EQ(chip.RendererWaits, 0u);
+    EXPECT_EQ(OtherChip.RendererWaits, 0u);
+    EXPECT_EQ(Reference.size(), u64(10) * BATCH * 44100 / 1000000);
+    EXPECT_EQ(Samples, Reference);
+}
+
+TEST_F(CPU6502SoundTests, FullLogWaitsForTheRenderer)
+{
+    // Given: a host that renders when the chip asks
+    SoundRenderer Renderer{44100, 44100};
+    std::vector<s16> Samples;
+    u32 Waits = 0;
+    chip.WaitForRenderer = [&] {
+        Waits++;
+        Renderer.Render(chip, Samples);
+    };
+    for (u32 i = 0; i < SoundChip::LOG_SIZE; i++)
+        chip.Write(0xD400 + SoundChip::VOLUME, 1, i);
+    // When:
+    chip.Write(0xD400 + SoundChip::VOLUME, 2, SoundChip::LOG_SIZE);
+    chip.Sync(SoundChip::LOG_SIZE + 2);
+    Renderer.Render(chip, Samples);
+    // Then: nothing lost, nothing out of order
+    EXPECT_EQ(Waits, 1u);
+    EXPECT_EQ(chip.Read(0xD400 + SoundChip::VOLUME, 0), 2);
+    EXPECT_EQ(Samples.size(), SoundChip::LOG_SIZE + 2u);
+}
+
+TEST_F(CPU6502SoundTests, SlowRendererGetsTheSameSamples)
+{
+    // Given: a guest writing every few cycles, fast enough to fill the
+    // log several times over within the run
+    static const Byte Noise[] = {
+        0xE8,             // loop: INX
+        0x8E, 0x00, 0xD4, //       STX PERIOD_LO
+        0x8E, 0x02, 0xD4, //       STX VOLUME
+        0x4C, 0x00, 0x02, //       JMP loop
+    };
+    for (u32 i = 0; i < sizeof(Noise); i++)
+        mem[0x0200 + i] = Noise[i];
+    CPU Start = cpu;
+    std::vector<s16> Reference;
+    {
+        SoundRenderer Renderer{1000000, 44100};
+        for (u32 Batch = 1; Batch <= 20; Batch++)
+        {
+            events.RunUntil(cpu, mem, Batch * BATCH + 1);
+            Renderer.Render(chip, Reference);
+        }
+    }
+    Scheduler OtherEvents;
+    SoundChip OtherChip{OtherEvents, 0xD400, BATCH};
+    mem.Map(&OtherChip, 0xD400, 0xD40F);
+    cpu = Start;
+    // When: nothing is rendered until the chip has to wait
+    std::vector<s16> Samples;
+    SoundRenderer Renderer{1000000, 44100};
+    OtherChip.WaitForRenderer = [&] { Renderer.Render(OtherChip, Samples); };
+    OtherEvents.RunUntil(cpu, mem, 20 * BATCH + 1);
+    Renderer.Render(OtherChip, Samples);
+    // Then:
+    EXPECT_EQ(chip.RendererWaits, 0u);
+    EXPECT_GT(OtherChip.RendererWaits, 2u);
+    EXPECT_EQ(Samples, Reference);
+}
+
+TEST_F(CPU6502SoundTests, WriteWavHeader)
+{
+    // Given:
+    const s16 Samples[] = {0, 1000, -1000, 32767};
+    FILE *File = tmpfile();
+    ASSERT_NE(File, nullptr);
+    // When:
+    bool Written = SoundRenderer::WriteWav(File, Samples, 4, 22050);
+    // Then:
+    ASSERT_TRUE(Written);
+    rewind(File);
+    Byte Header[52] = {};
+    ASSERT_EQ(fread(Header, 1, sizeof(Header), File), sizeof(Header));
+    EXPECT_EQ(fgetc(File), EOF);
+    EXPECT_EQ(memcmp(Header, "RIFF", 4), 0);
+    EXPECT_EQ(Header[4], 36 + 8);
+    EXPECT_EQ(memcmp(Header + 8, "WAVEfmt ", 8), 0);
+    EXPECT_EQ(Header[24] | Header[25] << 8, 22050);
+    EXPECT_EQ(memcmp(Header + 36, "data", 4), 0);
+    EXPECT_EQ(Header[46] | Header[47] << 8, 1000);
+    fclose(File);
+}
@@ -37,7 +37,7 @@ TEST_F(CPU6502StackOperationsTests, TransferStackPointerToX)
     s32 CyclesExpected = 2;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(CyclesUsed, CyclesExpected);
     EXPECT_EQ(cpu.X, 0xFA);
@@ -52,7 +52,7 @@ TEST_F(CPU6502StackOperationsTests, TransferXToStackPointer)
     s32 CyclesExpected = 2;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(CyclesUsed, CyclesExpected);
     EXPECT_EQ(cpu.SP, 0x50);
@@ -67,7 +67,7 @@ TEST_F(CPU6502StackOperationsTests, TransferAccumulatorIntoStack)
     s32 CyclesExpected = 3;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(CyclesUsed, CyclesExpected);
     // Accesing Stack location
@@ -84,7 +84,7 @@ TEST_F(CPU6502StackOperationsTests, TransferStatusFlagsIntoStack)
     s32 CyclesExpected = 3;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(CyclesUsed, CyclesExpected);
     // Accesing Stack location
@@ -101,7 +101,7 @@ TEST_F(CPU6502StackOperationsTests, PullAccumulatorFromStack)
     s32 CyclesExpected = 4;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(CyclesUsed, CyclesExpected);
     EXPECT_EQ(cpu.A, 0x50);
@@ -117,7 +117,7 @@ TEST_F(CPU6502StackOperationsTests, PullProcessorStatusFromStack)
     s32 CyclesExpected = 4;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(CyclesUsed, CyclesExpected);
     EXPECT_EQ(cpu.PS, 0x59);
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "main_6502.h"
+#include "statehash_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502StateHashTests : public testing::Test
+{
+public:
+    std::unique_ptr<cpu6502::Mem> mem = std::make_unique<cpu6502::Mem>();
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(*mem, 0x0200);
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Hash of the same state computed from scratch
+    u64 FullHash(const CPU &State) const
+    {
+        auto Copy = std::make_unique<Mem>(*mem);
+        StateHasher Fresh(*Copy);
+        return Fresh.Hash(State);
+    }
+};
+
+TEST_F(CPU6502StateHashTests, IncrementalMatchesFromScratch)
+{
+    // Given: a loop storing X through pages $10-$1F
+    const Byte Program[] = {
+        0xA0, 0x00,       //       LDY #0
+        0xE8,             // loop: INX
+        0x99, 0x00, 0x10, //       STA $1000,Y
+        0x8A,             //       TXA
+        0xC8,             //       INY
+        0xD0, 0xF8,       //       BNE loop
+        0xEE, 0x05, 0x02, //       INC loop+3 (next page)
+        0x4C, 0x02, 0x02, //       JMP loop
+    };
+    mem->WriteBlock(0x0200, Program, sizeof(Program));
+    StateHasher Hasher(*mem);
+    // When / Then:
+    for (u32 Slice = 0; Slice < 20; Slice++)
+    {
+        cpu.Execute(997, *mem);
+        ASSERT_EQ(Hasher.Hash(cpu), FullHash(cpu)) << Slice;
+    }
+}
+
+TEST_F(CPU6502StateHashTests, OnlyDirtyPagesAreRehashed)
+{
+    // Given:
+    StateHasher Hasher(*mem);
+    const u64 Before = Hasher.Hash(cpu);
+    const u64 Hashed = Hasher.PagesHashed;
+    // When:
+    mem->Fill(0x30F0, 0x55, 0x20);
+    const u64 After = Hasher.Hash(cpu);
+    // Then:
+    EXPECT_EQ(Hasher.PagesHashed - Hashed, 2u);
+    EXPECT_NE(After, Before);
+    // When: put back as it was
+    mem->Fill(0x30F0, 0x00, 0x20);
+    // Then:
+    EXPECT_EQ(Hasher.Hash(cpu), Before);
+    EXPECT_EQ(Hasher.Hash(cpu), Before);
+    EXPECT_EQ(Hasher.PagesHashed - Hashed, 4u);
+}
+
+TEST_F(CPU6502StateHashTests, RegistersButNotCyclesCount)
+{
+    // Given:
+    StateHasher Hasher(*mem);
+    const u64 Before = Hasher.Hash(cpu);
+    CPU Later = cpu;
+    Later.CycleCount += 1000;
+    CPU Changed = cpu;
+    Changed.Y = 1;
+    CPU Interrupted = cpu;
+    Interrupted.SetIRQ(2, true);
+    // Then:
+    EXPECT_EQ(Hasher.Hash(Later), Before);
+    EXPECT_NE(Hasher.Hash(Changed), Before);
+    EXPECT_NE(Hasher.Hash(Interrupted), Before);
+    // Moving a byte to another page is a different state
+    (*mem)[0x0400] = 1;
+    Hasher.Rebuild();
+    const u64 First = Hasher.Hash(cpu);
+    (*mem)[0x0400] = 0;
+    (*mem)[0x0500] = 1;
+    Hasher.Rebuild();
+    EXPECT_NE(Hasher.Hash(cpu), First);
+}
+
+TEST_F(CPU6502StateHashTests, StateSetAcrossThreads)
+{
+    // Given: four threads inserting overlapping ranges
+    StateSet Seen(1 << 16);
+    std::vector<u32> Added(4, 0);
+    // When:
+    std::vector<std::thread> Threads;
+    for (u32 t = 0; t < 4; t++)
+    {
+        Threads.emplace_back([&, t] {
+            for (u64 i = t * 5000; i < t * 5000 + 10000; i++)
+            {
+                if (Seen.Insert(i * 0x9E3779B97F4A7C15ull) == StateSet::Result::Added)
+                    Added[t]++;
+            }
+        });
+    }
+    for (std::thread &Thread : Threads)
+        Thread.join();
+    // Then: 0 .. 25000 exactly once each
+    EXPECT_EQ(Added[0] + Added[1] + Added[2] + Added[3], 25000u);
+    EXPECT_EQ(Seen.Size(), 25000u);
+    EXPECT_TRUE(Seen.Contains(0));
+    EXPECT_TRUE(Seen.Contains(24999 * 0x9E3779B97F4A7C15ull));
+    EXPECT_FALSE(Seen.Contains(25000 * 0x9E3779B97F4A7C15ull));
+}
+
+TEST_F(CPU6502StateHashTests, StateSetReportsFull)
+{
+    // Given:
+    StateSet Seen(16);
+    for (u64 i = 1; i <= 16; i++)
+        ASSERT_EQ(Seen.Insert(i), StateSet::Result::Added);
+    // Then:
+    EXPECT_EQ(Seen.Insert(5), StateSet::Result::Present);
+    EXPECT_EQ(Seen.Insert(17), StateSet::Result::Full);
+}
@@ -46,7 +46,7 @@ void CPU6502StoreRegisterTests::StoreRegisterZeroPage(Byte Instruction, Byte CPU
     CPU cpuCopy = cpu;
     s32 CyclesExpected = 3;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, mem[0x0079]);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -66,7 +66,7 @@ void CPU6502StoreRegisterTests::StoreRegisterZeroPageX(Byte Instruction, Byte CP
     CPU cpuCopy = cpu;
     s32 CyclesExpected = 4;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, mem[0x0072]);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -85,7 +85,7 @@ void CPU6502StoreRegisterTests::StoreRegisterAbsolute(Byte Instruction, Byte CPU
     s32 CyclesExpected = 4;
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem);
+    s32 CyclesUsed = cpu.Execute(CyclesExpected, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, mem[0x2044]);
     EXPECT_EQ(CyclesUsed, CyclesExpected);
@@ -106,10 +106,11 @@ void CPU6502StoreRegisterTests::StoreRegisterAbsoluteWithOffset(Byte Instruction
 
     CPU cpuCopy = cpu;
     // When:
-    s32 CyclesUsed = cpu.Execute(4, mem);
+    // Indexed stores always take 5 cycles
+    s32 CyclesUsed = cpu.Execute(5, mem).Cycles;
     // Then:
     EXPECT_EQ(cpu.*RegisterToCheck, mem[0x2092]);
-    EXPECT_EQ(CyclesUsed, 4);
+    EXPECT_EQ(CyclesUsed, 5);
     VerifyNotAffectedFlags(cpu, cpuCopy);
 }
 
@@ -180,7 +181,7 @@ TEST_F(CPU6502StoreRegisterTests, STAIndirectXLoadAValue)
     CPU CPUCopy = cpu;
 
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
 
     //then:
     EXPECT_EQ(cpu.A, mem[0x8000]);
@@ -204,7 +205,7 @@ TEST_F(CPU6502StoreRegisterTests, STAIndirectYLoadAValue)
     CPU CPUCopy = cpu;
 
     //when:
-    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem);
+    s32 CyclesUsed = cpu.Execute(EXPECTED_CYCLES, mem).Cycles;
 
     //then:
     EXPECT_EQ(cpu.A, mem[0x8004]);
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "main_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502SystemFunctionsTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0xFF00);
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502SystemFunctionsTests, FlagInstructionsSetAndClearTheirFlag)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_SEC;
+    mem[0xFF01] = CPU::INS_SED;
+    mem[0xFF02] = CPU::INS_SEI;
+    // When:
+    s32 CyclesUsed = cpu.Execute(6, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 6);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_TRUE(cpu.flags.D);
+    EXPECT_TRUE(cpu.flags.I);
+
+    // Given:
+    cpu.flags.V = 1;
+    mem[0xFF03] = CPU::INS_CLC;
+    mem[0xFF04] = CPU::INS_CLD;
+    mem[0xFF05] = CPU::INS_CLI;
+    mem[0xFF06] = CPU::INS_CLV;
+    // When:
+    CyclesUsed = cpu.Execute(8, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 8);
+    EXPECT_EQ(cpu.PS, 0x00);
+}
+
+TEST_F(CPU6502SystemFunctionsTests, NOPOnlyTakesTwoCycles)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_NOP;
+    CPU cpuCopy = cpu;
+    // When:
+    s32 CyclesUsed = cpu.Execute(2, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 2);
+    EXPECT_EQ(cpu.PC, 0xFF01);
+    EXPECT_EQ(cpu.PS, cpuCopy.PS);
+    EXPECT_EQ(cpu.SP, cpuCopy.SP);
+}
+
+TEST_F(CPU6502SystemFunctionsTests, BRKAndRTIRoundTrip)
+{
+    // Given:
+    cpu.flags.C = 1;
+    mem[0xFF00] = CPU::INS_BRK;
+    mem[0xFF01] = 0x00; // padding byte
+    mem[0xFFFE] = 0x00;
+    mem[0xFFFF] = 0x80;
+    mem[0x8000] = CPU::INS_RTI;
+    // When:
+    s32 CyclesUsed = cpu.Execute(7, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 7);
+    EXPECT_EQ(cpu.PC, 0x8000);
+    EXPECT_TRUE(cpu.flags.I);
+    EXPECT_EQ(cpu.SP, 0xFC);
+    EXPECT_EQ(mem[0x01FF], 0xFF);
+    EXPECT_EQ(mem[0x01FE], 0x02);
+    // status pushed with B and the unused bit set
+    EXPECT_EQ(mem[0x01FD], 0x31);
+
+    // When:
+    CyclesUsed = cpu.Execute(6, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 6);
+    EXPECT_EQ(cpu.PC, 0xFF02);
+    EXPECT_EQ(cpu.SP, 0xFF);
+    EXPECT_TRUE(cpu.flags.C);
+    EXPECT_FALSE(cpu.flags.I);
+}
+
+TEST_F(CPU6502SystemFunctionsTests, JMPIndirectWrapsWithinVectorPage)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_JMP_IND;
+    mem[0xFF01] = 0xFF;
+    mem[0xFF02] = 0x30;
+    mem[0x30FF] = 0x34;
+    mem[0x3000] = 0x12;
+    mem[0x3100] = 0x56;
+    // When:
+    s32 CyclesUsed = cpu.Execute(5, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 5);
+    EXPECT_EQ(cpu.PC, 0x1234);
+}
+
+TEST_F(CPU6502SystemFunctionsTests, ExecuteReportsBudgetExhausted)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_NOP;
+    mem[0xFF01] = CPU::INS_LDA_IM;
+    // When:
+    ExecuteResult Result = cpu.Execute(2, mem);
+    // Then:
+    EXPECT_EQ(Result.Cycles, 2);
+    EXPECT_EQ(Result.Reason, StopReason::BudgetExhausted);
+    EXPECT_EQ(Result.PC, 0xFF01);
+    EXPECT_EQ(Result.Opcode, CPU::INS_LDA_IM);
+}
+
+TEST_F(CPU6502SystemFunctionsTests, IllegalOpcodeStopsBeforeIt)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_NOP;
+    mem[0xFF01] = 0xFF; // undocumented
+    // When:
+    ExecuteResult Result = cpu.Execute(10, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::IllegalOpcode);
+    EXPECT_EQ(Result.Cycles, 2);
+    EXPECT_EQ(Result.PC, 0xFF01);
+    EXPECT_EQ(Result.Opcode, 0xFF);
+    EXPECT_EQ(cpu.PC, 0xFF01);
+    EXPECT_EQ(cpu.CycleCount, 2u);
+}
+
+TEST_F(CPU6502SystemFunctionsTests, JAMHaltsOnTheOpcode)
+{
+    // Given:
+    mem[0xFF00] = 0x02;
+    // When:
+    ExecuteResult Result = cpu.Execute(10, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::Halted);
+    EXPECT_EQ(Result.PC, 0xFF00);
+    EXPECT_EQ(cpu.PC, 0xFF00);
+}
+
+TEST_F(CPU6502SystemFunctionsTests, HostCallStopsAndResumesAfterCallNumber)
+{
+    // Given:
+    mem[0xFF00] = CPU::INS_HOST_CALL;
+    mem[0xFF01] = 0x07;
+    mem[0xFF02] = CPU::INS_LDA_IM;
+    mem[0xFF03] = 0x42;
+    // When:
+    ExecuteResult Result = cpu.Execute(10, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::HostCall);
+    EXPECT_EQ(Result.Cycles, 2);
+    EXPECT_EQ(Result.PC, 0xFF00);
+    EXPECT_EQ(mem[Result.PC + 1], 0x07);
+    EXPECT_EQ(cpu.PC, 0xFF02);
+    // When:
+    Result = cpu.Execute(2, mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::BudgetExhausted);
+    EXPECT_EQ(cpu.A, 0x42);
+}
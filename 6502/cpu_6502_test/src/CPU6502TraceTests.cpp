@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "main_6502.h"
+#include "trace_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502TraceTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::TraceRecorder trace;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0xFF00);
+        cpu.Hooks = &trace;
+    }
+
+    virtual void TearDown()
+    {
+        cpu.Hooks = nullptr;
+    }
+
+    void LoadProgram()
+    {
+        // 0xFF00: LDA #$11   (2 cycles)
+        // 0xFF02: STA $0200  (4 cycles, write at cycle 5)
+        // 0xFF05: LDX $0200  (4 cycles, read at cycle 9)
+        // 0xFF08: LDA #$22   (2 cycles)
+        // 0xFF0A: STA $0200  (4 cycles, write at cycle 15)
+        // 0xFF0D: LDY $0200  (4 cycles, read at cycle 19)
+        Byte Program[] = {CPU::INS_LDA_IM, 0x11, CPU::INS_STA_ABS, 0x00, 0x02,
+                          CPU::INS_LDX_ABS, 0x00, 0x02, CPU::INS_LDA_IM, 0x22,
+                          CPU::INS_STA_ABS, 0x00, 0x02, CPU::INS_LDY_ABS, 0x00, 0x02};
+        for (u32 i = 0; i < sizeof(Program); i++)
+        {
+            mem[0xFF00 + i] = Program[i];
+        }
+    }
+};
+
+TEST_F(CPU6502TraceTests, RecordsInstructionsWithCycleStamps)
+{
+    // Given:
+    LoadProgram();
+    // When:
+    s32 CyclesUsed = cpu.Execute(20, mem).Cycles;
+    // Then:
+    EXPECT_EQ(CyclesUsed, 20);
+    EXPECT_EQ(cpu.CycleCount, 20u);
+    ASSERT_EQ(trace.Instructions.size(), 6u);
+    EXPECT_EQ(trace.Instructions[0].Cycle, 0u);
+    EXPECT_EQ(trace.Instructions[1].Cycle, 2u);
+    EXPECT_EQ(trace.Instructions[1].PC, 0xFF02);
+    EXPECT_EQ(trace.Instructions[1].Opcode, CPU::INS_STA_ABS);
+    EXPECT_EQ(trace.Instructions[5].Cycle, 16u);
+}
+
+TEST_F(CPU6502TraceTests, LastWriteBeforeCycleFindsTheRightStore)
+{
+    // Given:
+    LoadProgram();
+    // When:
+    cpu.Execute(20, mem);
+    // Then:
+    EXPECT_EQ(trace.LastWriteBefore(0x0200, 5), nullptr);
+    const TraceAccess *First = trace.LastWriteBefore(0x0200, 10);
+    ASSERT_NE(First, nullptr);
+    EXPECT_EQ(First->PC, 0xFF02);
+    EXPECT_EQ(First->Value, 0x11);
+    EXPECT_EQ(First->Cycle, 5u);
+    const TraceAccess *Second = trace.LastWriteBefore(0x0200, 1000);
+    ASSERT_NE(Second, nullptr);
+    EXPECT_EQ(Second->PC, 0xFF0A);
+    EXPECT_EQ(Second->Value, 0x22);
+}
+
+TEST_F(CPU6502TraceTests, ReadersAndWritersOfAnAddress)
+{
+    // Given:
+    LoadProgram();
+    // When:
+    cpu.Execute(20, mem);
+    // Then:
+    EXPECT_EQ(trace.ReadersOf(0x0200), (std::vector<Word>{0xFF05, 0xFF0D}));
+    EXPECT_EQ(trace.WritersOf(0x0200), (std::vector<Word>{0xFF02, 0xFF0A}));
+    EXPECT_TRUE(trace.ReadersOf(0x0300).empty());
+    const TraceAccess *Read = trace.NextReadAfter(0x0200, 10);
+    ASSERT_NE(Read, nullptr);
+    EXPECT_EQ(Read->PC, 0xFF0D);
+    EXPECT_EQ(Read->Value, 0x22);
+}
+
+TEST_F(CPU6502TraceTests, AccessesInCycleWindow)
+{
+    // Given:
+    LoadProgram();
+    // When:
+    cpu.Execute(20, mem);
+    // Then:
+    auto Reads = trace.AccessesTo(0x0200, AccessKind::Read, 0, 15);
+    ASSERT_EQ(Reads.size(), 1u);
+    EXPECT_EQ(Reads[0]->Value, 0x11);
+    EXPECT_EQ(trace.AccessesTo(0x0200, AccessKind::Write).size(), 2u);
+}
+
+TEST_F(CPU6502TraceTests, OfflineIndexMatchesIndexBuiltWhileRecording)
+{
+    // Given:
+    LoadProgram();
+    trace.IndexWhileRecording = false;
+    // When:
+    cpu.Execute(20, mem);
+    // Then:
+    EXPECT_EQ(trace.LastWriteBefore(0x0200, 1000), nullptr);
+    trace.BuildIndex();
+    const TraceAccess *Write = trace.LastWriteBefore(0x0200, 1000);
+    ASSERT_NE(Write, nullptr);
+    EXPECT_EQ(Write->PC, 0xFF0A);
+}
+
+TEST_F(CPU6502TraceTests, SaveAndLoadRoundTrip)
+{
+    // Given:
+    LoadProgram();
+    cpu.Execute(20, mem);
+    const char *Path = "CPU6502TraceTests.trace";
+    // When:
+    ASSERT_TRUE(trace.Save(Path));
+    TraceRecorder Loaded;
+    ASSERT_TRUE(Loaded.Load(Path));
+    std::remove(Path);
+    // Then:
+    EXPECT_EQ(Loaded.Instructions.size(), trace.Instructions.size());
+    EXPECT_EQ(Loaded.Accesses.size(), trace.Accesses.size());
+    EXPECT_EQ(Loaded.ReadersOf(0x0200), trace.ReadersOf(0x0200));
+    const TraceAccess *Write = Loaded.LastWriteBefore(0x0200, 10);
+    ASSERT_NE(Write, nullptr);
+    EXPECT_EQ(Write->Value, 0x11);
+}
+
+TEST_F(CPU6502TraceTests, LoadRejectsCountsTheFileCannotHold)
+{
+    // Given: a saved trace, cut short and with a huge record count
+    LoadProgram();
+    cpu.Execute(20, mem);
+    const char *Path = "CPU6502TraceTests.trace";
+    ASSERT_TRUE(trace.Save(Path));
+    FILE *File = fopen(Path, "r+b");
+    ASSERT_NE(File, nullptr);
+    const u64 Huge = 1ull << 40;
+    fseek(File, 8, SEEK_SET);
+    fwrite(&Huge, sizeof(Huge), 1, File);
+    fclose(File);
+    // When:
+    TraceRecorder Loaded;
+    bool Ok = Loaded.Load(Path);
+    std::remove(Path);
+    // Then:
+    EXPECT_FALSE(Ok);
+    EXPECT_TRUE(Loaded.Instructions.empty());
+    EXPECT_TRUE(Loaded.Accesses.empty());
+}
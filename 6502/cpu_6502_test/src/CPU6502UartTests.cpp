@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "main_6502.h"
+#include "uart_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502UartTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::Uart uart{0xD000};
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        mem.Map(&uart, 0xD000, 0xD001);
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void LoadEcho()
+    {
+        static const Byte Echo[] = {
+            0xAD, 0x01, 0xD0, // loop: LDA $D001
+            0x29, 0x01,       //       AND #RX_READY
+            0xF0, 0xF9,       //       BEQ loop
+            0xAD, 0x00, 0xD0, //       LDA $D000
+            0xA8,             //       TAY
+            0xAD, 0x01, 0xD0, // tx:   LDA $D001
+            0x29, 0x02,       //       AND #TX_READY
+            0xF0, 0xF9,       //       BEQ tx
+            0x8C, 0x00, 0xD0, //       STY $D000
+            0x4C, 0x00, 0x02, //       JMP loop
+        };
+        for (u32 i = 0; i < sizeof(Echo); i++)
+        {
+            mem[0x0200 + i] = Echo[i];
+        }
+    }
+};
+
+TEST_F(CPU6502UartTests, GuestWritesReachTheHost)
+{
+    // Given:
+    mem[0x0200] = CPU::INS_LDA_IM;
+    mem[0x0201] = 'H';
+    mem[0x0202] = CPU::INS_STA_ABS;
+    mem[0x0203] = 0x00;
+    mem[0x0204] = 0xD0;
+    mem[0x0205] = CPU::INS_LDA_IM;
+    mem[0x0206] = 'i';
+    mem[0x0207] = CPU::INS_STA_ABS;
+    mem[0x0208] = 0x00;
+    mem[0x0209] = 0xD0;
+    // When:
+    cpu.Execute(12, mem);
+    Byte Buffer[16];
+    u32 Count = uart.Receive(Buffer, sizeof(Buffer));
+    // Then:
+    EXPECT_EQ(std::string(Buffer, Buffer + Count), "Hi");
+    // RAM under the device is untouched
+    EXPECT_EQ(mem[0xD000], 0);
+}
+
+TEST_F(CPU6502UartTests, StatusReflectsBothDirections)
+{
+    // Given:
+    mem[0x0200] = CPU::INS_LDA_ABS;
+    mem[0x0201] = 0x01;
+    mem[0x0202] = 0xD0;
+    mem[0x0203] = CPU::INS_LDX_ABS;
+    mem[0x0204] = 0x00;
+    mem[0x0205] = 0xD0;
+    mem[0x0206] = CPU::INS_LDY_ABS;
+    mem[0x0207] = 0x80;
+    mem[0x0208] = 0xD0;
+    const Byte Input = 0x5A;
+    uart.Send(&Input, 1);
+    // When:
+    cpu.Execute(12, mem);
+    // Then:
+    EXPECT_EQ(cpu.A, Uart::RX_READY | Uart::TX_READY);
+    EXPECT_EQ(cpu.X, 0x5A);
+    EXPECT_EQ(cpu.Y, 0xFF);
+}
+
+TEST_F(CPU6502UartTests, PollingLoopIsNotFastForwarded)
+{
+    // Given:
+    LoadEcho();
+    // When:
+    cpu.Execute(10000, mem);
+    const Byte Input = '!';
+    uart.Send(&Input, 1);
+    cpu.Execute(100, mem);
+    // Then:
+    Byte Output = 0;
+    EXPECT_EQ(uart.Receive(&Output, 1), 1u);
+    EXPECT_EQ(Output, '!');
+    EXPECT_EQ(cpu.IdleCyclesSkipped, 0u);
+}
+
+TEST_F(CPU6502UartTests, EchoesAgainstHostThreads)
+{
+    // Given:
+    LoadEcho();
+    constexpr u32 TOTAL = 100000;
+    std::atomic<bool> Done{false};
+    std::vector<Byte> Received;
+    std::thread Writer([&] {
+        Byte Chunk[512];
+        for (u32 Sent = 0; Sent < TOTAL;)
+        {
+            u32 Count = 0;
+            for (; Count < sizeof(Chunk) && Sent + Count < TOTAL; Count++)
+            {
+                Chunk[Count] = static_cast<Byte>((Sent + Count) * 7);
+            }
+            u32 Pushed = uart.Send(Chunk, Count);
+            Sent += Pushed;
+            if (Pushed < Count)
+                std::this_thread::yield();
+        }
+    });
+    std::thread Reader([&] {
+        Byte Chunk[512];
+        while (Received.size() < TOTAL)
+        {
+            u32 Count = uart.Receive(Chunk, sizeof(Chunk));
+            Received.insert(Received.end(), Chunk, Chunk + Count);
+            if (!Count)
+                std::this_thread::yield();
+        }
+        Done = true;
+    });
+    // When:
+    while (!Done)
+    {
+        cpu.Execute(10000, mem);
+    }
+    Writer.join();
+    Reader.join();
+    // Then:
+    ASSERT_EQ(Received.size(), TOTAL);
+    for (u32 i = 0; i < TOTAL; i++)
+    {
+        ASSERT_EQ(Received[i], static_cast<Byte>(i * 7)) << "at " << i;
+    }
+    EXPECT_EQ(uart.DroppedOutput, 0u);
+}
+
+TEST_F(CPU6502UartTests, FlushWritesPendingOutputAcrossTheWrap)
+{
+    // Given:
+    // fill and drain most of the ring so the next output wraps around
+    std::vector<Byte> Padding(Uart::BUFFER_SIZE - 3, 'x');
+    for (Byte Value : Padding)
+    {
+        uart.Write(0xD000, Value, 0);
+    }
+    std::vector<Byte> Sink(Padding.size());
+    ASSERT_EQ(uart.Receive(Sink.data(), u32(Sink.size())), Padding.size());
+    for (char Value : std::string("wrapped"))
+    {
+        uart.Write(0xD000, static_cast<Byte>(Value), 0);
+    }
+    FILE *File = tmpfile();
+    ASSERT_NE(File, nullptr);
+    // When:
+    u32 Flushed = uart.FlushTo(File);
+    // Then:
+    EXPECT_EQ(Flushed, 7u);
+    char Text[16] = {};
+    rewind(File);
+    EXPECT_EQ(fread(Text, 1, sizeof(Text), File), 7u);
+    EXPECT_STREQ(Text, "wrapped");
+    fclose(File);
+}
+
+TEST_F(CPU6502UartTests, ShortFlushKeepsTheRestQueued)
+{
+    // Given: a stream with room for 4 bytes
+    for (char Value : std::string("wrapped"))
+    {
+        uart.Write(0xD000, static_cast<Byte>(Value), 0);
+    }
+    char Small[5] = {};
+    FILE *File = fmemopen(Small, 4, "w");
+    ASSERT_NE(File, nullptr);
+    setvbuf(File, nullptr, _IONBF, 0);
+    // When:
+    u32 Flushed = uart.FlushTo(File);
+    // Then: what the stream did not take is still there
+    EXPECT_GT(Flushed, 0u);
+    EXPECT_LT(Flushed, 7u);
+    EXPECT_TRUE(ferror(File));
+    fclose(File);
+    Byte Rest[8] = {};
+    EXPECT_EQ(uart.Receive(Rest, sizeof(Rest)), 7u - Flushed);
+    EXPECT_EQ(std::string(reinterpret_cast<char *>(Rest)), std::string("wrapped").substr(Flushed));
+}
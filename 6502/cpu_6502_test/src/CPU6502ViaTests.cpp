@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include "main_6502.h"
+#include "scheduler_6502.h"
+#include "via_6502.h"
+
+using namespace cpu6502;
+
+namespace
+{
+    struct Machine
+    {
+        Mem mem;
+        CPU cpu;
+        Scheduler events;
+        VIA via{cpu, events};
+
+        explicit Machine(Byte ACR, bool SkipIdleLoops = true)
+        {
+            cpu.Reset(mem, 0x0200);
+            cpu.SkipIdleLoops = SkipIdleLoops;
+            mem.Map(&via, 0xD000, 0xD0FF);
+            const Byte Program[] = {
+                0xA9, 0xC0,       // LDA #$C0
+                0x8D, 0x0E, 0xD0, // STA IER - enable T1
+                0xA9, ACR,        // LDA #ACR
+                0x8D, 0x0B, 0xD0, // STA ACR
+                0xA9, 0xE8,       // LDA #<1000
+                0x8D, 0x04, 0xD0, // STA T1CL
+                0xA9, 0x03,       // LDA #>1000
+                0x8D, 0x05, 0xD0, // STA T1CH - start
+                0x58,             // CLI
+                0x4C, 0x15, 0x02, // JMP * - wait for interrupts
+            };
+            for (u32 i = 0; i < sizeof(Program); i++)
+            {
+                mem[0x0200 + i] = Program[i];
+            }
+            const Byte Handler[] = {
+                0xE6, 0x10,       // INC $10
+                0xAD, 0x04, 0xD0, // LDA T1CL - acknowledge
+                0x40,             // RTI
+            };
+            for (u32 i = 0; i < sizeof(Handler); i++)
+            {
+                mem[0x8000 + i] = Handler[i];
+            }
+            mem[0xFFFE] = 0x00;
+            mem[0xFFFF] = 0x80;
+        }
+    };
+}
+
+class CPU6502ViaTests : public testing::Test
+{
+public:
+    cpu6502::Mem mem;
+    cpu6502::CPU cpu;
+    cpu6502::Scheduler events;
+    std::unique_ptr<cpu6502::VIA> via;
+
+    virtual void SetUp()
+    {
+        cpu.Reset(mem, 0x0200);
+        via = std::make_unique<VIA>(cpu, events);
+        mem.Map(via.get(), 0xD000, 0xD0FF);
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(CPU6502ViaTests, CounterIsWorkedOutFromTheLoadCycle)
+{
+    // Given:
+    via->Write(0xD004, 0x00, 100);
+    // When:
+    via->Write(0xD005, 0x01, 100);
+    // Then:
+    EXPECT_EQ(via->Timer1(101), 0x0100);
+    EXPECT_EQ(via->Timer1(101 + 0x80), 0x0080);
+    EXPECT_EQ(via->Timer1(101 + 0x100), 0x0000);
+    EXPECT_EQ(via->Read(0xD00D, 101 + 0x100), 0x00);
+    // underflow
+    EXPECT_EQ(via->Timer1(101 + 0x101), 0xFFFF);
+    EXPECT_EQ(via->Read(0xD00D, 101 + 0x101), VIA::IRQ_T1);
+    // one-shot: keeps counting down, no second interrupt
+    EXPECT_EQ(via->Read(0xD004, 101 + 0x102), 0xFE);
+    EXPECT_EQ(via->Read(0xD00D, 101 + 0x400), 0x00);
+}
+
+TEST_F(CPU6502ViaTests, FreeRunningTimerReloadsFromTheLatch)
+{
+    // Given:
+    via->Write(0xD00B, VIA::ACR_T1_CONTINUOUS, 0);
+    via->Write(0xD004, 0x10, 0);
+    via->Write(0xD005, 0x00, 0);
+    // When:
+    // period is latch + 2
+    via->Write(0xD006, 0x20, 5);
+    // Then:
+    EXPECT_EQ(via->Timer1(1 + 0x11), 0xFFFF);
+    EXPECT_EQ(via->Timer1(1 + 0x12), 0x0020);
+    EXPECT_EQ(via->Timer1(1 + 0x12 + 0x22), 0x0020);
+    EXPECT_EQ(via->Read(0xD005, 1 + 0x12 + 0x22 + 0x10), 0x00);
+    EXPECT_EQ(via->Read(0xD004, 1 + 0x12 + 0x22 + 0x10), 0x10);
+}
+
+TEST_F(CPU6502ViaTests, InterruptRegistersAndPorts)
+{
+    // Given:
+    via->Write(0xD009, 0x00, 0); // T2 high with latch 0: underflows at once
+    via->Write(0xD00E, 0x80 | VIA::IRQ_T2, 0);
+    // Then:
+    EXPECT_EQ(via->Read(0xD00D, 2), VIA::IRQ_ANY | VIA::IRQ_T2);
+    EXPECT_EQ(cpu.IRQLines, 1u);
+    EXPECT_EQ(via->Read(0xD00E, 2), 0x80 | VIA::IRQ_T2);
+    // When:
+    via->Write(0xD00D, VIA::IRQ_T2, 3);
+    // Then:
+    EXPECT_EQ(via->Read(0xD00D, 3), 0x00);
+    EXPECT_EQ(cpu.IRQLines, 0u);
+
+    // Given:
+    via->InputA = 0b10100101;
+    // When:
+    via->Write(0xD003, 0x0F, 4); // DDRA: low nibble output
+    via->Write(0xD001, 0xFA, 4);
+    // Then:
+    EXPECT_EQ(via->Read(0xD001, 5), 0b10101010);
+    EXPECT_EQ(via->PortA(), 0b10101010);
+}
+
+TEST_F(CPU6502ViaTests, OneShotTimerInterruptsOnce)
+{
+    // Given:
+    auto machine = std::make_unique<Machine>(0x00);
+    // When:
+    machine->events.RunUntil(machine->cpu, machine->mem, 20000);
+    // Then:
+    EXPECT_EQ(machine->mem[0x10], 1);
+    EXPECT_EQ(machine->cpu.PC, 0x0215);
+    EXPECT_GT(machine->cpu.IdleCyclesSkipped, 15000u);
+}
+
+TEST_F(CPU6502ViaTests, FreeRunningTimerIsCycleExactWhileSkippingIdleLoops)
+{
+    // Given:
+    auto Fast = std::make_unique<Machine>(VIA::ACR_T1_CONTINUOUS, true);
+    auto Slow = std::make_unique<Machine>(VIA::ACR_T1_CONTINUOUS, false);
+    // When:
+    for (u64 Until : {12345, 50000, 100003})
+    {
+        Fast->events.RunUntil(Fast->cpu, Fast->mem, Until);
+        Slow->events.RunUntil(Slow->cpu, Slow->mem, Until);
+        // Then:
+        EXPECT_EQ(Fast->cpu.CycleCount, Slow->cpu.CycleCount);
+        EXPECT_EQ(Fast->cpu.PC, Slow->cpu.PC);
+        EXPECT_EQ(Fast->cpu.SP, Slow->cpu.SP);
+        EXPECT_EQ(Fast->mem[0x10], Slow->mem[0x10]);
+        EXPECT_EQ(Fast->via.Timer1(Until), Slow->via.Timer1(Until));
+    }
+    // one interrupt every 1002 cycles
+    EXPECT_EQ(Fast->mem[0x10], 99);
+    EXPECT_GT(Fast->cpu.IdleCyclesSkipped, 90000u);
+    EXPECT_EQ(Slow->cpu.IdleCyclesSkipped, 0u);
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include "main_6502.h"
+#include "workloads_6502.h"
+
+using namespace cpu6502;
+
+class CPU6502WorkloadTests : public testing::TestWithParam<Workload>
+{
+public:
+    std::unique_ptr<cpu6502::Mem> mem = std::make_unique<cpu6502::Mem>();
+    cpu6502::CPU cpu;
+};
+
+TEST_P(CPU6502WorkloadTests, RunsToCompletionInExpectedCycles)
+{
+    // Given:
+    const Workload &Program = GetParam();
+    Program.Load(cpu, *mem);
+    // When: with room to spare, the host call is what stops it
+    ExecuteResult Result = cpu.Execute(Program.ExpectedCycles + 100, *mem);
+    // Then:
+    EXPECT_EQ(Result.Reason, StopReason::HostCall);
+    EXPECT_EQ(Result.Cycles, Program.ExpectedCycles + Workload::HOST_CALL_CYCLES);
+    EXPECT_EQ(Result.PC, Program.DoneAddress);
+    EXPECT_TRUE(Program.Verify(*mem));
+}
+
+TEST_P(CPU6502WorkloadTests, ExpectedCyclesEndsOnTheHostCall)
+{
+    // Given:
+    const Workload &Program = GetParam();
+    Program.Load(cpu, *mem);
+    // When:
+    ExecuteResult Result = cpu.Execute(Program.ExpectedCycles, *mem);
+    // Then: the budget runs out exactly as the call comes up
+    EXPECT_EQ(Result.Reason, StopReason::BudgetExhausted);
+    EXPECT_EQ(Result.Cycles, Program.ExpectedCycles);
+    EXPECT_EQ(cpu.PC, Program.DoneAddress);
+}
+
+INSTANTIATE_TEST_SUITE_P(Workloads, CPU6502WorkloadTests, testing::ValuesIn(Workloads()),
+                         [](const testing::TestParamInfo<Workload> &Info) { return std::string(Info.param.Name); });
@@ -0,0 +1,219 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "main_6502.h"
+#include "fuzz_6502.h"
+#include "loader_6502.h"
+
+// M6502Fuzz - persistent mode fuzzing driver for a 6502 program
+//
+// Configured through the environment, as libFuzzer owns the command line:
+//   M6502_FUZZ_IMAGE   program image (raw, prg, Intel HEX or o65)
+//   M6502_FUZZ_LOAD    load address of a raw image                [$0200]
+//   M6502_FUZZ_INPUT   where each input is written                [$0400]
+//   M6502_FUZZ_MAX     longest input, longer ones are cut          [1024]
+//   M6502_FUZZ_LENGTH  where the input length goes as a word       [none]
+//   M6502_FUZZ_CYCLES  cycle limit of a run                        [1000000]
+//   M6502_FUZZ_BOOT    run the image up to its first host call in
+//                      at most this many cycles before the snapshot [0: no]
+// Numbers accept decimal, 0x or $ prefixed hex.
+//
+// The guest ends a run with INS_HOST_CALL, JAM and illegal opcodes abort()
+// so the fuzzer keeps the input. Three builds:
+//   plain      M6502Fuzz [input files...] replays files (or stdin) and
+//              prints how each run ended and the edges seen
+//   libFuzzer  -DM6502_LIBFUZZER=ON, guest edges go to extra counters
+//   AFL++      built with afl-clang-fast, shared memory persistent loop,
+//              guest edges go straight to the AFL map
+
+using namespace cpu6502;
+
+static bool ParseNumber(const char *Text, u64 &Value)
+{
+    int Base = 10;
+    if (Text[0] == '$')
+    {
+        Text++;
+        Base = 16;
+    }
+    else if (Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
+    {
+        Text += 2;
+        Base = 16;
+    }
+    char *End = nullptr;
+    Value = strtoull(Text, &End, Base);
+    return End != Text && *End == '\0';
+}
+
+static bool Setting(const char *Name, u64 &Value, u64 Limit)
+{
+    const char *Text = getenv(Name);
+    if (!Text)
+        return true;
+    if (!ParseNumber(Text, Value) || Value > Limit)
+    {
+        fprintf(stderr, "invalid %s '%s'\n", Name, Text);
+        return false;
+    }
+    return true;
+}
+
+// The image has to outlive the target: segments point into its mapping,
+// which a RomDevice would read
+static ProgramImage Image;
+
+static std::unique_ptr<FuzzTarget> Setup()
+{
+    const char *Path = getenv("M6502_FUZZ_IMAGE");
+    if (!Path)
+    {
+        fprintf(stderr, "M6502_FUZZ_IMAGE is not set\n");
+        return nullptr;
+    }
+    u64 Load = 0x0200, Input = 0x0400, Max = 1024, Length = FuzzTarget::NO_LENGTH, Cycles = 1000000, Boot = 0;
+    if (!Setting("M6502_FUZZ_LOAD", Load, 0xFFFF) || !Setting("M6502_FUZZ_INPUT", Input, 0xFFFF) ||
+        !Setting("M6502_FUZZ_MAX", Max, Mem::MAX_MEM) || !Setting("M6502_FUZZ_LENGTH", Length, 0xFFFF) ||
+        !Setting("M6502_FUZZ_CYCLES", Cycles, INT32_MAX) || !Setting("M6502_FUZZ_BOOT", Boot, INT32_MAX))
+        return nullptr;
+
+    std::string Error;
+    if (!Image.Open(Path, ImageFormat::Detect, static_cast<Word>(Load), &Error))
+    {
+        fprintf(stderr, "%s: %s\n", Path, Error.c_str());
+        return nullptr;
+    }
+
+    auto Target = std::make_unique<FuzzTarget>();
+    Image.Load(Target->cpu, Target->memory);
+    if (Boot)
+    {
+        ExecuteResult Result = Target->cpu.Execute(static_cast<s32>(Boot), Target->memory);
+        if (Result.Reason != StopReason::HostCall)
+        {
+            fprintf(stderr, "boot did not reach a host call, stopped at $%04X\n", Result.PC);
+            return nullptr;
+        }
+    }
+    Target->Config.InputAddress = static_cast<Word>(Input);
+    Target->Config.MaxInput = static_cast<u32>(Max);
+    Target->Config.LengthAddress = static_cast<u32>(Length);
+    Target->Config.CycleLimit = static_cast<s32>(Cycles);
+    Target->Snapshot();
+    return Target;
+}
+
+#if defined(M6502_LIBFUZZER)
+
+// libFuzzer treats every non-zero byte here as a feature, like its own
+// instrumentation counters
+__attribute__((used, section("__libfuzzer_extra_counters"))) static Byte GuestEdges[CPU::COVERAGE_SIZE];
+
+static std::unique_ptr<FuzzTarget> Target;
+
+extern "C" int LLVMFuzzerInitialize(int * /*argc*/, char *** /*argv*/)
+{
+    Target = Setup();
+    if (!Target)
+        exit(1);
+    Target->Map = GuestEdges;
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size)
+{
+    if (Target->Run(Data, Size) == FuzzTarget::Outcome::Crashed)
+    {
+        fprintf(stderr, "guest crashed at $%04X, opcode $%02X\n", Target->Last.PC, Target->Last.Opcode);
+        abort();
+    }
+    return 0;
+}
+
+#elif defined(__AFL_FUZZ_TESTCASE_LEN)
+
+extern "C" unsigned char *__afl_area_ptr;
+
+__AFL_FUZZ_INIT();
+
+int main()
+{
+    std::unique_ptr<FuzzTarget> Target = Setup();
+    if (!Target)
+        return 1;
+    __AFL_INIT();
+    // Only valid after __AFL_INIT, the map is AFL's shared memory
+    Target->Map = __afl_area_ptr;
+    const unsigned char *Data = __AFL_FUZZ_TESTCASE_BUF;
+    while (__AFL_LOOP(100000))
+    {
+        if (Target->Run(Data, __AFL_FUZZ_TESTCASE_LEN) == FuzzTarget::Outcome::Crashed)
+            abort();
+    }
+    return 0;
+}
+
+#else
+
+static const char *Describe(FuzzTarget::Outcome Result)
+{
+    switch (Result)
+    {
+    case FuzzTarget::Outcome::Finished:
+        return "finished";
+    case FuzzTarget::Outcome::Timeout:
+        return "timeout";
+    default:
+        return "crashed";
+    }
+}
+
+static bool ReadInput(FILE *File, std::vector<Byte> &Data)
+{
+    Data.clear();
+    Byte Buffer[4096];
+    size_t Count;
+    while ((Count = fread(Buffer, 1, sizeof(Buffer), File)) > 0)
+    {
+        Data.insert(Data.end(), Buffer, Buffer + Count);
+    }
+    return !ferror(File);
+}
+
+int main(int argc, char **argv)
+{
+    std::unique_ptr<FuzzTarget> Target = Setup();
+    if (!Target)
+        return 1;
+
+    std::vector<Byte> Data;
+    u32 Crashes = 0;
+    auto Begin = std::chrono::steady_clock::now();
+    for (int i = 1; i < argc || i == 1; i++)
+    {
+        const char *Name = i < argc ? argv[i] : "<stdin>";
+        FILE *File = i < argc ? fopen(Name, "rb") : stdin;
+        bool Ok = File && ReadInput(File, Data);
+        if (File && File != stdin)
+            fclose(File);
+        if (!Ok)
+        {
+            fprintf(stderr, "cannot read %s\n", Name);
+            return 1;
+        }
+        FuzzTarget::Outcome Result = Target->Run(Data.data(), Data.size());
+        Crashes += Result == FuzzTarget::Outcome::Crashed;
+        printf("%s: %s at $%04X after %d cycles, %u edges so far\n", Name, Describe(Result), Target->Last.PC,
+               Target->Last.Cycles, Target->EdgesHit());
+    }
+    double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+    printf("%llu runs, %u crashes, %.1f pages restored per run, %.0f runs/s\n", Target->Runs, Crashes,
+           double(Target->PagesRestored) / double(Target->Runs), double(Target->Runs) / Seconds);
+    return Crashes ? 2 : 0;
+}
+
+#endif
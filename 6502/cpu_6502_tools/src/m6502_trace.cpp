@@ -0,0 +1,173 @@
+#include <cstring>
+#include <memory>
+#include "main_6502.h"
+#include "trace_6502.h"
+
+// M6502Trace - record execution traces and run indexed queries over them
+//
+//   M6502Trace record <image.bin> <load-addr> <start-addr> <cycles> <out.trace>
+//   M6502Trace last-write <trace> <addr> <cycle>
+//   M6502Trace readers <trace> <addr>
+//   M6502Trace writers <trace> <addr>
+//   M6502Trace accesses <trace> <addr> [from-cycle] [to-cycle]
+//
+// Numbers accept decimal, 0x or $ prefixed hex.
+
+using namespace cpu6502;
+
+static bool ParseNumber(const char *Text, u64 &Value)
+{
+    int Base = 10;
+    if (Text[0] == '$')
+    {
+        Text++;
+        Base = 16;
+    }
+    else if (Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
+    {
+        Text += 2;
+        Base = 16;
+    }
+    char *End = nullptr;
+    Value = strtoull(Text, &End, Base);
+    return End != Text && *End == '\0';
+}
+
+static bool ParseAddress(const char *Text, Word &Address)
+{
+    u64 Value = 0;
+    if (!ParseNumber(Text, Value) || Value >= Mem::MAX_MEM)
+    {
+        fprintf(stderr, "invalid address '%s'\n", Text);
+        return false;
+    }
+    Address = static_cast<Word>(Value);
+    return true;
+}
+
+static void PrintAccess(const TraceAccess &Access)
+{
+    printf("cycle %llu pc $%04X %s $%04X = $%02X\n", Access.Cycle, Access.PC,
+           Access.Kind == AccessKind::Read ? "read " : "write", Access.Address, Access.Value);
+}
+
+static int Record(int argc, char **argv)
+{
+    u64 LoadAddress, StartAddress, Cycles;
+    if (argc != 7 || !ParseNumber(argv[3], LoadAddress) || !ParseNumber(argv[4], StartAddress) ||
+        !ParseNumber(argv[5], Cycles) || LoadAddress >= Mem::MAX_MEM || StartAddress >= Mem::MAX_MEM)
+    {
+        fprintf(stderr, "usage: record <image.bin> <load-addr> <start-addr> <cycles> <out.trace>\n");
+        return 2;
+    }
+
+    FILE *Image = fopen(argv[2], "rb");
+    if (!Image)
+    {
+        fprintf(stderr, "cannot open %s\n", argv[2]);
+        return 1;
+    }
+    auto memory = std::make_unique<Mem>();
+    CPU cpu;
+    cpu.Reset(*memory, static_cast<Word>(StartAddress));
+    size_t Loaded = fread(&memory->Data[LoadAddress], 1, Mem::MAX_MEM - LoadAddress, Image);
+    fclose(Image);
+    if (Loaded == 0)
+    {
+        fprintf(stderr, "%s is empty\n", argv[2]);
+        return 1;
+    }
+
+    TraceRecorder Trace;
+    cpu.Hooks = &Trace;
+    // Cycle counts past an s32 Execute budget run in slices
+    ExecuteResult Result = cpu.RunUntil(Cycles, *memory);
+    if (Result.Reason != StopReason::BudgetExhausted)
+    {
+        fprintf(stderr, "execution stopped at $%04X on opcode $%02X\n", Result.PC, Result.Opcode);
+    }
+    cpu.Hooks = nullptr;
+
+    if (!Trace.Save(argv[6]))
+    {
+        fprintf(stderr, "cannot write %s\n", argv[6]);
+        return 1;
+    }
+    printf("%zu instructions, %zu accesses\n", Trace.Instructions.size(), Trace.Accesses.size());
+    return 0;
+}
+
+static int Query(int argc, char **argv)
+{
+    const char *Command = argv[1];
+    Word Address = 0;
+    if (argc < 4 || !ParseAddress(argv[3], Address))
+        return 2;
+
+    TraceRecorder Trace;
+    if (!Trace.Load(argv[2]))
+    {
+        fprintf(stderr, "cannot read trace %s\n", argv[2]);
+        return 1;
+    }
+
+    if (strcmp(Command, "last-write") == 0)
+    {
+        u64 Cycle = 0;
+        if (argc != 5 || !ParseNumber(argv[4], Cycle))
+            return 2;
+        const TraceAccess *Access = Trace.LastWriteBefore(Address, Cycle);
+        if (!Access)
+        {
+            printf("no write to $%04X before cycle %llu\n", Address, Cycle);
+            return 1;
+        }
+        PrintAccess(*Access);
+    }
+    else if (strcmp(Command, "readers") == 0 || strcmp(Command, "writers") == 0)
+    {
+        bool Readers = Command[0] == 'r';
+        for (Word PC : Readers ? Trace.ReadersOf(Address) : Trace.WritersOf(Address))
+        {
+            printf("$%04X\n", PC);
+        }
+    }
+    else if (strcmp(Command, "accesses") == 0)
+    {
+        u64 From = 0, To = ~0ull;
+        if ((argc > 4 && !ParseNumber(argv[4], From)) || (argc > 5 && !ParseNumber(argv[5], To)))
+            return 2;
+        auto Reads = Trace.AccessesTo(Address, AccessKind::Read, From, To);
+        auto Writes = Trace.AccessesTo(Address, AccessKind::Write, From, To);
+        // merge both lists back into cycle order
+        size_t r = 0, w = 0;
+        while (r < Reads.size() || w < Writes.size())
+        {
+            bool TakeRead = w == Writes.size() || (r < Reads.size() && Reads[r]->Cycle <= Writes[w]->Cycle);
+            PrintAccess(TakeRead ? *Reads[r++] : *Writes[w++]);
+        }
+    }
+    else
+    {
+        fprintf(stderr, "unknown command '%s'\n", Command);
+        return 2;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr,
+                "usage: %s record <image.bin> <load-addr> <start-addr> <cycles> <out.trace>\n"
+                "       %s last-write <trace> <addr> <cycle>\n"
+                "       %s readers|writers <trace> <addr>\n"
+                "       %s accesses <trace> <addr> [from-cycle] [to-cycle]\n",
+                argv[0], argv[0], argv[0], argv[0]);
+        return 2;
+    }
+    if (strcmp(argv[1], "record") == 0)
+        return Record(argc, argv);
+    return Query(argc, argv);
+}